@@ -0,0 +1,328 @@
+#pragma once
+
+// Tiny dependency-free micro-benchmark harness used by physi_bench.
+//
+// Every benchmark is a callable taking an iteration count and returning the
+// number of "operations" it performed. The harness grows the iteration count
+// until one batch runs for at least min_time, repeats the batch and keeps the
+// fastest one. On Linux it can additionally read hardware cycle and
+// instruction counters through perf_event_open.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace physi::bench {
+
+// Keep `value` (and everything it depends on) alive without the compiler
+// being able to see how it is used.
+template <typename T> inline void do_not_optimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<char const volatile *>(&value);
+#endif
+}
+
+// Force pending stores to be considered observable.
+inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+// Hardware counters for the calling thread (cycles + retired instructions).
+class perf_counters {
+  public:
+    perf_counters() {
+#if defined(__linux__)
+        cycles_fd_ = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (cycles_fd_ >= 0) {
+            instr_fd_ = open_counter(PERF_COUNT_HW_INSTRUCTIONS, cycles_fd_);
+        }
+        if (instr_fd_ < 0) {
+            close_all();
+        }
+#endif
+    }
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    ~perf_counters() { close_all(); }
+
+    [[nodiscard]] bool available() const noexcept { return cycles_fd_ >= 0; }
+
+    void start() noexcept {
+#if defined(__linux__)
+        if (available()) {
+            ioctl(cycles_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(cycles_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    // Returns {cycles, instructions} since start().
+    std::pair<std::uint64_t, std::uint64_t> stop() noexcept {
+        std::uint64_t cycles = 0;
+        std::uint64_t instructions = 0;
+#if defined(__linux__)
+        if (available()) {
+            ioctl(cycles_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            if (read(cycles_fd_, &cycles, sizeof(cycles)) != sizeof(cycles) ||
+                read(instr_fd_, &instructions, sizeof(instructions)) !=
+                    sizeof(instructions)) {
+                cycles = instructions = 0;
+            }
+        }
+#endif
+        return {cycles, instructions};
+    }
+
+  private:
+    int cycles_fd_ = -1;
+    int instr_fd_ = -1;
+
+#if defined(__linux__)
+    static int open_counter(std::uint64_t config, int group_fd) {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = group_fd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(
+            syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+#endif
+
+    void close_all() noexcept {
+#if defined(__linux__)
+        if (instr_fd_ >= 0) {
+            close(instr_fd_);
+        }
+        if (cycles_fd_ >= 0) {
+            close(cycles_fd_);
+        }
+#endif
+        cycles_fd_ = instr_fd_ = -1;
+    }
+};
+
+struct options {
+    std::string filter;
+    std::string json_path;
+    double min_time_ms = 50.0;
+    int repetitions = 5;
+    bool perf = false;
+};
+
+struct result {
+    std::string group;
+    std::string name;
+    std::string variant; // "physi" or "raw"
+    std::uint64_t operations = 0;
+    double ns_per_op = 0.0;
+    double ops_per_second = 0.0;
+    std::optional<double> cycles_per_op;
+    std::optional<double> instructions_per_op;
+};
+
+// Runs `iterations` rounds and returns the number of operations performed.
+using body = std::function<std::uint64_t(std::uint64_t iterations)>;
+
+struct benchmark {
+    std::string group;
+    std::string name;
+    std::string variant;
+    body run;
+};
+
+class runner {
+  public:
+    explicit runner(options opts) : opts_(std::move(opts)) {}
+
+    void add(std::string group, std::string name, std::string variant,
+             body fn) {
+        benchmarks_.push_back({std::move(group), std::move(name),
+                               std::move(variant), std::move(fn)});
+    }
+
+    [[nodiscard]] const std::vector<result> &results() const noexcept {
+        return results_;
+    }
+
+    void run_all() {
+        std::optional<perf_counters> counters;
+        if (opts_.perf) {
+            counters.emplace();
+            if (!counters->available()) {
+                std::fprintf(stderr, "perf_event_open unavailable; hardware "
+                                     "counters disabled\n");
+                counters.reset();
+            }
+        }
+
+        std::fprintf(table(), "%-14s %-28s %-10s %12s %14s %10s %10s\n",
+                     "group", "name", "impl", "ns/op", "ops/s", "cyc/op",
+                     "ins/op");
+        for (auto &b : benchmarks_) {
+            const std::string id = b.group + "/" + b.name + "/" + b.variant;
+            if (!opts_.filter.empty() &&
+                id.find(opts_.filter) == std::string::npos) {
+                continue;
+            }
+            results_.push_back(measure(b, counters ? &*counters : nullptr));
+            print(results_.back());
+        }
+    }
+
+    bool write_json() const {
+        if (opts_.json_path.empty()) {
+            return true;
+        }
+        std::FILE *out = opts_.json_path == "-"
+                             ? stdout
+                             : std::fopen(opts_.json_path.c_str(), "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", opts_.json_path.c_str());
+            return false;
+        }
+        std::fprintf(out, "{\n  \"library\": \"physi\",\n");
+        std::fprintf(out, "  \"version\": \"%s\",\n", PHYSI_BENCH_VERSION);
+        std::fprintf(out, "  \"compiler\": \"%s\",\n", compiler());
+        std::fprintf(out, "  \"benchmarks\": [");
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const auto &r = results_[i];
+            std::fprintf(out,
+                         "%s\n    {\"group\": \"%s\", \"name\": \"%s\", "
+                         "\"variant\": \"%s\", \"operations\": %llu, "
+                         "\"ns_per_op\": %.6g, \"ops_per_second\": %.6g",
+                         i == 0 ? "" : ",", r.group.c_str(), r.name.c_str(),
+                         r.variant.c_str(),
+                         static_cast<unsigned long long>(r.operations),
+                         r.ns_per_op, r.ops_per_second);
+            if (r.cycles_per_op) {
+                std::fprintf(out,
+                             ", \"cycles_per_op\": %.6g, "
+                             "\"instructions_per_op\": %.6g",
+                             *r.cycles_per_op, *r.instructions_per_op);
+            }
+            std::fprintf(out, "}");
+        }
+        std::fprintf(out, "\n  ]\n}\n");
+        if (out != stdout) {
+            std::fclose(out);
+        }
+        return true;
+    }
+
+  private:
+    options opts_;
+    std::vector<benchmark> benchmarks_;
+    std::vector<result> results_;
+
+    result measure(benchmark &b, perf_counters *counters) const {
+        using clock = std::chrono::steady_clock;
+        const auto min_time =
+            std::chrono::duration<double, std::milli>(opts_.min_time_ms);
+
+        // Grow the batch until it is long enough to time reliably.
+        std::uint64_t iterations = 1;
+        for (;;) {
+            const auto t0 = clock::now();
+            b.run(iterations);
+            const auto elapsed = clock::now() - t0;
+            if (elapsed >= min_time || iterations >= (1ull << 40)) {
+                break;
+            }
+            const double ratio =
+                min_time / std::max(std::chrono::duration<double, std::milli>(
+                                        elapsed),
+                                    std::chrono::duration<double, std::milli>(
+                                        1e-3));
+            iterations = static_cast<std::uint64_t>(
+                static_cast<double>(iterations) *
+                std::clamp(ratio * 1.2, 2.0, 100.0));
+        }
+
+        result r;
+        r.group = b.group;
+        r.name = b.name;
+        r.variant = b.variant;
+        double best_ns = 0.0;
+        for (int rep = 0; rep < opts_.repetitions; ++rep) {
+            if (counters) {
+                counters->start();
+            }
+            const auto t0 = clock::now();
+            const std::uint64_t ops = b.run(iterations);
+            const auto elapsed = clock::now() - t0;
+            const auto [cycles, instructions] =
+                counters ? counters->stop()
+                         : std::pair<std::uint64_t, std::uint64_t>{};
+
+            const double ns =
+                std::chrono::duration<double, std::nano>(elapsed).count() /
+                static_cast<double>(ops);
+            if (rep == 0 || ns < best_ns) {
+                best_ns = ns;
+                r.operations = ops;
+                if (counters) {
+                    r.cycles_per_op = static_cast<double>(cycles) /
+                                      static_cast<double>(ops);
+                    r.instructions_per_op = static_cast<double>(instructions) /
+                                            static_cast<double>(ops);
+                }
+            }
+        }
+        r.ns_per_op = best_ns;
+        r.ops_per_second = best_ns > 0.0 ? 1e9 / best_ns : 0.0;
+        return r;
+    }
+
+    // The human-readable table moves to stderr when JSON goes to stdout.
+    [[nodiscard]] std::FILE *table() const {
+        return opts_.json_path == "-" ? stderr : stdout;
+    }
+
+    void print(const result &r) const {
+        std::fprintf(table(), "%-14s %-28s %-10s %12.3f %14.4g",
+                     r.group.c_str(), r.name.c_str(), r.variant.c_str(),
+                     r.ns_per_op, r.ops_per_second);
+        if (r.cycles_per_op) {
+            std::fprintf(table(), " %10.3f %10.3f", *r.cycles_per_op,
+                         *r.instructions_per_op);
+        }
+        std::fprintf(table(), "\n");
+    }
+
+    static const char *compiler() {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc";
+#else
+        return "unknown";
+#endif
+    }
+};
+
+} // namespace physi::bench
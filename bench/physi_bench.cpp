@@ -0,0 +1,997 @@
+// physi_bench: side-by-side micro-benchmarks of physi types against the raw
+// float / glm code they are meant to compile down to.
+//
+//   physi_bench [--filter <substr>] [--min-time <ms>] [--repetitions <n>]
+//               [--perf] [--json <file>|-]
+//
+// Every benchmark processes a batch of `batch` elements per iteration, so the
+// reported ns/op is per element.
+
+#include "bench.hpp"
+#include "physi/physi.hpp"
+#include "physi/sim/nbody.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace physi;
+using namespace physi::literals;
+namespace pb = physi::bench;
+
+namespace {
+
+constexpr std::size_t batch = 1024;
+
+// Deterministic values in [lo, hi).
+std::vector<float> make_values(std::size_t n, float lo, float hi,
+                               unsigned seed) {
+    std::vector<float> out(n);
+    unsigned state = seed * 2654435761u + 1u;
+    for (auto &v : out) {
+        state = state * 1664525u + 1013904223u;
+        v = lo + (hi - lo) * static_cast<float>(state >> 8) /
+                     static_cast<float>(1u << 24);
+    }
+    return out;
+}
+
+// Wrap a batch kernel into a harness body counting `batch` ops per call.
+template <typename Kernel> pb::body per_batch(Kernel kernel) {
+    return [kernel](std::uint64_t iterations) mutable -> std::uint64_t {
+        for (std::uint64_t it = 0; it < iterations; ++it) {
+            kernel();
+            pb::clobber_memory();
+        }
+        return iterations * batch;
+    };
+}
+
+struct scalar_data {
+    std::vector<float> a = make_values(batch, 0.5f, 100.0f, 1);
+    std::vector<float> b = make_values(batch, 0.5f, 100.0f, 2);
+    std::vector<double> bd = std::vector<double>(b.begin(), b.end());
+
+    std::vector<length_f> la, lb;
+    std::vector<length_d> lbd;
+    std::vector<time_f> tb;
+
+    scalar_data() {
+        for (std::size_t i = 0; i < batch; ++i) {
+            la.emplace_back(a[i]);
+            lb.emplace_back(b[i]);
+            lbd.emplace_back(bd[i]);
+            tb.emplace_back(b[i]);
+        }
+    }
+};
+
+void register_scalar(pb::runner &r, scalar_data &d) {
+    static std::vector<float> out_f(batch);
+    static std::vector<double> out_d(batch);
+    static std::vector<length_f> out_l(batch);
+    static std::vector<length_d> out_ld(batch);
+    static std::vector<speed_f> out_s(batch);
+
+    r.add("scalar", "add", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_l[i] = d.la[i] + d.lb[i];
+              }
+              pb::do_not_optimize(out_l.data());
+          }));
+    r.add("scalar", "add", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = d.a[i] + d.b[i];
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    r.add("scalar", "div_dimensional", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_s[i] = d.la[i] / d.tb[i];
+              }
+              pb::do_not_optimize(out_s.data());
+          }));
+    r.add("scalar", "div_dimensional", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = d.a[i] / d.b[i];
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    r.add("scalar", "mixed_precision", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_ld[i] = d.la[i] + d.lbd[i];
+              }
+              pb::do_not_optimize(out_ld.data());
+          }));
+    r.add("scalar", "mixed_precision", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_d[i] = static_cast<double>(d.a[i]) + d.bd[i];
+              }
+              pb::do_not_optimize(out_d.data());
+          }));
+}
+
+void register_units(pb::runner &r, scalar_data &d) {
+    static std::vector<float> out_f(batch);
+    static std::vector<length_f> out_l(batch);
+
+    // default literals are long double, so `x + 0.1_m` widens the whole
+    // expression before narrowing back to float; the f32 family does not
+    r.add("literal", "add_literal", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_l[i] = d.la[i] + 0.1_m;
+              }
+              pb::do_not_optimize(out_l.data());
+          }));
+    r.add("literal", "add_literal", "physi_f32", per_batch([&] {
+              using physi::literals::f32::operator""_m;
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_l[i] = d.la[i] + 0.1_m;
+              }
+              pb::do_not_optimize(out_l.data());
+          }));
+    r.add("literal", "add_literal", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = d.a[i] + 0.1f;
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    r.add("units", "factory_ft", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_l[i] = length_f::ft(d.a[i]);
+              }
+              pb::do_not_optimize(out_l.data());
+          }));
+    r.add("units", "factory_ft", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = d.a[i] * 0.3048f;
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    r.add("units", "getter_ft", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = d.la[i].ft();
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+    r.add("units", "getter_ft", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = d.a[i] / 0.3048f;
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    // span kernels: one multiply by a precomputed reciprocal per element
+    r.add("units", "bulk_from_ft", "physi", per_batch([&] {
+              length_f::from_ft(d.a, out_l);
+              pb::do_not_optimize(out_l.data());
+          }));
+    r.add("units", "bulk_from_ft", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = d.a[i] * 0.3048f;
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    r.add("units", "bulk_to_ft", "physi", per_batch([&] {
+              length_f::to_ft(d.la, out_f);
+              pb::do_not_optimize(out_f.data());
+          }));
+    r.add("units", "bulk_to_ft", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = d.a[i] / 0.3048f;
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    // km/h in, km/h out: a stage that scales a reading. Through the base
+    // type every value is multiplied into m/s and divided back out.
+    using kmh_f = quantity_in<speed_f, speed_f::km_h_unit>;
+    static std::vector<kmh_f> in_kmh(batch), out_kmh(batch);
+    for (std::size_t i = 0; i < batch; ++i) {
+        in_kmh[i] = kmh_f(d.a[i]);
+    }
+    r.add("units", "passthrough_km_h", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_kmh[i] = in_kmh[i] * 1.1f;
+              }
+              pb::do_not_optimize(out_kmh.data());
+          }));
+    r.add("units", "passthrough_km_h", "base", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = (speed_f::km_h(d.a[i]) * 1.1f).km_h();
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+    r.add("units", "passthrough_km_h", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = d.a[i] * 1.1f;
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+}
+
+struct vec_data {
+    std::vector<vec3<length_f>> pa, pb;
+    std::vector<vec3<force_f>> fb;
+    std::vector<glm::vec3> ra, rb;
+
+    vec_data() {
+        const auto x = make_values(3 * batch, -10.0f, 10.0f, 3);
+        const auto y = make_values(3 * batch, -10.0f, 10.0f, 4);
+        for (std::size_t i = 0; i < batch; ++i) {
+            ra.emplace_back(x[3 * i], x[3 * i + 1], x[3 * i + 2]);
+            rb.emplace_back(y[3 * i], y[3 * i + 1], y[3 * i + 2]);
+            pa.push_back({length_f(ra[i].x), length_f(ra[i].y),
+                          length_f(ra[i].z)});
+            pb.push_back({length_f(rb[i].x), length_f(rb[i].y),
+                          length_f(rb[i].z)});
+            fb.push_back(
+                {force_f(rb[i].x), force_f(rb[i].y), force_f(rb[i].z)});
+        }
+    }
+};
+
+void register_vec(pb::runner &r, vec_data &d) {
+    static std::vector<float> out_f(batch);
+    static std::vector<glm::vec3> out_v(batch);
+    static std::vector<area_f> out_area(batch);
+    static std::vector<length_f> out_l(batch);
+    static std::vector<vec3<energy_f>> out_torque(batch);
+
+    r.add("vec", "dot", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_area[i] = d.pa[i].dot(d.pb[i]);
+              }
+              pb::do_not_optimize(out_area.data());
+          }));
+    r.add("vec", "dot", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = glm::dot(d.ra[i], d.rb[i]);
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    r.add("vec", "cross", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_torque[i] = d.pa[i].cross(d.fb[i]);
+              }
+              pb::do_not_optimize(out_torque.data());
+          }));
+    r.add("vec", "cross", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_v[i] = glm::cross(d.ra[i], d.rb[i]);
+              }
+              pb::do_not_optimize(out_v.data());
+          }));
+
+    r.add("vec", "length", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_l[i] = d.pa[i].length();
+              }
+              pb::do_not_optimize(out_l.data());
+          }));
+    r.add("vec", "length", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = glm::length(d.ra[i]);
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    r.add("vec", "normalized", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_v[i] = d.pa[i].normalized();
+              }
+              pb::do_not_optimize(out_v.data());
+          }));
+    r.add("vec", "normalized", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_v[i] = glm::normalize(d.ra[i]);
+              }
+              pb::do_not_optimize(out_v.data());
+          }));
+
+    r.add("vec", "distance", "physi", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_l[i] = d.pa[i].distance(d.pb[i]);
+              }
+              pb::do_not_optimize(out_l.data());
+          }));
+    r.add("vec", "distance", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = glm::length(d.ra[i] - d.rb[i]);
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+}
+
+void register_vec_batch(pb::runner &r, vec_data &d) {
+    static vec3_array<length_f> pa, pb;
+    static vec3_array<force_f> fb;
+    for (std::size_t i = 0; i < batch; ++i) {
+        pa.push_back(d.pa[i]);
+        pb.push_back(d.pb[i]);
+        fb.push_back(d.fb[i]);
+    }
+    static quantity_array<length_f> out_l;
+    static vec3_array<float> out_dir;
+    static vec3_array<energy_f> out_torque;
+    static std::vector<float> out_f(batch);
+    static std::vector<glm::vec3> out_v(batch);
+
+    // SoA batch kernels vs per-vec glm calls over an array of vec3
+    r.add("vec_batch", "length", "physi", per_batch([&] {
+              batch::length(pa, out_l);
+              pb::do_not_optimize(out_l.data());
+          }));
+    r.add("vec_batch", "length", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = glm::length(d.ra[i]);
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    r.add("vec_batch", "normalized", "physi", per_batch([&] {
+              batch::normalized(pa, out_dir);
+              pb::do_not_optimize(out_dir.x().data());
+          }));
+    r.add("vec_batch", "normalized", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_v[i] = glm::normalize(d.ra[i]);
+              }
+              pb::do_not_optimize(out_v.data());
+          }));
+
+    r.add("vec_batch", "distance", "physi", per_batch([&] {
+              batch::distance(pa, pb, out_l);
+              pb::do_not_optimize(out_l.data());
+          }));
+    r.add("vec_batch", "distance", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_f[i] = glm::length(d.ra[i] - d.rb[i]);
+              }
+              pb::do_not_optimize(out_f.data());
+          }));
+
+    r.add("vec_batch", "cross", "physi", per_batch([&] {
+              batch::cross(pa, fb, out_torque);
+              pb::do_not_optimize(out_torque.x().data());
+          }));
+    r.add("vec_batch", "cross", "raw", per_batch([&] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_v[i] = glm::cross(d.ra[i], d.rb[i]);
+              }
+              pb::do_not_optimize(out_v.data());
+          }));
+
+    // one rotation and translation applied to every point
+    static vec3_array<length_f> out_p;
+    const quat<float> q = quat<float>::angle_axis(0.3f, {1.0f, 2.0f, 3.0f});
+    const vec3<length_f> t = {1_m, 2_m, 3_m};
+    const glm::mat3 rm = q.to_matrix().base_value();
+    const glm::vec3 rt = t.base_value();
+    r.add("vec_batch", "transform", "physi", per_batch([&, q, t] {
+              batch::transform(q, t, pa, out_p);
+              pb::do_not_optimize(out_p.x().data());
+          }));
+    r.add("vec_batch", "transform", "raw", per_batch([&, rm, rt] {
+              for (std::size_t i = 0; i < batch; ++i) {
+                  out_v[i] = rm * d.ra[i] + rt;
+              }
+              pb::do_not_optimize(out_v.data());
+          }));
+}
+
+void register_array(pb::runner &r, scalar_data &d) {
+    static quantity_array<length_f> x(batch);
+    static quantity_array<speed_f> v(batch);
+    static quantity_array<acceleration_f> a(batch);
+    static std::vector<float> rx(batch), rv(batch), ra(batch);
+    for (std::size_t i = 0; i < batch; ++i) {
+        rx[i] = d.a[i];
+        rv[i] = d.b[i];
+        ra[i] = -d.a[i];
+        x[i] = length_f(rx[i]);
+        v[i] = speed_f(rv[i]);
+        a[i] = acceleration_f(ra[i]);
+    }
+    const time_f dt(0.016f);
+
+    r.add("array", "integrate", "physi", per_batch([&, dt] {
+              x = x + v * dt + 0.5f * a * dt * dt;
+              pb::do_not_optimize(x.data());
+          }));
+    r.add("array", "integrate", "raw", per_batch([&] {
+              const float h = 0.016f;
+              for (std::size_t i = 0; i < batch; ++i) {
+                  rx[i] = rx[i] + rv[i] * h + 0.5f * ra[i] * h * h;
+              }
+              pb::do_not_optimize(rx.data());
+          }));
+}
+
+void register_scaled(pb::runner &r, scalar_data &d) {
+    using length_mm = scaled_quantity<length, std::milli, std::int32_t>;
+    static std::vector<length_mm> packed(batch), sorted_packed(batch);
+    static std::vector<double> wide(batch), sorted_wide(batch);
+    for (std::size_t i = 0; i < batch; ++i) {
+        packed[i] = length_mm(d.lbd[i]);
+        wide[i] = d.bd[i];
+    }
+
+    // sorting archived positions: 4-byte integer keys vs length_d values
+    r.add("scaled", "sort", "physi", per_batch([&] {
+              sorted_packed = packed;
+              std::sort(sorted_packed.begin(), sorted_packed.end());
+              pb::do_not_optimize(sorted_packed.data());
+          }));
+    r.add("scaled", "sort", "raw", per_batch([&] {
+              sorted_wide = wide;
+              std::sort(sorted_wide.begin(), sorted_wide.end());
+              pb::do_not_optimize(sorted_wide.data());
+          }));
+}
+
+void register_half(pb::runner &r, scalar_data &d) {
+    static std::vector<half> packed(batch);
+    static std::vector<float> wide(batch);
+    from_float(d.a, packed);
+
+    // widening a half column for a float kernel vs copying a float column
+    r.add("half", "to_float", "physi", per_batch([&] {
+              to_float(packed, wide);
+              pb::do_not_optimize(wide.data());
+          }));
+    r.add("half", "to_float", "raw", per_batch([&] {
+              std::copy(d.b.begin(), d.b.end(), wide.begin());
+              pb::do_not_optimize(wide.data());
+          }));
+}
+
+void register_reduce(pb::runner &r, scalar_data &d) {
+    static quantity_array<force_f> f(batch);
+    static quantity_array<length_f> dx(batch);
+    for (std::size_t i = 0; i < batch; ++i) {
+        f[i] = force_f(d.a[i]);
+        dx[i] = length_f(d.b[i]);
+    }
+
+    r.add("reduce", "sum", "physi", per_batch([&] {
+              force_f total = sum(f, 1);
+              pb::do_not_optimize(total);
+          }));
+    r.add("reduce", "sum", "raw", per_batch([&] {
+              float total = 0.0f;
+              for (std::size_t i = 0; i < batch; ++i) {
+                  total += d.a[i];
+              }
+              pb::do_not_optimize(total);
+          }));
+    r.add("reduce", "sum_of_products", "physi", per_batch([&] {
+              energy_f work = sum_of_products(f, dx, 1);
+              pb::do_not_optimize(work);
+          }));
+    r.add("reduce", "sum_of_products", "raw", per_batch([&] {
+              float work = 0.0f;
+              for (std::size_t i = 0; i < batch; ++i) {
+                  work += d.a[i] * d.b[i];
+              }
+              pb::do_not_optimize(work);
+          }));
+
+    // Fast chunked sum vs the reproducible fixed-tree one (physi_tree), over
+    // 1M rows; ops/s is rows per second
+    constexpr std::size_t rows = std::size_t{1} << 20;
+    static quantity_array<energy_f> big(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        big[i] = energy_f(d.a[i % batch]);
+    }
+    const auto over_rows = [](auto kernel) -> pb::body {
+        return [kernel](std::uint64_t iterations) -> std::uint64_t {
+            for (std::uint64_t it = 0; it < iterations; ++it) {
+                kernel();
+                pb::clobber_memory();
+            }
+            return iterations * rows;
+        };
+    };
+    r.add("reduce", "sum/1M", "physi", over_rows([] {
+              pb::do_not_optimize(sum(big));
+          }));
+    r.add("reduce", "sum/1M", "physi_tree", over_rows([] {
+              pb::do_not_optimize(sum(big, reduction::reproducible));
+          }));
+    r.add("reduce", "sum/1M", "raw", over_rows([] {
+              const float *p = big.base_data();
+              float total = 0.0f;
+              for (std::size_t i = 0; i < rows; ++i) {
+                  total += p[i];
+              }
+              pb::do_not_optimize(total);
+          }));
+
+    // float storage + compensated total vs widening every element to double
+    r.add("reduce", "accurate_sum", "physi", per_batch([&] {
+              quantity_accumulator<force_f> total;
+              total.add(f);
+              pb::do_not_optimize(total.total());
+          }));
+    r.add("reduce", "accurate_sum", "raw", per_batch([&] {
+              double total = 0.0;
+              for (std::size_t i = 0; i < batch; ++i) {
+                  total += d.a[i];
+              }
+              pb::do_not_optimize(total);
+          }));
+}
+
+// Plummer-like cloud of n equal masses in a 1 m cube.
+nbody_system<double> make_cloud(std::size_t n) {
+    nbody_system<double> sys({.softening = length_d(0.01)});
+    sys.reserve(n);
+    const auto x = make_values(n, 0.0f, 1.0f, 7);
+    const auto y = make_values(n, 0.0f, 1.0f, 8);
+    const auto z = make_values(n, 0.0f, 1.0f, 9);
+    for (std::size_t i = 0; i < n; ++i) {
+        sys.add({length_d(x[i]), length_d(y[i]), length_d(z[i])}, {},
+                mass_d(1.0));
+    }
+    return sys;
+}
+
+void register_nbody(pb::runner &r) {
+    // ops/s is pair interactions per second (N^2 per force evaluation)
+    for (const std::size_t n : {1000, 10000, 100000}) {
+        const std::string name = "forces/" + std::to_string(n / 1000) + "k";
+        r.add("nbody", name, "physi",
+              [n, sys = std::optional<nbody_system<double>>()](
+                  std::uint64_t iterations) mutable -> std::uint64_t {
+                  if (!sys) {
+                      sys = make_cloud(n);
+                  }
+                  for (std::uint64_t it = 0; it < iterations; ++it) {
+                      sys->compute_accelerations();
+                      pb::clobber_memory();
+                  }
+                  return iterations * n * n;
+              });
+        if (n > 10000) {
+            continue;
+        }
+        // scalar array-of-structs reference
+        r.add("nbody", name, "raw",
+              [n, pos = std::vector<glm::dvec3>(), acc =
+                                                     std::vector<glm::dvec3>()](
+                  std::uint64_t iterations) mutable -> std::uint64_t {
+                  if (pos.empty()) {
+                      const auto sys = make_cloud(n);
+                      for (std::size_t i = 0; i < n; ++i) {
+                          pos.push_back(sys.positions()[i].base_value());
+                      }
+                      acc.resize(n);
+                  }
+                  for (std::uint64_t it = 0; it < iterations; ++it) {
+                      for (std::size_t i = 0; i < n; ++i) {
+                          glm::dvec3 a(0.0);
+                          for (std::size_t j = 0; j < n; ++j) {
+                              const glm::dvec3 d = pos[j] - pos[i];
+                              const double inv =
+                                  1.0 / std::sqrt(glm::dot(d, d) + 1e-4);
+                              a += d * (inv * inv * inv);
+                          }
+                          acc[i] = 6.67430e-11 * a;
+                      }
+                      pb::do_not_optimize(acc.data());
+                  }
+                  return iterations * n * n;
+              });
+    }
+
+    // Barnes-Hut phases, timed separately; ops/s is bodies per second
+    for (const std::size_t n : {100000, 1000000}) {
+        const std::string suffix = n == 1000000 ? "/1M" : "/100k";
+        auto state = std::make_shared<std::optional<nbody_system<double>>>();
+        auto tree = std::make_shared<barnes_hut<double>>(
+            barnes_hut_config<double>{.softening = length_d(0.01)});
+        const auto prepare = [n, state, tree] {
+            if (!*state) {
+                *state = make_cloud(n);
+                tree->build((*state)->positions(), (*state)->masses());
+            }
+        };
+        r.add("nbody", "tree-build" + suffix, "physi",
+              [n, state, tree, prepare](
+                  std::uint64_t iterations) -> std::uint64_t {
+                  prepare();
+                  for (std::uint64_t it = 0; it < iterations; ++it) {
+                      tree->build((*state)->positions(), (*state)->masses());
+                      pb::clobber_memory();
+                  }
+                  return iterations * n;
+              });
+        r.add("nbody", "tree-walk" + suffix, "physi",
+              [n, tree, prepare, a = vec3_array<acceleration_d>()](
+                  std::uint64_t iterations) mutable -> std::uint64_t {
+                  prepare();
+                  for (std::uint64_t it = 0; it < iterations; ++it) {
+                      tree->accelerations(a);
+                      pb::clobber_memory();
+                  }
+                  return iterations * n;
+              });
+    }
+}
+
+// n points at unit density: a cube of edge cbrt(n) metres. (Independent
+// streams: make_values sequences of different seeds are correlated.)
+vec3_array<length_d> make_points(std::size_t n) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> u(0.0, std::cbrt(double(n)));
+    vec3_array<length_d> p(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const length_d x(u(rng)), y(u(rng)), z(u(rng));
+        p.set(i, {x, y, z});
+    }
+    return p;
+}
+
+void register_spatial_hash(pb::runner &r) {
+    // ops/s is objects per second; 1 m cells, pairs closer than 1 m
+    for (const std::size_t n : {20000, 200000}) {
+        const std::string suffix = "/" + std::to_string(n / 1000) + "k";
+        auto points = std::make_shared<vec3_array<length_d>>();
+        auto grid = std::make_shared<spatial_hash<double>>(length_d(1.0));
+        const auto prepare = [n, points, grid] {
+            if (points->empty()) {
+                *points = make_points(n);
+                grid->assign(*points);
+            }
+        };
+        r.add("spatial_hash", "pairs" + suffix, "physi",
+              [n, grid, prepare](std::uint64_t iterations) -> std::uint64_t {
+                  prepare();
+                  for (std::uint64_t it = 0; it < iterations; ++it) {
+                      auto pairs = grid->pairs_within(length_d(1.0));
+                      pb::do_not_optimize(pairs.data());
+                  }
+                  return iterations * n;
+              });
+        if (n <= 20000) {
+            // all-pairs reference
+            r.add("spatial_hash", "pairs" + suffix, "raw",
+                  [n, points, prepare](
+                      std::uint64_t iterations) -> std::uint64_t {
+                      prepare();
+                      const double *x = points->x().base_data();
+                      const double *y = points->y().base_data();
+                      const double *z = points->z().base_data();
+                      std::vector<std::pair<std::uint32_t, std::uint32_t>>
+                          pairs;
+                      for (std::uint64_t it = 0; it < iterations; ++it) {
+                          pairs.clear();
+                          for (std::uint32_t i = 0; i < n; ++i) {
+                              for (std::uint32_t j = i + 1; j < n; ++j) {
+                                  const double dx = x[i] - x[j],
+                                               dy = y[i] - y[j],
+                                               dz = z[i] - z[j];
+                                  if (dx * dx + dy * dy + dz * dz <= 1.0) {
+                                      pairs.emplace_back(i, j);
+                                  }
+                              }
+                          }
+                          pb::do_not_optimize(pairs.data());
+                      }
+                      return iterations * n;
+                  });
+            continue;
+        }
+        r.add("spatial_hash", "assign" + suffix, "physi",
+              [n, points, grid, prepare](
+                  std::uint64_t iterations) -> std::uint64_t {
+                  prepare();
+                  for (std::uint64_t it = 0; it < iterations; ++it) {
+                      grid->assign(*points);
+                      pb::clobber_memory();
+                  }
+                  return iterations * n;
+              });
+        // alternates between two small shifts, so a few percent of the
+        // objects change cell each time
+        r.add("spatial_hash", "update" + suffix, "physi",
+              [n, points, grid, prepare, moved = vec3_array<length_d>()](
+                  std::uint64_t iterations) mutable -> std::uint64_t {
+                  prepare();
+                  if (moved.empty()) {
+                      moved = *points;
+                      moved.x() += quantity_array<length_d>(n, length_d(0.05));
+                  }
+                  for (std::uint64_t it = 0; it < iterations; ++it) {
+                      grid->update(it % 2 == 0 ? moved : *points);
+                      pb::clobber_memory();
+                  }
+                  grid->assign(*points);
+                  return iterations * n;
+              });
+    }
+}
+
+// 10k spheres in stacks of two on the floor, settled.
+rigid_body_system<double> make_resting_scene(bool allow_sleep) {
+    rigid_body_system<double> world(
+        {.floor = length_d(0), .allow_sleep = allow_sleep});
+    const mass_d m(1.0);
+    const length_d r(0.5);
+    for (int i = 0; i < 5000; ++i) {
+        for (int k = 0; k < 2; ++k) {
+            world.add({length_d(1.5 * (i % 100)), length_d(1.5 * (i / 100)),
+                       length_d(0.5 + 1.01 * k)},
+                      m, sphere_inertia(m, r), r);
+        }
+    }
+    for (int k = 0; k < 120; ++k) {
+        world.step(time_d(1.0 / 60));
+    }
+    return world;
+}
+
+void register_rigid_body(pb::runner &r) {
+    // ops/s is scene bodies per second; asleep, a step only pays for the
+    // awake bodies
+    for (const bool sleep : {true, false}) {
+        r.add("rigid_body", sleep ? "step/10k-asleep" : "step/10k-awake",
+              "physi",
+              [sleep, world = std::optional<rigid_body_system<double>>()](
+                  std::uint64_t iterations) mutable -> std::uint64_t {
+                  if (!world) {
+                      world = make_resting_scene(sleep);
+                  }
+                  for (std::uint64_t it = 0; it < iterations; ++it) {
+                      world->step(time_d(1.0 / 60));
+                      pb::clobber_memory();
+                  }
+                  return iterations * world->size();
+              });
+    }
+}
+
+void register_particles(pb::runner &r) {
+    // A fountain emitting 10k particles per frame with 0.1-0.5 s lifetimes
+    // (about 200k live), compacted every fourth frame; ops/s is live
+    // particles per second. The raw baseline keeps an array of structs
+    // without handles and erases the dead each frame.
+    constexpr std::size_t emitted = 10000;
+    static const std::vector<float> lifetimes = [] {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> life(0.1f, 0.5f);
+        std::vector<float> out(emitted);
+        for (auto &t : out) {
+            t = life(rng);
+        }
+        return out;
+    }();
+    const float dt = 1.0f / 60;
+
+    r.add("particles", "frame/200k", "physi",
+          [dt, pool = std::optional<particle_pool<float>>(),
+           frame = std::uint64_t{0}](
+              std::uint64_t iterations) mutable -> std::uint64_t {
+              if (!pool) {
+                  pool.emplace(262144);
+              }
+              std::uint64_t live = 0;
+              for (std::uint64_t it = 0; it < iterations; ++it, ++frame) {
+                  for (std::size_t k = 0; k < emitted; ++k) {
+                      pool->spawn({}, {0_m_s, 0_m_s, 10_m_s}, mass_f(1e-3f),
+                                  time_f(lifetimes[k]));
+                  }
+                  pool->advance(time_f(dt), {0_m_s2, 0_m_s2, -9.81_m_s2});
+                  if (frame % 4 == 3) {
+                      pool->compact();
+                  }
+                  live += pool->size();
+                  pb::clobber_memory();
+              }
+              return live;
+          });
+
+    struct particle {
+        glm::vec3 x, v;
+        float m, life;
+    };
+    r.add("particles", "frame/200k", "raw",
+          [dt, ps = std::vector<particle>()](
+              std::uint64_t iterations) mutable -> std::uint64_t {
+              std::uint64_t live = 0;
+              const glm::vec3 g(0.0f, 0.0f, -9.81f);
+              for (std::uint64_t it = 0; it < iterations; ++it) {
+                  for (std::size_t k = 0; k < emitted; ++k) {
+                      ps.push_back({glm::vec3(0.0f),
+                                    glm::vec3(0.0f, 0.0f, 10.0f), 1e-3f,
+                                    lifetimes[k]});
+                  }
+                  for (auto &p : ps) {
+                      p.v = p.v + g * dt;
+                      p.x = p.x + p.v * dt;
+                      p.life -= dt;
+                  }
+                  std::erase_if(ps,
+                                [](const particle &p) { return p.life <= 0; });
+                  live += ps.size();
+                  pb::clobber_memory();
+              }
+              return live;
+          });
+}
+
+void register_task_graph(pb::runner &r) {
+    // A three-stage frame over 64k rows: kick, then drift and kinetic energy
+    // side by side. ops/s is rows per second; the raw baseline runs the
+    // same loops serially, so the gap is the scheduling overhead.
+    constexpr std::size_t n = 65536;
+    struct frame_data {
+        quantity_array<length_f> x = quantity_array<length_f>(n);
+        quantity_array<speed_f> v = quantity_array<speed_f>(n);
+        quantity_array<acceleration_f> a =
+            quantity_array<acceleration_f>(n, acceleration_f(-9.81f));
+        quantity_array<energy_f> e = quantity_array<energy_f>(n);
+    };
+    static frame_data d;
+    static task_graph frame;
+    const time_f dt(1.0f / 60);
+    const mass_f m(2.0f);
+    (void)frame.stage("kick").reads(d.a).writes(d.v).parallel(
+        n, [dt](std::size_t begin, std::size_t end) {
+            const acceleration_f *a = d.a.data();
+            speed_f *v = d.v.data();
+            for (std::size_t i = begin; i < end; ++i) {
+                v[i] += a[i] * dt;
+            }
+        });
+    (void)frame.stage("drift").reads(d.v).writes(d.x).parallel(
+        n, [dt](std::size_t begin, std::size_t end) {
+            const speed_f *v = d.v.data();
+            length_f *x = d.x.data();
+            for (std::size_t i = begin; i < end; ++i) {
+                x[i] += v[i] * dt;
+            }
+        });
+    (void)frame.stage("kinetic").reads(d.v).writes(d.e).parallel(
+        n, [m](std::size_t begin, std::size_t end) {
+            const speed_f *v = d.v.data();
+            energy_f *e = d.e.data();
+            for (std::size_t i = begin; i < end; ++i) {
+                e[i] = 0.5f * m * v[i] * v[i];
+            }
+        });
+
+    r.add("task_graph", "frame/64k", "physi",
+          [](std::uint64_t iterations) -> std::uint64_t {
+              for (std::uint64_t it = 0; it < iterations; ++it) {
+                  frame.run();
+                  pb::clobber_memory();
+              }
+              return iterations * n;
+          });
+    r.add("task_graph", "frame/64k", "raw",
+          [x = std::vector<float>(n), v = std::vector<float>(n),
+           e = std::vector<float>(n)](
+              std::uint64_t iterations) mutable -> std::uint64_t {
+              const float h = 1.0f / 60;
+              for (std::uint64_t it = 0; it < iterations; ++it) {
+                  for (std::size_t i = 0; i < n; ++i) {
+                      v[i] += -9.81f * h;
+                  }
+                  for (std::size_t i = 0; i < n; ++i) {
+                      x[i] += v[i] * h;
+                  }
+                  for (std::size_t i = 0; i < n; ++i) {
+                      e[i] = 0.5f * 2.0f * v[i] * v[i];
+                  }
+                  pb::clobber_memory();
+              }
+              return iterations * n;
+          });
+}
+
+void register_fixed_step(pb::runner &r) {
+    // Interpolated output of 64k tracked positions between the last two
+    // steps, as a renderer would read them each frame; ops/s is rows per
+    // second.
+    constexpr std::size_t n = 65536;
+    static vec3_array<length_f> x(n);
+    static vec3_array<length_f> shown;
+    static fixed_step_driver<float> clock({.dt = time_f(1.0f / 120)});
+    clock.track(x);
+    (void)clock.advance(time_f(0.0125f), [](time_f h) {
+        for (std::size_t i = 0; i < n; ++i) {
+            x.set(i, x[i] + vec3<length_f>{length_f(h.s()), length_f(0.0f),
+                                           length_f(0.0f)});
+        }
+    });
+
+    r.add("fixed_step", "interpolate/64k", "physi",
+          [](std::uint64_t iterations) -> std::uint64_t {
+              for (std::uint64_t it = 0; it < iterations; ++it) {
+                  clock.interpolate(shown);
+                  pb::clobber_memory();
+              }
+              return iterations * n;
+          });
+    r.add("fixed_step", "interpolate/64k", "raw",
+          [from = std::vector<glm::vec3>(n), to = std::vector<glm::vec3>(n),
+           out = std::vector<glm::vec3>(n)](
+              std::uint64_t iterations) mutable -> std::uint64_t {
+              const float a = 0.5f;
+              for (std::uint64_t it = 0; it < iterations; ++it) {
+                  for (std::size_t i = 0; i < n; ++i) {
+                      out[i] = from[i] + (to[i] - from[i]) * a;
+                  }
+                  pb::clobber_memory();
+              }
+              return iterations * n;
+          });
+}
+
+void usage(const char *argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--filter <substr>] [--min-time <ms>] "
+                 "[--repetitions <n>] [--perf] [--json <file>|-]\n",
+                 argv0);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    pb::options opts;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--filter") == 0 && has_value) {
+            opts.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && has_value) {
+            opts.min_time_ms = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--repetitions") == 0 && has_value) {
+            opts.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--json") == 0 && has_value) {
+            opts.json_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--perf") == 0) {
+            opts.perf = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    scalar_data scalars;
+    vec_data vecs;
+
+    pb::runner runner(opts);
+    register_scalar(runner, scalars);
+    register_units(runner, scalars);
+    register_vec(runner, vecs);
+    register_vec_batch(runner, vecs);
+    register_array(runner, scalars);
+    register_scaled(runner, scalars);
+    register_half(runner, scalars);
+    register_reduce(runner, scalars);
+    register_nbody(runner);
+    register_spatial_hash(runner);
+    register_rigid_body(runner);
+    register_particles(runner);
+    register_task_graph(runner);
+    register_fixed_step(runner);
+
+    runner.run_all();
+    return runner.write_json() ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "reduce.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+// Accurate running totals of quantities stored in low precision, so large
+// state columns can stay length_f / energy_f while their aggregates keep
+// (nearly) double accuracy:
+//
+//   quantity_accumulator<energy_f> total;
+//   total.add(kinetic);            // span / quantity_array, vectorized
+//   total += potential[i];         // single values
+//   energy_f e = total.total();
+//
+// All arithmetic stays in the quantity's scalar type; the error is carried
+// alongside the sum instead of widening every element.
+
+namespace physi {
+
+enum class summation {
+    // Kahan: one correction term; accurate unless the addends are much
+    // larger than the running sum.
+    kahan,
+    // Neumaier: Kahan with a magnitude test, also exact when large and
+    // small terms alternate. The default.
+    neumaier,
+    // Pairwise (cascade) summation over fixed blocks; error grows with
+    // log(n) and the inner loop is a plain vectorized sum.
+    pairwise,
+};
+
+namespace detail {
+
+// Running compensated sum: `comp` holds the rounding error lost from `sum`.
+template <typename T, summation Mode> struct compensated {
+    T sum = 0;
+    T comp = 0;
+
+    constexpr void add(T x) noexcept {
+        if constexpr (Mode == summation::kahan) {
+            const T y = x + comp;
+            const T t = sum + y;
+            comp = y - (t - sum);
+            sum = t;
+        } else {
+            const T t = sum + x;
+            comp += std::abs(sum) >= std::abs(x) ? (sum - t) + x
+                                                 : (x - t) + sum;
+            sum = t;
+        }
+    }
+
+    [[nodiscard]] constexpr T value() const noexcept { return sum + comp; }
+};
+
+// Elements per batch block: four per lane of lane_sum, so a block partial
+// carries only a few roundings before it enters the compensated total.
+template <typename T>
+inline constexpr std::size_t compensated_block = 4 * reduce_lanes<T>;
+
+// Batch add: each short block is summed by the vectorized lane kernel and
+// only the block partials go through the (serial) compensation step.
+template <typename T, summation Mode>
+void compensated_batch(compensated<T, Mode> &state, const T *p,
+                       std::size_t n) noexcept {
+    constexpr std::size_t B = compensated_block<T>;
+    const std::size_t body = n - n % B;
+    for (std::size_t i = 0; i < body; i += B) {
+        state.add(lane_sum(p + i, B));
+    }
+    for (std::size_t i = body; i < n; ++i) {
+        state.add(p[i]);
+    }
+}
+
+} // namespace detail
+
+template <typename Quantity, summation Mode = summation::neumaier>
+class quantity_accumulator {
+    static_assert(reducible<Quantity>,
+                  "quantity_accumulator sums quantities or arithmetic values");
+
+  public:
+    using quantity_type = Quantity;
+    using value_type = scalar_type_t<Quantity>;
+
+    static constexpr summation mode = Mode;
+
+    // Values per pairwise block; each full block enters the cascade as one
+    // partial sum.
+    static constexpr std::size_t block_size = 256;
+
+  private:
+    using T = value_type;
+
+    std::uint64_t count_ = 0;
+    // kahan / neumaier
+    detail::compensated<T, Mode> state_;
+    // pairwise: level k holds the sum of 2^k full blocks when occupied
+    std::array<T, 64> levels_{};
+    std::uint64_t occupied_ = 0;
+    std::array<T, block_size> pending_{};
+    std::size_t pending_size_ = 0;
+
+  public:
+    constexpr quantity_accumulator() noexcept = default;
+
+    // ========== Accumulation ==========
+    void add(const Quantity &q) noexcept {
+        ++count_;
+        if constexpr (Mode == summation::pairwise) {
+            pending_[pending_size_++] = detail::base_of(q);
+            if (pending_size_ == block_size) {
+                push(detail::lane_sum(pending_.data(), block_size), 0);
+                pending_size_ = 0;
+            }
+        } else {
+            state_.add(detail::base_of(q));
+        }
+    }
+
+    quantity_accumulator &operator+=(const Quantity &q) noexcept {
+        add(q);
+        return *this;
+    }
+
+    // Vectorized batch add over a contiguous range.
+    void add(std::span<const Quantity> values) noexcept {
+        add_base(reinterpret_cast<const T *>(values.data()), values.size());
+    }
+
+    template <reducible_range R>
+        requires std::is_same_v<std::ranges::range_value_t<R>, Quantity>
+    void add(const R &values) noexcept {
+        add_base(detail::base_pointer(values), std::ranges::size(values));
+    }
+
+    // Fold in another accumulator, e.g. one per worker thread.
+    void merge(const quantity_accumulator &other) noexcept {
+        if constexpr (Mode == summation::pairwise) {
+            for (std::size_t level = 0; level < other.levels_.size();
+                 ++level) {
+                if (other.occupied_ >> level & 1u) {
+                    push(other.levels_[level], level);
+                }
+            }
+            const auto pending = other.pending_size_;
+            add_base(other.pending_.data(), pending);
+            count_ -= pending;
+        } else {
+            state_.add(other.state_.sum);
+            state_.add(other.state_.comp);
+        }
+        count_ += other.count_;
+    }
+
+    void reset() noexcept { *this = quantity_accumulator{}; }
+
+    // ========== Results ==========
+    [[nodiscard]] Quantity total() const noexcept {
+        if constexpr (Mode == summation::pairwise) {
+            // smallest partials first
+            T sum = detail::lane_sum(pending_.data(), pending_size_);
+            for (std::size_t level = 0; level < levels_.size(); ++level) {
+                if (occupied_ >> level & 1u) {
+                    sum += levels_[level];
+                }
+            }
+            return detail::from_base<Quantity>(sum);
+        } else {
+            return detail::from_base<Quantity>(state_.value());
+        }
+    }
+
+    // Mean of the added values. At least one value must have been added.
+    [[nodiscard]] Quantity mean() const noexcept {
+        assert(count_ > 0 && "mean of an empty accumulator");
+        return detail::from_base<Quantity>(detail::base_of(total()) /
+                                           static_cast<T>(count_));
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+
+  private:
+    void add_base(const T *p, std::size_t n) noexcept {
+        count_ += n;
+        if constexpr (Mode == summation::pairwise) {
+            std::size_t i = 0;
+            // top up the pending block first
+            if (pending_size_ > 0) {
+                const std::size_t take =
+                    std::min(n, block_size - pending_size_);
+                std::copy_n(p, take, pending_.data() + pending_size_);
+                pending_size_ += take;
+                i = take;
+                if (pending_size_ == block_size) {
+                    push(detail::lane_sum(pending_.data(), block_size), 0);
+                    pending_size_ = 0;
+                }
+            }
+            for (; i + block_size <= n; i += block_size) {
+                push(detail::lane_sum(p + i, block_size), 0);
+            }
+            std::copy(p + i, p + n, pending_.data() + pending_size_);
+            pending_size_ += n - i;
+        } else {
+            detail::compensated_batch(state_, p, n);
+        }
+    }
+
+    // Binary-counter carry: equal-sized partials are summed before they
+    // meet larger ones.
+    void push(T partial, std::size_t level) noexcept {
+        while (occupied_ >> level & 1u) {
+            partial += levels_[level];
+            occupied_ &= ~(std::uint64_t{1} << level);
+            ++level;
+        }
+        levels_[level] = partial;
+        occupied_ |= std::uint64_t{1} << level;
+    }
+};
+
+} // namespace physi
@@ -0,0 +1,435 @@
+#pragma once
+
+#include "../array/quantity_array.hpp"
+#include "../array/vec_array.hpp"
+#include "../core/parallel.hpp"
+#include "../core/simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+// Dimension-preserving reductions over contiguous quantity ranges
+// (quantity_array, std::vector, std::span) and vec_array columns:
+//
+//   energy_d e = sum(kinetic);                          // energy_d
+//   energy_d w = sum_of_products(forces, displacements); // force * length
+//   auto [lo, hi] = minmax(speeds);
+//   vec3<length_d> com = centroid(positions, masses);
+//
+// Inputs are split into contiguous chunks reduced on separate threads, each
+// with a vectorizable multi-lane kernel; the chunk results are combined in
+// order. The chunking depends on the thread count, so the last bits of a
+// floating-point sum may differ between thread counts. Pass
+// reduction::reproducible where totals must match bit for bit whatever the
+// thread count:
+//
+//   energy_d e = sum(kinetic, reduction::reproducible);        // any threads
+//   vec3<momentum_d> p = sum(momenta, reduction::reproducible, 4);
+
+namespace physi {
+
+// Element types the reductions accept: quantities and plain scalars stored
+// exactly like their scalar. 16-bit scalars are summed in float.
+template <typename T>
+concept reducible = (is_quantity_v<T> || is_quantity_scalar_v<T>) &&
+                    sizeof(T) == sizeof(scalar_type_t<T>);
+
+template <typename R>
+concept reducible_range = std::ranges::contiguous_range<R> &&
+                          std::ranges::sized_range<R> &&
+                          reducible<std::ranges::range_value_t<R>>;
+
+// How sums and dot products combine their partial results. minmax() is
+// exact either way.
+enum class reduction {
+    // One chunk per thread, folded left to right.
+    fast,
+    // Fixed blocks combined by a fixed pairwise tree, so the result does
+    // not depend on the thread count or the run. Threads only decide who
+    // reduces which block; the per-block kernel is the fast one, and the
+    // tree is also a little more accurate.
+    reproducible,
+};
+
+namespace detail {
+
+// Below this many elements per thread, spawning threads costs more than the
+// reduction itself.
+inline constexpr std::size_t reduce_grain = std::size_t{1} << 14;
+
+// Independent accumulators per kernel: one cache line of partial sums, which
+// lets the compiler keep them in vector registers without reassociating.
+template <typename T>
+inline constexpr std::size_t reduce_lanes =
+    std::max<std::size_t>(1, simd_alignment / sizeof(T));
+
+template <typename R>
+[[nodiscard]] const scalar_type_t<std::ranges::range_value_t<R>> *
+base_pointer(const R &r) noexcept {
+    return reinterpret_cast<
+        const scalar_type_t<std::ranges::range_value_t<R>> *>(
+        std::ranges::data(r));
+}
+
+template <typename Q>
+[[nodiscard]] constexpr Q from_base(scalar_type_t<Q> v) noexcept {
+    return Q(v);
+}
+
+// Accumulator scalar: T itself, float for the 16-bit storage types.
+template <typename T> using accumulate_t = std::common_type_t<T, T>;
+
+template <typename T>
+[[nodiscard]] accumulate_t<T> lane_sum(const T *p, std::size_t n) noexcept {
+    using A = accumulate_t<T>;
+    constexpr std::size_t L = reduce_lanes<T>;
+    const std::size_t body = n - n % L;
+    A acc[L] = {};
+    for (std::size_t i = 0; i < body; i += L) {
+        for (std::size_t j = 0; j < L; ++j) {
+            acc[j] += p[i + j];
+        }
+    }
+    A total = 0;
+    for (std::size_t j = 0; j < L; ++j) {
+        total += acc[j];
+    }
+    for (std::size_t j = 0; j < n % L; ++j) {
+        total += p[body + j];
+    }
+    return total;
+}
+
+template <typename T>
+[[nodiscard]] accumulate_t<T> lane_dot(const T *a, const T *b,
+                                       std::size_t n) noexcept {
+    using A = accumulate_t<T>;
+    constexpr std::size_t L = reduce_lanes<T>;
+    const std::size_t body = n - n % L;
+    A acc[L] = {};
+    for (std::size_t i = 0; i < body; i += L) {
+        for (std::size_t j = 0; j < L; ++j) {
+            acc[j] += a[i + j] * b[i + j];
+        }
+    }
+    A total = 0;
+    for (std::size_t j = 0; j < L; ++j) {
+        total += acc[j];
+    }
+    for (std::size_t j = 0; j < n % L; ++j) {
+        total += a[body + j] * b[body + j];
+    }
+    return total;
+}
+
+template <typename T> struct min_max {
+    T min;
+    T max;
+};
+
+// n must be at least 1.
+template <typename T>
+[[nodiscard]] min_max<T> lane_minmax(const T *p, std::size_t n) noexcept {
+    constexpr std::size_t L = reduce_lanes<T>;
+    T lo[L], hi[L];
+    for (std::size_t j = 0; j < L; ++j) {
+        lo[j] = p[0];
+        hi[j] = p[0];
+    }
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        for (std::size_t j = 0; j < L; ++j) {
+            lo[j] = p[i + j] < lo[j] ? p[i + j] : lo[j];
+            hi[j] = hi[j] < p[i + j] ? p[i + j] : hi[j];
+        }
+    }
+    for (; i < n; ++i) {
+        lo[0] = p[i] < lo[0] ? p[i] : lo[0];
+        hi[0] = hi[0] < p[i] ? p[i] : hi[0];
+    }
+    min_max<T> out{lo[0], hi[0]};
+    for (std::size_t j = 1; j < L; ++j) {
+        out.min = lo[j] < out.min ? lo[j] : out.min;
+        out.max = out.max < hi[j] ? hi[j] : out.max;
+    }
+    return out;
+}
+
+// Threads actually worth using for n elements (0 = hardware threads).
+[[nodiscard]] inline std::size_t reduce_threads(std::size_t n,
+                                                std::size_t threads) noexcept {
+    if (threads == 0) {
+        threads = default_thread_count();
+    }
+    return std::max<std::size_t>(1, std::min(threads, n / reduce_grain));
+}
+
+// Splits [0, n) into one chunk per thread, reduces each with
+// kernel(begin, end) and folds the partial results left to right.
+template <typename R, typename Kernel, typename Combine>
+[[nodiscard]] R parallel_reduce(std::size_t n, Kernel kernel, Combine combine,
+                                std::size_t threads) {
+    const std::size_t chunks = reduce_threads(n, threads);
+    if (chunks == 1) {
+        return kernel(std::size_t{0}, n);
+    }
+    std::vector<R> partial(chunks);
+    parallel_for(
+        chunks,
+        [&](std::size_t first, std::size_t last) {
+            for (std::size_t c = first; c < last; ++c) {
+                partial[c] = kernel(n * c / chunks, n * (c + 1) / chunks);
+            }
+        },
+        chunks);
+    R result = partial[0];
+    for (std::size_t c = 1; c < chunks; ++c) {
+        result = combine(result, partial[c]);
+    }
+    return result;
+}
+
+// Elements per block of a reproducible reduction. Part of the result's
+// definition: changing it changes the last bits of every reproducible sum.
+inline constexpr std::size_t reproducible_block = std::size_t{1} << 12;
+
+// Reduces the blocks [k * block, (k + 1) * block) of [0, n) with
+// kernel(begin, end) on up to `threads` threads, then sums the block results
+// pairwise in a tree whose shape depends only on the block count.
+template <typename R, typename Kernel>
+[[nodiscard]] R tree_reduce(std::size_t n, std::size_t block, Kernel kernel,
+                            std::size_t threads) {
+    const std::size_t blocks = (n + block - 1) / block;
+    if (blocks <= 1) {
+        return n > 0 ? kernel(std::size_t{0}, n) : R(0);
+    }
+    std::vector<R> partial(blocks);
+    parallel_for(
+        blocks,
+        [&](std::size_t first, std::size_t last) {
+            for (std::size_t k = first; k < last; ++k) {
+                partial[k] = kernel(k * block, std::min(n, (k + 1) * block));
+            }
+        },
+        std::min(threads, blocks));
+    for (std::size_t width = 1; width < blocks; width *= 2) {
+        for (std::size_t k = 0; k + width < blocks; k += 2 * width) {
+            partial[k] += partial[k + width];
+        }
+    }
+    return partial[0];
+}
+
+template <typename T>
+[[nodiscard]] accumulate_t<T> sum_base(const T *p, std::size_t n,
+                                       std::size_t threads,
+                                       reduction mode = reduction::fast) {
+    using A = accumulate_t<T>;
+    const auto kernel = [p](std::size_t begin, std::size_t end) {
+        return lane_sum(p + begin, end - begin);
+    };
+    if (mode == reduction::reproducible) {
+        return tree_reduce<A>(n, reproducible_block, kernel,
+                              reduce_threads(n, threads));
+    }
+    return parallel_reduce<A>(
+        n, kernel, [](A a, A b) { return a + b; }, threads);
+}
+
+template <typename T>
+[[nodiscard]] accumulate_t<T> dot_base(const T *a, const T *b, std::size_t n,
+                                       std::size_t threads,
+                                       reduction mode = reduction::fast) {
+    using A = accumulate_t<T>;
+    const auto kernel = [a, b](std::size_t begin, std::size_t end) {
+        return lane_dot(a + begin, b + begin, end - begin);
+    };
+    if (mode == reduction::reproducible) {
+        return tree_reduce<A>(n, reproducible_block, kernel,
+                              reduce_threads(n, threads));
+    }
+    return parallel_reduce<A>(
+        n, kernel, [](A x, A y) { return x + y; }, threads);
+}
+
+} // namespace detail
+
+// ========== Quantity ranges ==========
+
+// Sum of all elements; zero for an empty range.
+template <reducible_range R>
+[[nodiscard]] std::ranges::range_value_t<R>
+sum(const R &values, reduction mode, std::size_t threads = 0) {
+    using Q = std::ranges::range_value_t<R>;
+    return detail::from_base<Q>(
+        detail::sum_base(detail::base_pointer(values),
+                         std::ranges::size(values), threads, mode));
+}
+
+template <reducible_range R>
+[[nodiscard]] std::ranges::range_value_t<R> sum(const R &values,
+                                                std::size_t threads = 0) {
+    return sum(values, reduction::fast, threads);
+}
+
+// Arithmetic mean. The range must not be empty.
+template <reducible_range R>
+[[nodiscard]] std::ranges::range_value_t<R>
+mean(const R &values, reduction mode, std::size_t threads = 0) {
+    using Q = std::ranges::range_value_t<R>;
+    using T = scalar_type_t<Q>;
+    const auto n = std::ranges::size(values);
+    assert(n > 0 && "mean of an empty range");
+    return detail::from_base<Q>(
+        detail::sum_base(detail::base_pointer(values), n, threads, mode) /
+        static_cast<detail::accumulate_t<T>>(n));
+}
+
+template <reducible_range R>
+[[nodiscard]] std::ranges::range_value_t<R> mean(const R &values,
+                                                 std::size_t threads = 0) {
+    return mean(values, reduction::fast, threads);
+}
+
+// Smallest and largest element. The range must not be empty.
+template <reducible_range R>
+[[nodiscard]] std::ranges::min_max_result<std::ranges::range_value_t<R>>
+minmax(const R &values, std::size_t threads = 0) {
+    using Q = std::ranges::range_value_t<R>;
+    using T = scalar_type_t<Q>;
+    const auto n = std::ranges::size(values);
+    assert(n > 0 && "minmax of an empty range");
+    const T *p = detail::base_pointer(values);
+    const auto r = detail::parallel_reduce<detail::min_max<T>>(
+        n,
+        [p](std::size_t begin, std::size_t end) {
+            return detail::lane_minmax(p + begin, end - begin);
+        },
+        [](detail::min_max<T> a, detail::min_max<T> b) {
+            return detail::min_max<T>{b.min < a.min ? b.min : a.min,
+                                      a.max < b.max ? b.max : a.max};
+        },
+        threads);
+    return {detail::from_base<Q>(r.min), detail::from_base<Q>(r.max)};
+}
+
+// sum(a[i] * b[i]) with the product dimension, e.g. forces and displacements
+// give energy. Both ranges must have the same size and scalar type.
+template <reducible_range A, reducible_range B>
+    requires std::is_same_v<scalar_type_t<std::ranges::range_value_t<A>>,
+                            scalar_type_t<std::ranges::range_value_t<B>>>
+[[nodiscard]] auto sum_of_products(const A &a, const B &b, reduction mode,
+                                   std::size_t threads = 0) {
+    using R = product_t<std::ranges::range_value_t<A>,
+                        std::ranges::range_value_t<B>>;
+    const auto n = std::ranges::size(a);
+    assert(n == std::ranges::size(b) && "sum_of_products size mismatch");
+    return detail::from_base<R>(detail::dot_base(
+        detail::base_pointer(a), detail::base_pointer(b), n, threads, mode));
+}
+
+template <reducible_range A, reducible_range B>
+    requires std::is_same_v<scalar_type_t<std::ranges::range_value_t<A>>,
+                            scalar_type_t<std::ranges::range_value_t<B>>>
+[[nodiscard]] auto sum_of_products(const A &a, const B &b,
+                                   std::size_t threads = 0) {
+    return sum_of_products(a, b, reduction::fast, threads);
+}
+
+// ========== vec_array ==========
+
+// Component-wise sum, e.g. the net momentum of a particle set.
+template <typename Q, glm::length_t N>
+[[nodiscard]] vec<Q, N> sum(const vec_array<Q, N> &values, reduction mode,
+                            std::size_t threads = 0) {
+    vec<Q, N> out;
+    for (glm::length_t c = 0; c < N; ++c) {
+        const auto &column = values.component(c);
+        out.data[c] = detail::sum_base(column.base_data(), column.size(),
+                                       threads, mode);
+    }
+    return out;
+}
+
+template <typename Q, glm::length_t N>
+[[nodiscard]] vec<Q, N> sum(const vec_array<Q, N> &values,
+                            std::size_t threads = 0) {
+    return sum(values, reduction::fast, threads);
+}
+
+// sum(dot(a[i], b[i])), e.g. the power of a set of forces on velocities.
+template <typename A, typename B, glm::length_t N>
+    requires std::is_same_v<scalar_type_t<A>, scalar_type_t<B>>
+[[nodiscard]] product_t<A, B> sum_of_products(const vec_array<A, N> &a,
+                                              const vec_array<B, N> &b,
+                                              reduction mode,
+                                              std::size_t threads = 0) {
+    assert(a.size() == b.size() && "sum_of_products size mismatch");
+    detail::accumulate_t<scalar_type_t<A>> total = 0;
+    for (glm::length_t c = 0; c < N; ++c) {
+        total += detail::dot_base(a.component(c).base_data(),
+                                  b.component(c).base_data(), a.size(),
+                                  threads, mode);
+    }
+    return detail::from_base<product_t<A, B>>(total);
+}
+
+template <typename A, typename B, glm::length_t N>
+    requires std::is_same_v<scalar_type_t<A>, scalar_type_t<B>>
+[[nodiscard]] product_t<A, B> sum_of_products(const vec_array<A, N> &a,
+                                              const vec_array<B, N> &b,
+                                              std::size_t threads = 0) {
+    return sum_of_products(a, b, reduction::fast, threads);
+}
+
+// Mean position. The array must not be empty.
+template <typename Q, glm::length_t N>
+[[nodiscard]] vec<Q, N> centroid(const vec_array<Q, N> &positions,
+                                 reduction mode, std::size_t threads = 0) {
+    assert(!positions.empty() && "centroid of an empty vec_array");
+    return sum(positions, mode, threads) /
+           static_cast<scalar_type_t<Q>>(positions.size());
+}
+
+template <typename Q, glm::length_t N>
+[[nodiscard]] vec<Q, N> centroid(const vec_array<Q, N> &positions,
+                                 std::size_t threads = 0) {
+    return centroid(positions, reduction::fast, threads);
+}
+
+// Weighted mean position, e.g. the centre of mass for mass weights.
+template <typename Q, glm::length_t N, reducible_range W>
+    requires std::is_same_v<scalar_type_t<Q>,
+                            scalar_type_t<std::ranges::range_value_t<W>>>
+[[nodiscard]] vec<Q, N> centroid(const vec_array<Q, N> &positions,
+                                 const W &weights, reduction mode,
+                                 std::size_t threads = 0) {
+    using T = scalar_type_t<Q>;
+    const auto n = positions.size();
+    assert(n == std::ranges::size(weights) && "centroid size mismatch");
+    const T *w = detail::base_pointer(weights);
+    const auto total = detail::sum_base(w, n, threads, mode);
+    assert(total != 0 && "centroid weights sum to zero");
+    vec<Q, N> out;
+    for (glm::length_t c = 0; c < N; ++c) {
+        out.data[c] =
+            detail::dot_base(w, positions.component(c).base_data(), n,
+                             threads, mode) /
+            total;
+    }
+    return out;
+}
+
+template <typename Q, glm::length_t N, reducible_range W>
+    requires std::is_same_v<scalar_type_t<Q>,
+                            scalar_type_t<std::ranges::range_value_t<W>>>
+[[nodiscard]] vec<Q, N> centroid(const vec_array<Q, N> &positions,
+                                 const W &weights, std::size_t threads = 0) {
+    return centroid(positions, weights, reduction::fast, threads);
+}
+
+} // namespace physi
@@ -0,0 +1,528 @@
+#pragma once
+
+#include "../array/vec_array.hpp"
+#include "../core/parallel.hpp"
+#include "../quantities.hpp"
+#include "../vec/vec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Uniform-grid spatial hash over vec3<length> positions, for neighbour and
+// broad-phase collision queries without O(N^2) comparisons:
+//
+//   spatial_hash<double> grid(2.0_m);          // cell edge
+//   grid.assign(positions);                    // ids are the row indices
+//   grid.update(positions);                    // after a step: moves only
+//   for (auto id : grid.query(p, 5.0_m)) ...   // within 5 m of p
+//   auto close = grid.pairs_within(1.0_m);     // every pair closer than 1 m
+//
+// Each object sits in the cell floor(p / cell_size); cells are hashed from
+// their integer coordinates (up to 2^20 cells from the origin on each
+// axis), so memory follows the occupied cells only. Single objects can be
+// inserted, moved and erased at any time (an id is stable until erased).
+// Pair enumeration sorts the occupied cells into rows, visits each cell
+// with a half stencil of its neighbours, so every pair is seen once, and
+// splits the rows across threads. A cell edge close to the usual query
+// radius keeps the stencil at 27 cells.
+
+namespace physi {
+
+template <typename T = double> class spatial_hash {
+  public:
+    using value_type = T;
+    using length_type = length<T>;
+    using id_type = std::uint32_t;
+    using pair_type = std::pair<id_type, id_type>;
+
+  private:
+    // Cell coordinates are packed into 21 bits each, biased so that keys
+    // sort by (z, y, x): objects must lie within 2^20 cells of the origin.
+    static constexpr int key_bits = 21;
+    static constexpr std::int64_t key_bias = std::int64_t{1} << (key_bits - 1);
+    static constexpr std::uint64_t key_mask =
+        (std::uint64_t{1} << key_bits) - 1;
+
+    struct entry {
+        std::uint64_t cell;
+        std::uint32_t slot; // index in the cell's id list
+        bool alive;
+    };
+
+    T cell_size_;
+    T inv_cell_;
+    std::unordered_map<std::uint64_t, std::vector<id_type>> cells_;
+    std::vector<T> x_, y_, z_;
+    std::vector<entry> entries_;
+    std::vector<id_type> free_;
+    std::size_t size_ = 0;
+
+  public:
+    explicit spatial_hash(length_type cell_size)
+        : cell_size_(cell_size.base_value()), inv_cell_(T(1) / cell_size_) {
+        assert(cell_size_ > T(0) && "cell size must be positive");
+    }
+
+    [[nodiscard]] length_type cell_size() const noexcept {
+        return length_type(cell_size_);
+    }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] std::size_t cell_count() const noexcept {
+        return cells_.size();
+    }
+    [[nodiscard]] bool contains(id_type id) const noexcept {
+        return id < entries_.size() && entries_[id].alive;
+    }
+    [[nodiscard]] vec3<length_type> position(id_type id) const noexcept {
+        assert(contains(id));
+        return {length_type(x_[id]), length_type(y_[id]), length_type(z_[id])};
+    }
+
+    void clear() noexcept {
+        cells_.clear();
+        x_.clear();
+        y_.clear();
+        z_.clear();
+        entries_.clear();
+        free_.clear();
+        size_ = 0;
+    }
+
+    // ========== Bulk build and update ==========
+    // Replaces the contents with one object per row; ids are row indices.
+    void assign(const vec3_array<length_type> &positions,
+                std::size_t threads = 0) {
+        assert(positions.size() <= std::numeric_limits<id_type>::max());
+        const std::size_t n = positions.size();
+        clear();
+        copy_positions(positions, threads);
+        entries_.resize(n);
+
+        // group the rows by cell with a sort, then fill each cell at once
+        std::vector<std::pair<std::uint64_t, id_type>> keys(n);
+        parallel_for(
+            n,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    keys[i] = {key_of(x_[i], y_[i], z_[i]),
+                               static_cast<id_type>(i)};
+                }
+            },
+            threads_for(n, threads));
+        detail::parallel_sort(keys, threads_for(n, threads));
+        for (std::size_t i = 0; i < n;) {
+            std::size_t j = i;
+            while (j < n && keys[j].first == keys[i].first) {
+                ++j;
+            }
+            std::vector<id_type> &cell = cells_[keys[i].first];
+            cell.reserve(j - i);
+            for (std::size_t k = i; k < j; ++k) {
+                const id_type id = keys[k].second;
+                entries_[id] = {keys[k].first,
+                                static_cast<std::uint32_t>(cell.size()), true};
+                cell.push_back(id);
+            }
+            i = j;
+        }
+        size_ = n;
+    }
+
+    // New positions for every id of an assign()ed grid (row i is id i).
+    // Cells are recomputed in parallel; only objects that changed cell are
+    // moved.
+    void update(const vec3_array<length_type> &positions,
+                std::size_t threads = 0) {
+        assert(positions.size() == entries_.size() && free_.empty() &&
+               "update() needs one row per id");
+        const std::size_t n = positions.size();
+        copy_positions(positions, threads);
+        std::vector<std::uint64_t> keys(n);
+        parallel_for(
+            n,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    keys[i] = key_of(x_[i], y_[i], z_[i]);
+                }
+            },
+            threads_for(n, threads));
+        for (std::size_t i = 0; i < n; ++i) {
+            if (keys[i] != entries_[i].cell) {
+                move(static_cast<id_type>(i), keys[i]);
+            }
+        }
+    }
+
+    // ========== Incremental updates ==========
+    id_type insert(const vec3<length_type> &p) {
+        id_type id;
+        if (!free_.empty()) {
+            id = free_.back();
+            free_.pop_back();
+        } else {
+            assert(entries_.size() < std::numeric_limits<id_type>::max());
+            id = static_cast<id_type>(entries_.size());
+            entries_.push_back({});
+            x_.push_back(T(0));
+            y_.push_back(T(0));
+            z_.push_back(T(0));
+        }
+        store(id, p);
+        const std::uint64_t key = key_of(x_[id], y_[id], z_[id]);
+        std::vector<id_type> &cell = cells_[key];
+        entries_[id] = {key, static_cast<std::uint32_t>(cell.size()), true};
+        cell.push_back(id);
+        ++size_;
+        return id;
+    }
+
+    void update(id_type id, const vec3<length_type> &p) {
+        assert(contains(id));
+        store(id, p);
+        const std::uint64_t key = key_of(x_[id], y_[id], z_[id]);
+        if (key != entries_[id].cell) {
+            move(id, key);
+        }
+    }
+
+    void erase(id_type id) {
+        assert(contains(id));
+        unlink(id);
+        entries_[id].alive = false;
+        free_.push_back(id);
+        --size_;
+    }
+
+    // ========== Queries ==========
+    // Calls f(id) for every object within `radius` of `center` (inclusive).
+    template <typename F>
+    void query(const vec3<length_type> &center, length_type radius,
+               F &&f) const {
+        const T cx = center.x().base_value(), cy = center.y().base_value(),
+                cz = center.z().base_value();
+        const T r = radius.base_value();
+        const T r2 = r * r;
+        // no object lives outside the key range
+        const auto clamped = [this](T v) {
+            return std::clamp(coord(v), -key_bias, key_bias - 1);
+        };
+        const std::int64_t x0 = clamped(cx - r), x1 = clamped(cx + r);
+        const std::int64_t y0 = clamped(cy - r), y1 = clamped(cy + r);
+        const std::int64_t z0 = clamped(cz - r), z1 = clamped(cz + r);
+        for (std::int64_t i = x0; i <= x1; ++i) {
+            for (std::int64_t j = y0; j <= y1; ++j) {
+                for (std::int64_t k = z0; k <= z1; ++k) {
+                    const auto it = cells_.find(pack(i, j, k));
+                    if (it == cells_.end()) {
+                        continue;
+                    }
+                    for (const id_type id : it->second) {
+                        const T dx = x_[id] - cx, dy = y_[id] - cy,
+                                dz = z_[id] - cz;
+                        if (dx * dx + dy * dy + dz * dz <= r2) {
+                            f(id);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::vector<id_type> query(const vec3<length_type> &center,
+                                             length_type radius) const {
+        std::vector<id_type> out;
+        query(center, radius, [&](id_type id) { out.push_back(id); });
+        return out;
+    }
+
+    // Broad phase: every pair sharing a cell or in adjacent cells, each
+    // once as (lower id, higher id).
+    [[nodiscard]] std::vector<pair_type>
+    candidate_pairs(std::size_t threads = 0) const {
+        return collect_pairs(1, std::numeric_limits<T>::infinity(), threads);
+    }
+
+    // Every pair closer than `radius` (inclusive), each once as (lower id,
+    // higher id).
+    [[nodiscard]] std::vector<pair_type>
+    pairs_within(length_type radius, std::size_t threads = 0) const {
+        const T r = radius.base_value();
+        const auto ring = static_cast<int>(std::ceil(r * inv_cell_));
+        return collect_pairs(std::max(ring, 1), r * r, threads);
+    }
+
+  private:
+    [[nodiscard]] std::int64_t coord(T v) const noexcept {
+        return static_cast<std::int64_t>(std::floor(v * inv_cell_));
+    }
+
+    [[nodiscard]] static std::uint64_t pack(std::int64_t i, std::int64_t j,
+                                            std::int64_t k) noexcept {
+        return (static_cast<std::uint64_t>(i + key_bias) & key_mask) |
+               (static_cast<std::uint64_t>(j + key_bias) & key_mask)
+                   << key_bits |
+               (static_cast<std::uint64_t>(k + key_bias) & key_mask)
+                   << (2 * key_bits);
+    }
+
+    [[nodiscard]] static std::int64_t unpack_x(std::uint64_t key) noexcept {
+        return static_cast<std::int64_t>(key & key_mask) - key_bias;
+    }
+
+    [[nodiscard]] std::uint64_t key_of(T x, T y, T z) const noexcept {
+        const std::int64_t i = coord(x), j = coord(y), k = coord(z);
+        assert(std::max({std::abs(i), std::abs(j), std::abs(k)}) < key_bias &&
+               "position outside the grid's range");
+        return pack(i, j, k);
+    }
+
+    [[nodiscard]] static std::size_t threads_for(std::size_t n,
+                                                 std::size_t threads) noexcept {
+        constexpr std::size_t min_objects_per_thread = 4096;
+        if (threads == 0) {
+            threads = default_thread_count();
+        }
+        return std::max<std::size_t>(
+            1, std::min(threads, n / min_objects_per_thread));
+    }
+
+    void copy_positions(const vec3_array<length_type> &positions,
+                        std::size_t threads) {
+        const std::size_t n = positions.size();
+        x_.resize(n);
+        y_.resize(n);
+        z_.resize(n);
+        const T *px = positions.x().base_data();
+        const T *py = positions.y().base_data();
+        const T *pz = positions.z().base_data();
+        parallel_for(
+            n,
+            [&](std::size_t begin, std::size_t end) {
+                std::copy(px + begin, px + end, x_.begin() + begin);
+                std::copy(py + begin, py + end, y_.begin() + begin);
+                std::copy(pz + begin, pz + end, z_.begin() + begin);
+            },
+            threads_for(n, threads));
+    }
+
+    void store(id_type id, const vec3<length_type> &p) noexcept {
+        x_[id] = p.x().base_value();
+        y_[id] = p.y().base_value();
+        z_[id] = p.z().base_value();
+    }
+
+    // Removes id from its cell (swap with the last id, drop empty cells).
+    void unlink(id_type id) {
+        const auto it = cells_.find(entries_[id].cell);
+        std::vector<id_type> &cell = it->second;
+        const std::uint32_t slot = entries_[id].slot;
+        cell[slot] = cell.back();
+        entries_[cell[slot]].slot = slot;
+        cell.pop_back();
+        if (cell.empty()) {
+            cells_.erase(it);
+        }
+    }
+
+    void move(id_type id, std::uint64_t key) {
+        unlink(id);
+        std::vector<id_type> &cell = cells_[key];
+        entries_[id].cell = key;
+        entries_[id].slot = static_cast<std::uint32_t>(cell.size());
+        cell.push_back(id);
+    }
+
+    // Read-only copy of the grid for pair enumeration: cells sorted by key
+    // (so by x along each (y, z) row) with their ids and positions stored
+    // contiguously, and the rows they form.
+    struct snapshot {
+        std::vector<std::uint64_t> keys;
+        std::vector<std::uint32_t> begin; // cell c is [begin[c], begin[c+1])
+        std::vector<id_type> ids;
+        std::vector<T> x, y, z;
+        std::vector<std::uint64_t> row_keys; // key >> key_bits
+        std::vector<std::uint32_t> row_begin; // first cell of each row
+
+        // Row index of row key rk, or row_keys.size() when empty.
+        [[nodiscard]] std::size_t find_row(std::uint64_t rk) const noexcept {
+            const auto it =
+                std::lower_bound(row_keys.begin(), row_keys.end(), rk);
+            return it != row_keys.end() && *it == rk
+                       ? static_cast<std::size_t>(it - row_keys.begin())
+                       : row_keys.size();
+        }
+    };
+
+    [[nodiscard]] snapshot take_snapshot(std::size_t threads) const {
+        std::vector<std::pair<std::uint64_t, const std::vector<id_type> *>>
+            cells;
+        cells.reserve(cells_.size());
+        for (const auto &[key, ids] : cells_) {
+            cells.emplace_back(key, &ids);
+        }
+        std::sort(cells.begin(), cells.end(), [](const auto &a, const auto &b) {
+            return a.first < b.first;
+        });
+
+        snapshot snap;
+        snap.keys.reserve(cells.size());
+        snap.begin.reserve(cells.size() + 1);
+        snap.ids.reserve(size_);
+        for (const auto &[key, ids] : cells) {
+            if (snap.keys.empty() ||
+                (key >> key_bits) != snap.row_keys.back()) {
+                snap.row_keys.push_back(key >> key_bits);
+                snap.row_begin.push_back(
+                    static_cast<std::uint32_t>(snap.keys.size()));
+            }
+            snap.keys.push_back(key);
+            snap.begin.push_back(static_cast<std::uint32_t>(snap.ids.size()));
+            snap.ids.insert(snap.ids.end(), ids->begin(), ids->end());
+        }
+        snap.begin.push_back(static_cast<std::uint32_t>(snap.ids.size()));
+        snap.row_begin.push_back(static_cast<std::uint32_t>(snap.keys.size()));
+
+        const std::size_t n = snap.ids.size();
+        snap.x.resize(n);
+        snap.y.resize(n);
+        snap.z.resize(n);
+        parallel_for(
+            n,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    snap.x[i] = x_[snap.ids[i]];
+                    snap.y[i] = y_[snap.ids[i]];
+                    snap.z[i] = z_[snap.ids[i]];
+                }
+            },
+            threads);
+        return snap;
+    }
+
+    // Half stencil in (z, y, x) order: each cell is paired with itself,
+    // with the cells up to `ring` further along its row, and with the cells
+    // within `ring` in x of the rows at (dz, dy) > (0, 0). Cells of a row
+    // hold their objects contiguously, so each of those is one object range
+    // found by cursors sweeping the rows; no per-cell lookups are needed.
+    [[nodiscard]] std::vector<pair_type>
+    collect_pairs(int ring, T r2, std::size_t threads) const {
+        std::vector<std::array<int, 2>> row_offsets; // (dy, dz)
+        for (int dz = 0; dz <= ring; ++dz) {
+            for (int dy = -ring; dy <= ring; ++dy) {
+                if (dz > 0 || dy > 0) {
+                    row_offsets.push_back({dy, dz});
+                }
+            }
+        }
+
+        const std::size_t chunks = threads_for(size_, threads);
+        const snapshot snap = take_snapshot(chunks);
+        // pairs of objects [a0, a1) with [b0, b1), or with (a, b1) when
+        // b0 == a0 (the cell itself and whatever follows it)
+        const auto scan = [&](std::vector<pair_type> &out, std::uint32_t a0,
+                              std::uint32_t a1, std::uint32_t b0,
+                              std::uint32_t b1) {
+            const bool same = a0 == b0;
+            for (std::uint32_t a = a0; a < a1; ++a) {
+                const T ax = snap.x[a], ay = snap.y[a], az = snap.z[a];
+                for (std::uint32_t b = same ? a + 1 : b0; b < b1; ++b) {
+                    const T dx = ax - snap.x[b], dy = ay - snap.y[b],
+                            dz = az - snap.z[b];
+                    if (dx * dx + dy * dy + dz * dz <= r2) {
+                        const id_type p = snap.ids[a], q = snap.ids[b];
+                        out.emplace_back(std::min(p, q), std::max(p, q));
+                    }
+                }
+            }
+        };
+        const auto cell_x = [&](std::size_t c) {
+            return unpack_x(snap.keys[c]);
+        };
+
+        const std::size_t rows = snap.row_keys.size();
+        std::vector<std::vector<pair_type>> found(chunks);
+        parallel_for(
+            chunks,
+            [&](std::size_t first, std::size_t last) {
+                // per neighbour row: [lo, hi) cells in the x window, and the
+                // row's end
+                std::vector<std::array<std::size_t, 3>> cursors(
+                    row_offsets.size());
+                for (std::size_t ch = first; ch < last; ++ch) {
+                    std::vector<pair_type> &out = found[ch];
+                    const std::size_t r_end = rows * (ch + 1) / chunks;
+                    for (std::size_t r = rows * ch / chunks; r < r_end; ++r) {
+                        const std::uint64_t rk = snap.row_keys[r];
+                        const std::uint64_t j = rk & key_mask;
+                        const std::uint64_t l = rk >> key_bits;
+                        for (std::size_t k = 0; k < row_offsets.size(); ++k) {
+                            const std::uint64_t nj = j + row_offsets[k][0];
+                            const std::uint64_t nl = l + row_offsets[k][1];
+                            // (unsigned: rows past either edge are empty)
+                            const std::size_t nr =
+                                nj > key_mask || nl > key_mask
+                                    ? rows
+                                    : snap.find_row(nl << key_bits | nj);
+                            const std::size_t c = nr == rows
+                                                      ? 0
+                                                      : snap.row_begin[nr];
+                            const std::size_t e = nr == rows
+                                                      ? 0
+                                                      : snap.row_begin[nr + 1];
+                            cursors[k] = {c, c, e};
+                        }
+
+                        const std::size_t c0 = snap.row_begin[r],
+                                          c1 = snap.row_begin[r + 1];
+                        std::size_t ahead = c0 + 1;
+                        for (std::size_t c = c0; c < c1; ++c) {
+                            const std::uint32_t a0 = snap.begin[c],
+                                                a1 = snap.begin[c + 1];
+                            const std::int64_t x = cell_x(c);
+                            ahead = std::max(ahead, c + 1);
+                            while (ahead < c1 && cell_x(ahead) <= x + ring) {
+                                ++ahead;
+                            }
+                            scan(out, a0, a1, a0, snap.begin[ahead]);
+                            for (auto &[lo, hi, end] : cursors) {
+                                while (lo < end && cell_x(lo) < x - ring) {
+                                    ++lo;
+                                }
+                                hi = std::max(hi, lo);
+                                while (hi < end && cell_x(hi) <= x + ring) {
+                                    ++hi;
+                                }
+                                scan(out, a0, a1, snap.begin[lo],
+                                     snap.begin[hi]);
+                            }
+                        }
+                    }
+                }
+            },
+            chunks);
+
+        std::size_t total = 0;
+        for (const auto &f : found) {
+            total += f.size();
+        }
+        std::vector<pair_type> pairs;
+        pairs.reserve(total);
+        for (const auto &f : found) {
+            pairs.insert(pairs.end(), f.begin(), f.end());
+        }
+        return pairs;
+    }
+};
+
+} // namespace physi
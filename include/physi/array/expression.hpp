@@ -0,0 +1,334 @@
+#pragma once
+
+#include "../core/quantity.hpp"
+#include "../core/simd.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Lazy, dimension-checked expressions over quantity columns.
+//
+// Operators on quantity_array (and vec_array) do not compute anything; they
+// build a small typed tree whose quantity_type is deduced from the scalar
+// operators (speed * time -> length, ...). The tree is evaluated in a single
+// fused loop when assigned to a container:
+//
+//   pos = pos + vel * dt + 0.5 * acc * dt * dt;   // one pass, no temporaries
+//
+// Array operands are captured by reference when they are lvalues and by
+// value when they are temporaries, so an expression must not outlive (or be
+// evaluated after resizing) the named arrays it refers to.
+
+namespace physi {
+
+namespace detail {
+
+// Base value of a single quantity or of a plain arithmetic value.
+template <typename Q>
+[[nodiscard]] constexpr scalar_type_t<Q> base_of(const Q &q) noexcept {
+    if constexpr (is_quantity_v<Q>) {
+        return q.base_value();
+    } else {
+        return q;
+    }
+}
+
+} // namespace detail
+
+// Opt-in traits: a type is an array expression when it declares
+// `static constexpr bool is_array_expression = true` and provides
+// quantity_type, value_type, size() and base_at(i).
+template <typename T>
+inline constexpr bool is_array_expression_v = requires {
+    requires std::remove_cvref_t<T>::is_array_expression;
+};
+
+// A value broadcast to every element: a single quantity or plain scalar.
+template <typename T>
+inline constexpr bool is_broadcast_v =
+    is_quantity_v<std::remove_cvref_t<T>> ||
+    std::is_arithmetic_v<std::remove_cvref_t<T>>;
+
+namespace expr {
+
+struct plus {
+    template <typename A, typename B> using result = sum_t<A, B>;
+    template <typename T>
+    static constexpr T apply(T a, T b) noexcept {
+        return a + b;
+    }
+};
+
+struct minus {
+    template <typename A, typename B> using result = difference_t<A, B>;
+    template <typename T>
+    static constexpr T apply(T a, T b) noexcept {
+        return a - b;
+    }
+};
+
+struct multiplies {
+    template <typename A, typename B> using result = product_t<A, B>;
+    template <typename T>
+    static constexpr T apply(T a, T b) noexcept {
+        return a * b;
+    }
+};
+
+struct divides {
+    template <typename A, typename B> using result = quotient_t<A, B>;
+    template <typename T>
+    static constexpr T apply(T a, T b) noexcept {
+        return a / b;
+    }
+};
+
+// ========== Leaves ==========
+
+// Broadcast value; has no size of its own.
+template <typename Quantity> struct scalar {
+    static constexpr bool is_array_expression = true;
+    static constexpr bool is_scalar = true;
+
+    using quantity_type = Quantity;
+    using value_type = scalar_type_t<Quantity>;
+
+    value_type value;
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept { return 0; }
+    [[nodiscard]] constexpr value_type base_at(std::size_t) const noexcept {
+        return value;
+    }
+};
+
+// Named (lvalue) column: captured by pointer.
+template <typename Array> struct column_ref {
+    static constexpr bool is_array_expression = true;
+    static constexpr bool is_scalar = false;
+
+    using quantity_type = typename Array::quantity_type;
+    using value_type = typename Array::value_type;
+
+    const value_type *data;
+    std::size_t n;
+
+    explicit column_ref(const Array &a) noexcept
+        : data(a.base_data()), n(a.size()) {}
+
+    [[nodiscard]] std::size_t size() const noexcept { return n; }
+    [[nodiscard]] value_type base_at(std::size_t i) const noexcept {
+        return data[i];
+    }
+};
+
+// Temporary column: owned by the expression.
+template <typename Array> struct column_value {
+    static constexpr bool is_array_expression = true;
+    static constexpr bool is_scalar = false;
+
+    using quantity_type = typename Array::quantity_type;
+    using value_type = typename Array::value_type;
+
+    Array array;
+
+    [[nodiscard]] std::size_t size() const noexcept { return array.size(); }
+    [[nodiscard]] value_type base_at(std::size_t i) const noexcept {
+        return array.base_data()[i];
+    }
+};
+
+// ========== Interior nodes ==========
+
+template <typename Op, typename L, typename R> struct binary {
+    static constexpr bool is_array_expression = true;
+    static constexpr bool is_scalar = L::is_scalar && R::is_scalar;
+
+    using quantity_type = typename Op::template result<typename L::quantity_type,
+                                                       typename R::quantity_type>;
+    using value_type = scalar_type_t<quantity_type>;
+
+    L lhs;
+    R rhs;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        if constexpr (L::is_scalar) {
+            return rhs.size();
+        } else {
+            assert((R::is_scalar || lhs.size() == rhs.size()) &&
+                   "array expression size mismatch");
+            return lhs.size();
+        }
+    }
+
+    [[nodiscard]] value_type base_at(std::size_t i) const noexcept {
+        return Op::apply(static_cast<value_type>(lhs.base_at(i)),
+                         static_cast<value_type>(rhs.base_at(i)));
+    }
+};
+
+template <typename E> struct negate {
+    static constexpr bool is_array_expression = true;
+    static constexpr bool is_scalar = E::is_scalar;
+
+    using quantity_type = typename E::quantity_type;
+    using value_type = typename E::value_type;
+
+    E operand;
+
+    [[nodiscard]] std::size_t size() const noexcept { return operand.size(); }
+    [[nodiscard]] value_type base_at(std::size_t i) const noexcept {
+        return -operand.base_at(i);
+    }
+};
+
+// ========== Operand capture ==========
+
+template <typename T> struct is_node : std::false_type {};
+template <typename Q> struct is_node<scalar<Q>> : std::true_type {};
+template <typename A> struct is_node<column_ref<A>> : std::true_type {};
+template <typename A> struct is_node<column_value<A>> : std::true_type {};
+template <typename Op, typename L, typename R>
+struct is_node<binary<Op, L, R>> : std::true_type {};
+template <typename E> struct is_node<negate<E>> : std::true_type {};
+
+// Wrap any operand into a node: nodes are copied, named columns referenced,
+// temporary columns moved in and single values broadcast.
+template <typename T> [[nodiscard]] auto capture(T &&t) {
+    using D = std::remove_cvref_t<T>;
+    if constexpr (is_node<D>::value) {
+        return D(std::forward<T>(t));
+    } else if constexpr (is_broadcast_v<D>) {
+        return scalar<D>{detail::base_of(t)};
+    } else if constexpr (std::is_lvalue_reference_v<T>) {
+        return column_ref<D>(t);
+    } else {
+        return column_value<D>{std::move(t)};
+    }
+}
+
+template <typename T> using capture_t = decltype(capture(std::declval<T>()));
+
+// Non-owning copy of a node: owned columns become column_refs to them, so
+// the view is cheap to copy but only valid while the node lives.
+template <typename Q>
+[[nodiscard]] scalar<Q> view(const scalar<Q> &e) noexcept {
+    return e;
+}
+
+template <typename A>
+[[nodiscard]] column_ref<A> view(const column_ref<A> &e) noexcept {
+    return e;
+}
+
+template <typename A>
+[[nodiscard]] column_ref<A> view(const column_value<A> &e) noexcept {
+    return column_ref<A>(e.array);
+}
+
+template <typename Op, typename L, typename R>
+[[nodiscard]] auto view(const binary<Op, L, R> &e) noexcept
+    -> binary<Op, decltype(view(e.lhs)), decltype(view(e.rhs))> {
+    return {view(e.lhs), view(e.rhs)};
+}
+
+template <typename E>
+[[nodiscard]] auto view(const negate<E> &e) noexcept
+    -> negate<decltype(view(e.operand))> {
+    return {view(e.operand)};
+}
+
+// Node over an operand for the duration of one assignment: nodes are
+// viewed rather than copied, so the columns they own are not duplicated.
+template <typename T> [[nodiscard]] auto borrow(const T &t) noexcept {
+    if constexpr (is_node<T>::value) {
+        return view(t);
+    } else {
+        return capture(t);
+    }
+}
+
+template <typename Op, typename L, typename R>
+using binary_t = binary<Op, capture_t<L>, capture_t<R>>;
+
+template <typename Op, typename L, typename R>
+[[nodiscard]] binary_t<Op, L, R> make_binary(L &&l, R &&r) {
+    return {capture(std::forward<L>(l)), capture(std::forward<R>(r))};
+}
+
+// Operators apply when at least one side is an array expression, the other
+// is an array expression or a broadcast value, and the scalar operator is
+// defined for the two quantity types.
+template <typename Op, typename L, typename R>
+concept operands =
+    ((is_array_expression_v<L> && is_array_expression_v<R>) ||
+     (is_array_expression_v<L> && is_broadcast_v<R>) ||
+     (is_broadcast_v<L> && is_array_expression_v<R>)) &&
+    requires {
+        typename Op::template result<typename capture_t<L>::quantity_type,
+                                     typename capture_t<R>::quantity_type>;
+    };
+
+// Evaluate `e` into dst[0, n) in one fused, vectorizable loop.
+template <typename T, typename E>
+void assign(T *dst, std::size_t n, const E &e) noexcept {
+    PHYSI_IVDEP
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<T>(e.base_at(i));
+    }
+}
+
+template <typename T, typename E, typename Op>
+void update(T *dst, std::size_t n, const E &e, Op) noexcept {
+    PHYSI_IVDEP
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] = Op::apply(dst[i], static_cast<T>(e.base_at(i)));
+    }
+}
+
+} // namespace expr
+
+// ========== Operators ==========
+// The result quantity is computed by the scalar operators, so an expression
+// that mixes incompatible dimensions fails to compile.
+
+template <typename L, typename R>
+    requires expr::operands<expr::plus, L, R>
+[[nodiscard]] auto operator+(L &&l, R &&r)
+    -> expr::binary_t<expr::plus, L, R> {
+    return expr::make_binary<expr::plus>(std::forward<L>(l),
+                                         std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires expr::operands<expr::minus, L, R>
+[[nodiscard]] auto operator-(L &&l, R &&r)
+    -> expr::binary_t<expr::minus, L, R> {
+    return expr::make_binary<expr::minus>(std::forward<L>(l),
+                                          std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires expr::operands<expr::multiplies, L, R>
+[[nodiscard]] auto operator*(L &&l, R &&r)
+    -> expr::binary_t<expr::multiplies, L, R> {
+    return expr::make_binary<expr::multiplies>(std::forward<L>(l),
+                                               std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires expr::operands<expr::divides, L, R>
+[[nodiscard]] auto operator/(L &&l, R &&r)
+    -> expr::binary_t<expr::divides, L, R> {
+    return expr::make_binary<expr::divides>(std::forward<L>(l),
+                                            std::forward<R>(r));
+}
+
+template <typename E>
+    requires is_array_expression_v<E>
+[[nodiscard]] auto operator-(E &&e) -> expr::negate<expr::capture_t<E>> {
+    return {expr::capture(std::forward<E>(e))};
+}
+
+} // namespace physi
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "../core/quantity.hpp"
+#include "../core/simd.hpp"
+#include "expression.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace physi {
+
+// Contiguous, simd_alignment-aligned column of quantities (structure of
+// arrays). Elements are stored exactly like their underlying scalar, so a
+// quantity_array<length_f> is a plain float buffer that keeps its dimension:
+//
+//   quantity_array<length_f> x(n);
+//   quantity_array<speed_f> v(n);
+//   x += v * 0.016_s;   // one vectorized loop, no base_value() unwrapping
+//
+// Arithmetic on arrays builds lazy expressions (see expression.hpp) that are
+// evaluated in one pass when assigned. Quantity may also be an arithmetic
+// type for dimensionless columns.
+template <typename Quantity> class quantity_array {
+    static_assert(is_quantity_v<Quantity> || is_quantity_scalar_v<Quantity>,
+                  "quantity_array holds quantities or arithmetic values");
+    static_assert(sizeof(Quantity) == sizeof(scalar_type_t<Quantity>),
+                  "Quantity must have the same layout as its scalar");
+
+  public:
+    using quantity_type = Quantity;
+    using value_type = scalar_type_t<Quantity>;
+    using size_type = std::size_t;
+    using iterator = Quantity *;
+    using const_iterator = const Quantity *;
+
+    static constexpr bool is_array_expression = true;
+    static constexpr bool is_scalar = false;
+
+  private:
+    std::vector<Quantity, aligned_allocator<Quantity>> data_;
+
+  public:
+    quantity_array() = default;
+
+    // n zero-initialized elements
+    explicit quantity_array(size_type n) : data_(n) {}
+
+    quantity_array(size_type n, const Quantity &fill) : data_(n, fill) {}
+
+    quantity_array(std::initializer_list<Quantity> list) : data_(list) {}
+
+    explicit quantity_array(std::span<const Quantity> values)
+        : data_(values.begin(), values.end()) {}
+
+    // Evaluate an array expression (or convert another precision).
+    template <typename E>
+        requires is_array_expression_v<E> &&
+                 std::is_convertible_v<typename E::quantity_type, Quantity>
+    quantity_array(const E &e) : data_(e.size()) {
+        expr::assign(base_data(), size(), e);
+    }
+
+    // Relabel another quantity of the dimension, e.g. energies as torques;
+    // explicit, as for the single quantities.
+    template <typename E>
+        requires is_array_expression_v<E> &&
+                 same_dimension_as<typename E::quantity_type, Quantity> &&
+                 (!std::is_convertible_v<typename E::quantity_type, Quantity>)
+    explicit quantity_array(const E &e) : data_(e.size()) {
+        expr::assign(base_data(), size(), e);
+    }
+
+    quantity_array(const quantity_array &) = default;
+    quantity_array(quantity_array &&) noexcept = default;
+    quantity_array &operator=(const quantity_array &) = default;
+    quantity_array &operator=(quantity_array &&) noexcept = default;
+
+    // Evaluate into the existing storage. Element i of the expression only
+    // reads element i of its operands, so `x = x + v * dt` is safe.
+    template <typename E>
+        requires is_array_expression_v<E> &&
+                 std::is_convertible_v<typename E::quantity_type, Quantity>
+    quantity_array &operator=(const E &e) {
+        const auto n = e.size();
+        if (n != size()) {
+            data_.resize(n);
+        }
+        expr::assign(base_data(), n, e);
+        return *this;
+    }
+
+    // ========== Size & capacity ==========
+    [[nodiscard]] size_type size() const noexcept { return data_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return data_.empty(); }
+    [[nodiscard]] size_type capacity() const noexcept {
+        return data_.capacity();
+    }
+
+    void reserve(size_type n) { data_.reserve(n); }
+    void resize(size_type n) { data_.resize(n); }
+    void resize(size_type n, const Quantity &fill) { data_.resize(n, fill); }
+    void clear() noexcept { data_.clear(); }
+    void push_back(const Quantity &q) { data_.push_back(q); }
+
+    // ========== Element access ==========
+    [[nodiscard]] Quantity &operator[](size_type i) noexcept {
+        return data_[i];
+    }
+    [[nodiscard]] const Quantity &operator[](size_type i) const noexcept {
+        return data_[i];
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return data_.data(); }
+    [[nodiscard]] iterator end() noexcept { return data_.data() + size(); }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return data_.data();
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return data_.data() + size();
+    }
+
+    // ========== Raw data access ==========
+    [[nodiscard]] Quantity *data() noexcept { return data_.data(); }
+    [[nodiscard]] const Quantity *data() const noexcept {
+        return data_.data();
+    }
+
+    // Base (SI) values as a flat scalar buffer.
+    [[nodiscard]] value_type *base_data() noexcept {
+        return assume_aligned(reinterpret_cast<value_type *>(data_.data()));
+    }
+    [[nodiscard]] const value_type *base_data() const noexcept {
+        return assume_aligned(
+            reinterpret_cast<const value_type *>(data_.data()));
+    }
+
+    [[nodiscard]] std::span<value_type> base_span() noexcept {
+        return {base_data(), size()};
+    }
+    [[nodiscard]] std::span<const value_type> base_span() const noexcept {
+        return {base_data(), size()};
+    }
+
+    [[nodiscard]] value_type base_at(size_type i) const noexcept {
+        return base_data()[i];
+    }
+
+    // ========== Compound assignment (keeps underlying type) ==========
+    // Right-hand sides are array expressions of the same dimension or a
+    // single quantity broadcast to every element.
+    template <typename E>
+        requires(is_array_expression_v<E> || is_broadcast_v<E>) &&
+                std::is_convertible_v<typename expr::capture_t<const E &>::
+                                          quantity_type,
+                                      Quantity>
+    quantity_array &operator+=(const E &e) noexcept {
+        update<expr::plus>(expr::borrow(e));
+        return *this;
+    }
+
+    template <typename E>
+        requires(is_array_expression_v<E> || is_broadcast_v<E>) &&
+                std::is_convertible_v<typename expr::capture_t<const E &>::
+                                          quantity_type,
+                                      Quantity>
+    quantity_array &operator-=(const E &e) noexcept {
+        update<expr::minus>(expr::borrow(e));
+        return *this;
+    }
+
+    // Under PHYSI_STRICT_PRECISION the factor may not be wider than the
+    // column, e.g. a double scaling a float column.
+    template <typename Scalar>
+        requires std::is_arithmetic_v<Scalar> &&
+                 implicitly_convertible_precision<Scalar, value_type>
+    quantity_array &operator*=(Scalar s) noexcept {
+        update<expr::multiplies>(expr::scalar<value_type>{
+            static_cast<value_type>(s)});
+        return *this;
+    }
+
+    template <typename Scalar>
+        requires std::is_arithmetic_v<Scalar> &&
+                 implicitly_convertible_precision<Scalar, value_type>
+    quantity_array &operator/=(Scalar s) noexcept {
+        update<expr::divides>(expr::scalar<value_type>{
+            static_cast<value_type>(s)});
+        return *this;
+    }
+
+  private:
+    template <typename Op, typename E> void update(const E &e) noexcept {
+        assert((E::is_scalar || e.size() == size()) &&
+               "quantity_array size mismatch");
+        expr::update(base_data(), size(), e, Op{});
+    }
+};
+
+// quantity_array v = x / t;   // deduces quantity_array<speed_d>
+template <typename E>
+    requires is_array_expression_v<E>
+quantity_array(const E &) -> quantity_array<typename E::quantity_type>;
+
+template <typename T> struct is_quantity_array : std::false_type {};
+
+template <typename Q>
+struct is_quantity_array<quantity_array<Q>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_quantity_array_v = is_quantity_array<T>::value;
+
+} // namespace physi
@@ -0,0 +1,522 @@
+#pragma once
+
+#include "../vec/vec.hpp"
+#include "expression.hpp"
+#include "quantity_array.hpp"
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace physi {
+
+// A vec expression has `static constexpr bool is_vec_expression = true`, a
+// `components` count, size() and component(c) returning an array expression.
+template <typename T>
+inline constexpr bool is_vec_expression_v = requires {
+    requires std::remove_cvref_t<T>::is_vec_expression;
+};
+
+namespace expr {
+template <typename T> [[nodiscard]] auto vec_capture(T &&t);
+template <typename T> [[nodiscard]] auto vec_borrow(const T &t) noexcept;
+} // namespace expr
+
+// Structure-of-arrays counterpart of vec<Quantity, N>: every component lives
+// in its own aligned quantity_array column, so x/y/z updates over a whole
+// particle set are N independent vectorizable loops instead of strided
+// accesses into an array of vec3. Arithmetic builds lazy vec expressions that
+// are evaluated component by component, one fused loop per column.
+template <typename Quantity, glm::length_t N> class vec_array {
+  public:
+    using quantity_type = Quantity;
+    using value_type = scalar_type_t<Quantity>;
+    using vec_type = vec<Quantity, N>;
+    using column_type = quantity_array<Quantity>;
+    using size_type = std::size_t;
+
+    static constexpr bool is_vec_expression = true;
+    static constexpr glm::length_t components = N;
+
+  private:
+    std::array<column_type, N> columns_;
+
+  public:
+    vec_array() = default;
+
+    // n zero vectors
+    explicit vec_array(size_type n) {
+        for (auto &column : columns_) {
+            column.resize(n);
+        }
+    }
+
+    vec_array(size_type n, const vec_type &fill) {
+        for (glm::length_t c = 0; c < N; ++c) {
+            columns_[c].resize(n, fill[c]);
+        }
+    }
+
+    // Evaluate a vec expression (or convert another precision).
+    template <typename E>
+        requires is_vec_expression_v<E> && (E::components == N) &&
+                 std::is_convertible_v<typename E::quantity_type, Quantity>
+    vec_array(const E &e) {
+        *this = e;
+    }
+
+    // Relabel another quantity of the dimension, e.g. energies as torques.
+    template <typename E>
+        requires is_vec_expression_v<E> && (E::components == N) &&
+                 same_dimension_as<typename E::quantity_type, Quantity> &&
+                 (!std::is_convertible_v<typename E::quantity_type, Quantity>)
+    explicit vec_array(const E &e) {
+        const auto node = expr::vec_borrow(e);
+        for (glm::length_t c = 0; c < N; ++c) {
+            columns_[c] = column_type(node.component(c));
+        }
+    }
+
+    vec_array(const vec_array &) = default;
+    vec_array(vec_array &&) noexcept = default;
+    vec_array &operator=(const vec_array &) = default;
+    vec_array &operator=(vec_array &&) noexcept = default;
+
+    template <typename E>
+        requires is_vec_expression_v<E> && (E::components == N) &&
+                 std::is_convertible_v<typename E::quantity_type, Quantity>
+    vec_array &operator=(const E &e) {
+        const auto node = expr::vec_borrow(e);
+        for (glm::length_t c = 0; c < N; ++c) {
+            columns_[c] = node.component(c);
+        }
+        return *this;
+    }
+
+    // Adopt already filled component columns (all of the same size).
+    [[nodiscard]] static vec_array
+    from_components(std::array<column_type, N> columns) {
+        vec_array out;
+        out.columns_ = std::move(columns);
+        return out;
+    }
+
+    // ========== Size & capacity ==========
+    [[nodiscard]] size_type size() const noexcept {
+        return columns_[0].size();
+    }
+    [[nodiscard]] bool empty() const noexcept { return columns_[0].empty(); }
+    [[nodiscard]] size_type capacity() const noexcept {
+        return columns_[0].capacity();
+    }
+
+    void reserve(size_type n) {
+        for (auto &column : columns_) {
+            column.reserve(n);
+        }
+    }
+
+    void resize(size_type n) {
+        for (auto &column : columns_) {
+            column.resize(n);
+        }
+    }
+
+    void clear() noexcept {
+        for (auto &column : columns_) {
+            column.clear();
+        }
+    }
+
+    void push_back(const vec_type &v) {
+        for (glm::length_t c = 0; c < N; ++c) {
+            columns_[c].push_back(v[c]);
+        }
+    }
+
+    // ========== Element access (gathers/scatters one vec) ==========
+    [[nodiscard]] vec_type operator[](size_type i) const noexcept {
+        vec_type v;
+        for (glm::length_t c = 0; c < N; ++c) {
+            v.data[c] = columns_[c].base_data()[i];
+        }
+        return v;
+    }
+
+    void set(size_type i, const vec_type &v) noexcept {
+        for (glm::length_t c = 0; c < N; ++c) {
+            columns_[c].base_data()[i] = v.data[c];
+        }
+    }
+
+    // ========== Component columns ==========
+    [[nodiscard]] column_type &component(glm::length_t c) noexcept {
+        return columns_[c];
+    }
+    [[nodiscard]] const column_type &
+    component(glm::length_t c) const noexcept {
+        return columns_[c];
+    }
+
+    [[nodiscard]] column_type &x() noexcept { return columns_[0]; }
+    [[nodiscard]] column_type &y() noexcept { return columns_[1]; }
+    [[nodiscard]] column_type &z() noexcept
+        requires(N >= 3)
+    {
+        return columns_[2];
+    }
+    [[nodiscard]] column_type &w() noexcept
+        requires(N >= 4)
+    {
+        return columns_[3];
+    }
+    [[nodiscard]] const column_type &x() const noexcept { return columns_[0]; }
+    [[nodiscard]] const column_type &y() const noexcept { return columns_[1]; }
+    [[nodiscard]] const column_type &z() const noexcept
+        requires(N >= 3)
+    {
+        return columns_[2];
+    }
+    [[nodiscard]] const column_type &w() const noexcept
+        requires(N >= 4)
+    {
+        return columns_[3];
+    }
+
+    // ========== Compound assignment ==========
+    // Right-hand sides are vec expressions or a single vec broadcast to every
+    // row.
+    template <typename E>
+        requires(is_vec_expression_v<E> || is_vec<E>::value)
+    vec_array &operator+=(const E &e) noexcept {
+        const auto node = expr::vec_borrow(e);
+        for (glm::length_t c = 0; c < N; ++c) {
+            columns_[c] += node.component(c);
+        }
+        return *this;
+    }
+
+    template <typename E>
+        requires(is_vec_expression_v<E> || is_vec<E>::value)
+    vec_array &operator-=(const E &e) noexcept {
+        const auto node = expr::vec_borrow(e);
+        for (glm::length_t c = 0; c < N; ++c) {
+            columns_[c] -= node.component(c);
+        }
+        return *this;
+    }
+
+    template <typename Scalar>
+        requires std::is_arithmetic_v<Scalar> &&
+                 implicitly_convertible_precision<Scalar, value_type>
+    vec_array &operator*=(Scalar s) noexcept {
+        for (auto &column : columns_) {
+            column *= s;
+        }
+        return *this;
+    }
+
+    template <typename Scalar>
+        requires std::is_arithmetic_v<Scalar> &&
+                 implicitly_convertible_precision<Scalar, value_type>
+    vec_array &operator/=(Scalar s) noexcept {
+        for (auto &column : columns_) {
+            column /= s;
+        }
+        return *this;
+    }
+};
+
+template <typename E>
+    requires is_vec_expression_v<E>
+vec_array(const E &) -> vec_array<typename E::quantity_type, E::components>;
+
+template <typename T> struct is_vec_array : std::false_type {};
+
+template <typename Q, glm::length_t N>
+struct is_vec_array<vec_array<Q, N>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_vec_array_v = is_vec_array<T>::value;
+
+template <typename Quantity> using vec2_array = vec_array<Quantity, 2>;
+template <typename Quantity> using vec3_array = vec_array<Quantity, 3>;
+template <typename Quantity> using vec4_array = vec_array<Quantity, 4>;
+
+namespace expr {
+
+// ========== Vec leaves ==========
+
+// Named vec_array: components are referenced columns.
+template <typename Array> struct vec_ref {
+    static constexpr bool is_vec_expression = true;
+    static constexpr glm::length_t components = Array::components;
+    using quantity_type = typename Array::quantity_type;
+
+    const Array *array;
+
+    [[nodiscard]] std::size_t size() const noexcept { return array->size(); }
+    [[nodiscard]] auto component(glm::length_t c) const noexcept {
+        return column_ref<typename Array::column_type>(array->component(c));
+    }
+};
+
+// Temporary vec_array owned by the expression.
+template <typename Array> struct vec_value {
+    static constexpr bool is_vec_expression = true;
+    static constexpr glm::length_t components = Array::components;
+    using quantity_type = typename Array::quantity_type;
+
+    Array array;
+
+    [[nodiscard]] std::size_t size() const noexcept { return array.size(); }
+    [[nodiscard]] auto component(glm::length_t c) const noexcept {
+        return column_ref<typename Array::column_type>(array.component(c));
+    }
+};
+
+// A single vec broadcast to every row.
+template <typename Quantity, glm::length_t N> struct vec_broadcast {
+    static constexpr bool is_vec_expression = true;
+    static constexpr bool is_row_broadcast = true;
+    static constexpr glm::length_t components = N;
+    using quantity_type = Quantity;
+
+    vec<Quantity, N> value;
+
+    [[nodiscard]] std::size_t size() const noexcept { return 0; }
+    [[nodiscard]] auto component(glm::length_t c) const noexcept {
+        return scalar<Quantity>{value.data[c]};
+    }
+};
+
+// A column (or single value) applied to every component of a row, e.g. the
+// per-particle mass in `force / mass`.
+template <typename E> struct row_broadcast {
+    static constexpr bool is_row_broadcast = true;
+    using quantity_type = typename E::quantity_type;
+
+    E operand;
+
+    [[nodiscard]] std::size_t size() const noexcept { return operand.size(); }
+    [[nodiscard]] const E &component(glm::length_t) const noexcept {
+        return operand;
+    }
+};
+
+// ========== Vec interior nodes ==========
+
+template <typename E>
+using component_t =
+    std::remove_cvref_t<decltype(std::declval<const E &>().component(0))>;
+
+template <typename Op, typename L, typename R> struct vec_binary {
+    static constexpr bool is_vec_expression = true;
+
+    using component_type = binary<Op, component_t<L>, component_t<R>>;
+    using quantity_type = typename component_type::quantity_type;
+
+    L lhs;
+    R rhs;
+
+    [[nodiscard]] component_type component(glm::length_t c) const {
+        return {lhs.component(c), rhs.component(c)};
+    }
+
+    static constexpr glm::length_t components = [] {
+        if constexpr (requires { L::components; }) {
+            return L::components;
+        } else {
+            return R::components;
+        }
+    }();
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return component(0).size();
+    }
+};
+
+template <typename E> struct vec_negate {
+    static constexpr bool is_vec_expression = true;
+    static constexpr glm::length_t components = E::components;
+    using quantity_type = typename E::quantity_type;
+
+    E operand;
+
+    [[nodiscard]] std::size_t size() const noexcept { return operand.size(); }
+    [[nodiscard]] negate<component_t<E>> component(glm::length_t c) const {
+        return {operand.component(c)};
+    }
+};
+
+template <typename T> struct is_vec_node : std::false_type {};
+template <typename A> struct is_vec_node<vec_ref<A>> : std::true_type {};
+template <typename A> struct is_vec_node<vec_value<A>> : std::true_type {};
+template <typename Q, glm::length_t N>
+struct is_vec_node<vec_broadcast<Q, N>> : std::true_type {};
+template <typename E>
+struct is_vec_node<row_broadcast<E>> : std::true_type {};
+template <typename Op, typename L, typename R>
+struct is_vec_node<vec_binary<Op, L, R>> : std::true_type {};
+template <typename E> struct is_vec_node<vec_negate<E>> : std::true_type {};
+
+// Wrap any vec-level operand into a node: nodes are copied, named arrays
+// referenced, temporaries moved in, single vecs broadcast and scalar-level
+// operands (columns, quantities, scalars) applied to every component.
+template <typename Q, glm::length_t N>
+[[nodiscard]] vec_broadcast<Q, N> broadcast(const vec<Q, N> &v) noexcept {
+    return {v};
+}
+
+template <typename T> [[nodiscard]] auto vec_capture(T &&t) {
+    using D = std::remove_cvref_t<T>;
+    if constexpr (is_vec_node<D>::value) {
+        return D(std::forward<T>(t));
+    } else if constexpr (is_vec<D>::value) {
+        return broadcast(t);
+    } else if constexpr (is_vec_array_v<D>) {
+        if constexpr (std::is_lvalue_reference_v<T>) {
+            return vec_ref<D>{&t};
+        } else {
+            return vec_value<D>{std::move(t)};
+        }
+    } else {
+        return row_broadcast<capture_t<T>>{capture(std::forward<T>(t))};
+    }
+}
+
+template <typename T>
+using vec_capture_t = decltype(vec_capture(std::declval<T>()));
+
+// Non-owning copies of vec nodes, as view() for the scalar-level ones.
+template <typename A>
+[[nodiscard]] vec_ref<A> vec_view(const vec_ref<A> &e) noexcept {
+    return e;
+}
+
+template <typename A>
+[[nodiscard]] vec_ref<A> vec_view(const vec_value<A> &e) noexcept {
+    return {&e.array};
+}
+
+template <typename Q, glm::length_t N>
+[[nodiscard]] vec_broadcast<Q, N>
+vec_view(const vec_broadcast<Q, N> &e) noexcept {
+    return e;
+}
+
+template <typename E>
+[[nodiscard]] auto vec_view(const row_broadcast<E> &e) noexcept
+    -> row_broadcast<decltype(view(e.operand))> {
+    return {view(e.operand)};
+}
+
+template <typename Op, typename L, typename R>
+[[nodiscard]] auto vec_view(const vec_binary<Op, L, R> &e) noexcept
+    -> vec_binary<Op, decltype(vec_view(e.lhs)), decltype(vec_view(e.rhs))> {
+    return {vec_view(e.lhs), vec_view(e.rhs)};
+}
+
+template <typename E>
+[[nodiscard]] auto vec_view(const vec_negate<E> &e) noexcept
+    -> vec_negate<decltype(vec_view(e.operand))> {
+    return {vec_view(e.operand)};
+}
+
+// vec counterpart of borrow(): named arrays and single vecs are captured as
+// usual, nodes viewed so the arrays and columns they own are not copied.
+template <typename T> [[nodiscard]] auto vec_borrow(const T &t) noexcept {
+    if constexpr (is_vec_node<T>::value) {
+        return vec_view(t);
+    } else {
+        return vec_capture(t);
+    }
+}
+
+template <typename Op, typename L, typename R>
+using vec_binary_t = vec_binary<Op, vec_capture_t<L>, vec_capture_t<R>>;
+
+template <typename Op, typename L, typename R>
+[[nodiscard]] vec_binary_t<Op, L, R> make_vec_binary(L &&l, R &&r) {
+    return {vec_capture(std::forward<L>(l)), vec_capture(std::forward<R>(r))};
+}
+
+template <typename L, typename R>
+concept same_components = std::remove_cvref_t<L>::components ==
+                          std::remove_cvref_t<R>::components;
+
+// vec (+, -) vec: both sides are vec expressions or single vecs.
+template <typename L, typename R>
+concept vec_additive =
+    ((is_vec_expression_v<L> && is_vec_expression_v<R> &&
+      same_components<L, R>) ||
+     (is_vec_expression_v<L> && is_vec<std::remove_cvref_t<R>>::value) ||
+     (is_vec<std::remove_cvref_t<L>>::value && is_vec_expression_v<R>));
+
+// vec (*, /) scalar-level operand: columns, quantities or plain scalars.
+template <typename T>
+concept row_operand = is_array_expression_v<T> || is_broadcast_v<T>;
+
+template <typename Op, typename L, typename R>
+concept vec_valid = requires {
+    typename Op::template result<typename vec_capture_t<L>::quantity_type,
+                                 typename vec_capture_t<R>::quantity_type>;
+};
+
+} // namespace expr
+
+// ========== Vector array (+, -) vector array or single vec ==========
+template <typename L, typename R>
+    requires expr::vec_additive<L, R> && expr::vec_valid<expr::plus, L, R>
+[[nodiscard]] auto operator+(L &&l, R &&r)
+    -> expr::vec_binary_t<expr::plus, L, R> {
+    return expr::make_vec_binary<expr::plus>(std::forward<L>(l),
+                                             std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires expr::vec_additive<L, R> && expr::vec_valid<expr::minus, L, R>
+[[nodiscard]] auto operator-(L &&l, R &&r)
+    -> expr::vec_binary_t<expr::minus, L, R> {
+    return expr::make_vec_binary<expr::minus>(std::forward<L>(l),
+                                              std::forward<R>(r));
+}
+
+template <typename E>
+    requires is_vec_expression_v<E>
+[[nodiscard]] auto operator-(E &&e) -> expr::vec_negate<expr::vec_capture_t<E>> {
+    return {expr::vec_capture(std::forward<E>(e))};
+}
+
+// ========== Vector array (*, /) column, quantity or scalar ==========
+// A column operand scales row i of every component by its element i, e.g.
+// vec3_array<force_d> / quantity_array<mass_d> -> acceleration.
+template <typename L, typename R>
+    requires is_vec_expression_v<L> && expr::row_operand<R> &&
+             expr::vec_valid<expr::multiplies, L, R>
+[[nodiscard]] auto operator*(L &&l, R &&r)
+    -> expr::vec_binary_t<expr::multiplies, L, R> {
+    return expr::make_vec_binary<expr::multiplies>(std::forward<L>(l),
+                                                   std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires expr::row_operand<L> && is_vec_expression_v<R> &&
+             expr::vec_valid<expr::multiplies, L, R>
+[[nodiscard]] auto operator*(L &&l, R &&r)
+    -> expr::vec_binary_t<expr::multiplies, L, R> {
+    return expr::make_vec_binary<expr::multiplies>(std::forward<L>(l),
+                                                   std::forward<R>(r));
+}
+
+template <typename L, typename R>
+    requires is_vec_expression_v<L> && expr::row_operand<R> &&
+             expr::vec_valid<expr::divides, L, R>
+[[nodiscard]] auto operator/(L &&l, R &&r)
+    -> expr::vec_binary_t<expr::divides, L, R> {
+    return expr::make_vec_binary<expr::divides>(std::forward<L>(l),
+                                                std::forward<R>(r));
+}
+
+} // namespace physi
@@ -0,0 +1,368 @@
+#pragma once
+
+#include "../core/simd.hpp"
+#include "../vec/quat.hpp"
+#include "quantity_array.hpp"
+#include "vec_array.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+// Batch geometry over vec_array columns: the per-vec length(), normalized(),
+// distance(), dot() and cross() of vec.hpp applied to whole sets at once.
+//
+//   quantity_array<length_f> r = batch::length(positions);
+//   vec3_array<float> dir = batch::normalized(velocities);
+//   vec3_array<torque_f> m(batch::cross(arms, forces));  // length x force
+//   batch::cross(arms, forces, m);                       // reusing m
+//   batch::transform(q, offset, points, points);  // rotate, then translate
+//
+// Each kernel reads the component columns directly and processes 8/16 float
+// (4/8 double) rows per step with AVX2 or AVX-512, chosen at runtime from
+// the CPU, and falls back to a scalar loop elsewhere. Results keep their
+// dimensions: lengths stay lengths and products take the product quantity.
+// The overloads taking an output array reuse its storage; it may hold any
+// quantity of the result's dimension, e.g. torques rather than energies.
+
+namespace physi {
+
+namespace detail {
+
+template <typename Q, glm::length_t N>
+[[nodiscard]] std::array<const scalar_type_t<Q> *, N>
+column_pointers(const vec_array<Q, N> &v) noexcept {
+    std::array<const scalar_type_t<Q> *, N> out;
+    for (glm::length_t c = 0; c < N; ++c) {
+        out[c] = v.component(c).base_data();
+    }
+    return out;
+}
+
+template <typename Q, glm::length_t N>
+[[nodiscard]] std::array<scalar_type_t<Q> *, N>
+column_pointers(vec_array<Q, N> &v) noexcept {
+    std::array<scalar_type_t<Q> *, N> out;
+    for (glm::length_t c = 0; c < N; ++c) {
+        out[c] = v.component(c).base_data();
+    }
+    return out;
+}
+
+// Squared norm of row i (one pack of rows).
+template <typename P, std::size_t N, typename T>
+[[nodiscard]] PHYSI_FORCE_INLINE P
+norm_squared_at(std::size_t i, const std::array<const T *, N> &v) noexcept {
+    P s = P::load(v[0] + i) * P::load(v[0] + i);
+    for (std::size_t c = 1; c < N; ++c) {
+        const P x = P::load(v[c] + i);
+        s = s + x * x;
+    }
+    return s;
+}
+
+template <glm::length_t N> struct norm_op {
+    template <typename P, typename T>
+    PHYSI_FORCE_INLINE static void
+    apply(std::size_t i, const std::array<const T *, N> &v,
+          T *const &out) noexcept {
+        sqrt(norm_squared_at<P>(i, v)).store(out + i);
+    }
+};
+
+template <glm::length_t N> struct normalize_op {
+    template <typename P, typename T>
+    PHYSI_FORCE_INLINE static void
+    apply(std::size_t i, const std::array<const T *, N> &v,
+          const std::array<T *, N> &out) noexcept {
+        const P inv = P::broadcast(T(1)) / sqrt(norm_squared_at<P>(i, v));
+        std::array<P, N> x;
+        for (glm::length_t c = 0; c < N; ++c) {
+            x[c] = P::load(v[c] + i);
+        }
+        for (glm::length_t c = 0; c < N; ++c) {
+            (x[c] * inv).store(out[c] + i);
+        }
+    }
+};
+
+template <glm::length_t N> struct distance_op {
+    template <typename P, typename T>
+    PHYSI_FORCE_INLINE static void
+    apply(std::size_t i, const std::array<const T *, N> &a,
+          const std::array<const T *, N> &b, T *const &out) noexcept {
+        P d = P::load(a[0] + i) - P::load(b[0] + i);
+        P s = d * d;
+        for (glm::length_t c = 1; c < N; ++c) {
+            d = P::load(a[c] + i) - P::load(b[c] + i);
+            s = s + d * d;
+        }
+        sqrt(s).store(out + i);
+    }
+};
+
+template <glm::length_t N> struct dot_op {
+    template <typename P, typename T>
+    PHYSI_FORCE_INLINE static void
+    apply(std::size_t i, const std::array<const T *, N> &a,
+          const std::array<const T *, N> &b, T *const &out) noexcept {
+        P s = P::load(a[0] + i) * P::load(b[0] + i);
+        for (glm::length_t c = 1; c < N; ++c) {
+            s = s + P::load(a[c] + i) * P::load(b[c] + i);
+        }
+        s.store(out + i);
+    }
+};
+
+struct cross_op {
+    template <typename P, typename T>
+    PHYSI_FORCE_INLINE static void
+    apply(std::size_t i, const std::array<const T *, 3> &a,
+          const std::array<const T *, 3> &b,
+          const std::array<T *, 3> &out) noexcept {
+        const P ax = P::load(a[0] + i), ay = P::load(a[1] + i),
+                az = P::load(a[2] + i);
+        const P bx = P::load(b[0] + i), by = P::load(b[1] + i),
+                bz = P::load(b[2] + i);
+        (ay * bz - az * by).store(out[0] + i);
+        (az * bx - ax * bz).store(out[1] + i);
+        (ax * by - ay * bx).store(out[2] + i);
+    }
+};
+
+// out = m * v + t with m a row-major 3x4 matrix (rotation | translation).
+// Every column is loaded before any is stored, so out may alias v.
+struct affine_op {
+    template <typename P, typename T>
+    PHYSI_FORCE_INLINE static void
+    apply(std::size_t i, const std::array<const T *, 3> &v,
+          const std::array<T, 12> &m,
+          const std::array<T *, 3> &out) noexcept {
+        const P x = P::load(v[0] + i), y = P::load(v[1] + i),
+                z = P::load(v[2] + i);
+        for (std::size_t r = 0; r < 3; ++r) {
+            const T *row = m.data() + 4 * r;
+            (P::broadcast(row[0]) * x + P::broadcast(row[1]) * y +
+             P::broadcast(row[2]) * z + P::broadcast(row[3]))
+                .store(out[r] + i);
+        }
+    }
+};
+
+// Output rows of a kernel whose result is P: P itself, or another quantity
+// of its dimension and scalar type.
+template <typename R, typename P>
+concept batch_output =
+    std::is_same_v<R, P> ||
+    (same_dimension_as<R, P> &&
+     std::is_same_v<scalar_type_t<R>, scalar_type_t<P>>);
+
+template <typename S>
+[[nodiscard]] std::array<scalar_type_t<S>, 12>
+affine_rows(const mat<S, 3, 3> &m,
+            const glm::vec<3, scalar_type_t<S>> &t) noexcept {
+    std::array<scalar_type_t<S>, 12> out;
+    for (glm::length_t r = 0; r < 3; ++r) {
+        for (glm::length_t c = 0; c < 3; ++c) {
+            out[4 * r + c] = m.data[c][r];
+        }
+        out[4 * r + 3] = t[r];
+    }
+    return out;
+}
+
+} // namespace detail
+
+namespace batch {
+
+// ========== Length ==========
+template <typename Q, glm::length_t N>
+void length(const vec_array<Q, N> &v, quantity_array<Q> &out) {
+    using T = scalar_type_t<Q>;
+    out.resize(v.size());
+    detail::simd_for<detail::norm_op<N>, T>(
+        v.size(), detail::column_pointers(v), out.base_data());
+}
+
+template <typename Q, glm::length_t N>
+[[nodiscard]] quantity_array<Q> length(const vec_array<Q, N> &v) {
+    quantity_array<Q> out;
+    length(v, out);
+    return out;
+}
+
+// ========== Normalization (unitless directions) ==========
+// Zero-length rows give NaN components, as for vec::normalized().
+template <typename Q, glm::length_t N>
+void normalized(const vec_array<Q, N> &v,
+                vec_array<scalar_type_t<Q>, N> &out) {
+    using T = scalar_type_t<Q>;
+    out.resize(v.size());
+    detail::simd_for<detail::normalize_op<N>, T>(
+        v.size(), detail::column_pointers(v), detail::column_pointers(out));
+}
+
+template <typename Q, glm::length_t N>
+[[nodiscard]] vec_array<scalar_type_t<Q>, N>
+normalized(const vec_array<Q, N> &v) {
+    vec_array<scalar_type_t<Q>, N> out;
+    normalized(v, out);
+    return out;
+}
+
+// ========== Distance between matching rows ==========
+template <typename Q, glm::length_t N>
+void distance(const vec_array<Q, N> &a, const vec_array<Q, N> &b,
+              quantity_array<Q> &out) {
+    using T = scalar_type_t<Q>;
+    assert(a.size() == b.size() && "distance size mismatch");
+    out.resize(a.size());
+    detail::simd_for<detail::distance_op<N>, T>(
+        a.size(), detail::column_pointers(a), detail::column_pointers(b),
+        out.base_data());
+}
+
+template <typename Q, glm::length_t N>
+[[nodiscard]] quantity_array<Q> distance(const vec_array<Q, N> &a,
+                                         const vec_array<Q, N> &b) {
+    quantity_array<Q> out;
+    distance(a, b, out);
+    return out;
+}
+
+// ========== Dot product of matching rows ==========
+// e.g. forces and velocities give a power per row.
+template <typename A, typename B, glm::length_t N, typename R>
+    requires std::is_same_v<scalar_type_t<A>, scalar_type_t<B>> &&
+             detail::batch_output<R, product_t<A, B>>
+void dot(const vec_array<A, N> &a, const vec_array<B, N> &b,
+         quantity_array<R> &out) {
+    using T = scalar_type_t<A>;
+    assert(a.size() == b.size() && "dot size mismatch");
+    out.resize(a.size());
+    detail::simd_for<detail::dot_op<N>, T>(a.size(), detail::column_pointers(a),
+                                          detail::column_pointers(b),
+                                          out.base_data());
+}
+
+template <typename A, typename B, glm::length_t N>
+    requires std::is_same_v<scalar_type_t<A>, scalar_type_t<B>>
+[[nodiscard]] quantity_array<product_t<A, B>> dot(const vec_array<A, N> &a,
+                                                  const vec_array<B, N> &b) {
+    quantity_array<product_t<A, B>> out;
+    dot(a, b, out);
+    return out;
+}
+
+// ========== Cross product of matching rows (3D) ==========
+// e.g. lever arms and forces give moments (force * length).
+template <typename A, typename B, typename R>
+    requires std::is_same_v<scalar_type_t<A>, scalar_type_t<B>> &&
+             detail::batch_output<R, product_t<A, B>>
+void cross(const vec_array<A, 3> &a, const vec_array<B, 3> &b,
+           vec_array<R, 3> &out) {
+    using T = scalar_type_t<A>;
+    assert(a.size() == b.size() && "cross size mismatch");
+    out.resize(a.size());
+    detail::simd_for<detail::cross_op, T>(
+        a.size(), detail::column_pointers(a), detail::column_pointers(b),
+        detail::column_pointers(out));
+}
+
+template <typename A, typename B>
+    requires std::is_same_v<scalar_type_t<A>, scalar_type_t<B>>
+[[nodiscard]] vec_array<product_t<A, B>, 3> cross(const vec_array<A, 3> &a,
+                                                  const vec_array<B, 3> &b) {
+    vec_array<product_t<A, B>, 3> out;
+    cross(a, b, out);
+    return out;
+}
+
+// ========== Linear and rigid transforms ==========
+// One matrix or rotation applied to every row: out = m * v, or m * v + t
+// with a translation. A dimensionless matrix (or a quat) keeps the quantity,
+// so positions stay lengths; a dimensioned one multiplies, e.g. an inertia
+// tensor over angular velocities gives angular momenta. out may be v itself
+// when the quantities match, transforming in place.
+template <typename S, typename Q, typename R>
+    requires std::is_same_v<scalar_type_t<S>, scalar_type_t<Q>> &&
+             detail::batch_output<R, product_t<S, Q>>
+void transform(const mat<S, 3, 3> &m, const vec_array<Q, 3> &v,
+               vec_array<R, 3> &out) {
+    using T = scalar_type_t<Q>;
+    out.resize(v.size());
+    detail::simd_for<detail::affine_op, T>(
+        v.size(), detail::column_pointers(v),
+        detail::affine_rows(m, glm::vec<3, T>(T(0))),
+        detail::column_pointers(out));
+}
+
+template <typename S, typename Q, typename R>
+    requires std::is_same_v<scalar_type_t<S>, scalar_type_t<Q>> &&
+             is_quantity_v<product_t<S, Q>> &&
+             detail::batch_output<R, product_t<S, Q>>
+void transform(const mat<S, 3, 3> &m, const vec3<product_t<S, Q>> &t,
+               const vec_array<Q, 3> &v, vec_array<R, 3> &out) {
+    using T = scalar_type_t<Q>;
+    out.resize(v.size());
+    detail::simd_for<detail::affine_op, T>(
+        v.size(), detail::column_pointers(v), detail::affine_rows(m, t.data),
+        detail::column_pointers(out));
+}
+
+template <typename S, typename Q>
+    requires std::is_same_v<scalar_type_t<S>, scalar_type_t<Q>>
+[[nodiscard]] vec_array<product_t<S, Q>, 3>
+transform(const mat<S, 3, 3> &m, const vec_array<Q, 3> &v) {
+    vec_array<product_t<S, Q>, 3> out;
+    transform(m, v, out);
+    return out;
+}
+
+template <typename S, typename Q>
+    requires std::is_same_v<scalar_type_t<S>, scalar_type_t<Q>> &&
+             is_quantity_v<product_t<S, Q>>
+[[nodiscard]] vec_array<product_t<S, Q>, 3>
+transform(const mat<S, 3, 3> &m, const vec3<product_t<S, Q>> &t,
+          const vec_array<Q, 3> &v) {
+    vec_array<product_t<S, Q>, 3> out;
+    transform(m, t, v, out);
+    return out;
+}
+
+// Quaternions are expanded to their matrix once, outside the loop.
+template <typename Q>
+void transform(const quat<scalar_type_t<Q>> &q, const vec_array<Q, 3> &v,
+               vec_array<Q, 3> &out) {
+    transform(q.to_matrix(), v, out);
+}
+
+template <typename Q>
+    requires is_quantity_v<Q>
+void transform(const quat<scalar_type_t<Q>> &q, const vec3<Q> &t,
+               const vec_array<Q, 3> &v, vec_array<Q, 3> &out) {
+    transform(q.to_matrix(), t, v, out);
+}
+
+template <typename Q>
+[[nodiscard]] vec_array<Q, 3> transform(const quat<scalar_type_t<Q>> &q,
+                                        const vec_array<Q, 3> &v) {
+    vec_array<Q, 3> out;
+    transform(q.to_matrix(), v, out);
+    return out;
+}
+
+template <typename Q>
+    requires is_quantity_v<Q>
+[[nodiscard]] vec_array<Q, 3> transform(const quat<scalar_type_t<Q>> &q,
+                                        const vec3<Q> &t,
+                                        const vec_array<Q, 3> &v) {
+    vec_array<Q, 3> out;
+    transform(q.to_matrix(), t, v, out);
+    return out;
+}
+
+} // namespace batch
+
+} // namespace physi
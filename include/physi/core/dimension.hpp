@@ -0,0 +1,127 @@
+#pragma once
+
+#include <type_traits>
+
+// Register the dimension of a named quantity as SI base exponents
+// (length, mass, time, current, temperature, amount, luminous intensity):
+//   PHYSI_DIMENSION(force, 1, 1, -2, 0, 0, 0, 0)   // L M T^-2
+// This lets every product/quotient deduce its result type and maps the
+// result back to `force` wherever the dimension L M T^-2 appears.
+#define PHYSI_DIMENSION(Name, L, M, T, I, Th, N, J)                            \
+    template <> struct quantity_dimension<Name> {                              \
+        using type = ::physi::dimension<L, M, T, I, Th, N, J>;                 \
+    };                                                                         \
+    template <>                                                                \
+    struct named_quantity<::physi::dimension<L, M, T, I, Th, N, J>> {          \
+        template <typename U> using type = Name<U>;                            \
+    };
+
+// Register the dimension of a quantity that shares it with another named
+// one (torque with energy). Products never produce it, and it converts to
+// and from the other quantity, or an unnamed product, explicitly only.
+#define PHYSI_DIMENSION_SHARED(Name, L, M, T, I, Th, N, J)                     \
+    template <> struct quantity_dimension<Name> {                              \
+        using type = ::physi::dimension<L, M, T, I, Th, N, J>;                 \
+    };
+
+namespace physi {
+
+// Compile-time exponent vector over the seven SI base dimensions.
+template <int L, int M, int T, int I, int Th, int N, int J> struct dimension {
+    static constexpr int length = L;
+    static constexpr int mass = M;
+    static constexpr int time = T;
+    static constexpr int current = I;
+    static constexpr int temperature = Th;
+    static constexpr int amount = N;
+    static constexpr int luminous_intensity = J;
+};
+
+using dimensionless = dimension<0, 0, 0, 0, 0, 0, 0>;
+
+namespace detail {
+
+template <typename A, typename B> struct dimension_product;
+template <typename A, typename B> struct dimension_quotient;
+
+template <int L1, int M1, int T1, int I1, int Th1, int N1, int J1, int L2,
+          int M2, int T2, int I2, int Th2, int N2, int J2>
+struct dimension_product<dimension<L1, M1, T1, I1, Th1, N1, J1>,
+                         dimension<L2, M2, T2, I2, Th2, N2, J2>> {
+    using type = dimension<L1 + L2, M1 + M2, T1 + T2, I1 + I2, Th1 + Th2,
+                           N1 + N2, J1 + J2>;
+};
+
+template <int L1, int M1, int T1, int I1, int Th1, int N1, int J1, int L2,
+          int M2, int T2, int I2, int Th2, int N2, int J2>
+struct dimension_quotient<dimension<L1, M1, T1, I1, Th1, N1, J1>,
+                          dimension<L2, M2, T2, I2, Th2, N2, J2>> {
+    using type = dimension<L1 - L2, M1 - M2, T1 - T2, I1 - I2, Th1 - Th2,
+                           N1 - N2, J1 - J2>;
+};
+
+} // namespace detail
+
+template <typename A, typename B>
+using dimension_product_t = typename detail::dimension_product<A, B>::type;
+
+template <typename A, typename B>
+using dimension_quotient_t = typename detail::dimension_quotient<A, B>::type;
+
+// Dimension of a quantity template (length, force, ...). Explicitly
+// specialized by PHYSI_DIMENSION; quantities that carry a `dimension_type`
+// member (the unnamed results of products/quotients) report that.
+template <template <typename> class Q>
+concept carries_dimension = requires { typename Q<double>::dimension_type; };
+
+template <template <typename> class Q> struct quantity_dimension {};
+
+template <template <typename> class Q>
+    requires carries_dimension<Q>
+struct quantity_dimension<Q> {
+    using type = typename Q<double>::dimension_type;
+};
+
+template <template <typename> class Q>
+using quantity_dimension_t = typename quantity_dimension<Q>::type;
+
+template <template <typename> class Q>
+concept has_dimension = requires { typename quantity_dimension<Q>::type; };
+
+template <template <typename> class A, template <typename> class B>
+concept same_dimension =
+    has_dimension<A> && has_dimension<B> &&
+    std::is_same_v<quantity_dimension_t<A>, quantity_dimension_t<B>>;
+
+// Reverse mapping: the named quantity template registered for a dimension.
+template <typename Dim> struct named_quantity {};
+
+template <typename Dim, typename T>
+using named_quantity_t = typename named_quantity<Dim>::template type<T>;
+
+// True when Q has a registered dimension that maps back to Q itself.
+template <template <typename> class Q>
+concept registered_quantity =
+    has_dimension<Q> &&
+    requires { typename named_quantity_t<quantity_dimension_t<Q>, double>; } &&
+    std::is_same_v<named_quantity_t<quantity_dimension_t<Q>, double>,
+                   Q<double>>;
+
+// Dimension of a concrete quantity type, e.g. dimension_of_t<energy_f>.
+template <typename Q> struct dimension_of {};
+
+template <template <typename> class Q, typename T>
+struct dimension_of<Q<T>> : quantity_dimension<Q> {};
+
+template <typename Q>
+using dimension_of_t = typename dimension_of<std::remove_cv_t<Q>>::type;
+
+// Concrete quantity types of one dimension, e.g. energy_f and torque_f.
+template <typename A, typename B>
+concept same_dimension_as =
+    requires {
+        typename dimension_of_t<A>;
+        typename dimension_of_t<B>;
+    } && std::is_same_v<dimension_of_t<A>, dimension_of_t<B>>;
+
+} // namespace physi
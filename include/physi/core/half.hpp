@@ -0,0 +1,304 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// 16-bit floating-point storage types for quantities that only need ~3
+// significant digits (archived temperatures, pressures, densities):
+//
+//   quantity_array<pressure_h> p(n);     // half the bytes of pressure_f
+//   auto mean = p[0] + p[1];             // arithmetic runs in float
+//
+// Both are portable software types: they convert implicitly to and from
+// float and have no arithmetic of their own, so every operation promotes to
+// float. Bulk span conversions (to_float / from_float) live in
+// half_convert.hpp.
+
+namespace physi {
+
+namespace detail {
+
+// float -> IEEE binary16, round to nearest even.
+[[nodiscard]] constexpr std::uint16_t float_to_half_bits(float f) noexcept {
+    const auto x = std::bit_cast<std::uint32_t>(f);
+    const std::uint32_t sign = (x >> 16) & 0x8000u;
+    const std::uint32_t abs = x & 0x7fffffffu;
+    if (abs >= 0x7f800000u) { // inf / nan (keep nan quiet)
+        return static_cast<std::uint16_t>(
+            sign | 0x7c00u | (abs > 0x7f800000u ? 0x200u : 0u));
+    }
+    if (abs >= 0x477ff000u) { // rounds past the largest finite half
+        return static_cast<std::uint16_t>(sign | 0x7c00u);
+    }
+    if (abs < 0x38800000u) { // subnormal half (or zero)
+        const auto shift = 126u - (abs >> 23);
+        if (shift > 24u) {
+            return static_cast<std::uint16_t>(sign);
+        }
+        const std::uint32_t mant = (abs & 0x7fffffu) | 0x800000u;
+        const std::uint32_t half = mant >> shift;
+        const std::uint32_t rest = mant & ((1u << shift) - 1u);
+        const std::uint32_t mid = 1u << (shift - 1u);
+        const std::uint32_t up =
+            rest > mid || (rest == mid && (half & 1u)) ? 1u : 0u;
+        return static_cast<std::uint16_t>(sign | (half + up));
+    }
+    const std::uint32_t rebiased = abs - 0x38000000u; // 127 - 15 exponent
+    const std::uint32_t rest = rebiased & 0x1fffu;
+    std::uint32_t half = rebiased >> 13;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) {
+        ++half;
+    }
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+[[nodiscard]] constexpr float half_bits_to_float(std::uint16_t h) noexcept {
+    const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000u) << 16;
+    const std::uint32_t exp = (h >> 10) & 0x1fu;
+    std::uint32_t mant = h & 0x3ffu;
+    if (exp == 0x1fu) {
+        return std::bit_cast<float>(sign | 0x7f800000u | (mant << 13));
+    }
+    if (exp == 0) {
+        if (mant == 0) {
+            return std::bit_cast<float>(sign);
+        }
+        // normalize the subnormal
+        std::uint32_t e = 113;
+        while ((mant & 0x400u) == 0) {
+            mant <<= 1;
+            --e;
+        }
+        return std::bit_cast<float>(sign | (e << 23) | ((mant & 0x3ffu) << 13));
+    }
+    return std::bit_cast<float>(sign | ((exp + 112u) << 23) | (mant << 13));
+}
+
+// float -> bfloat16 (the upper half of a float), round to nearest even.
+[[nodiscard]] constexpr std::uint16_t float_to_bf16_bits(float f) noexcept {
+    const auto x = std::bit_cast<std::uint32_t>(f);
+    if ((x & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<std::uint16_t>((x >> 16) | 0x40u); // quiet nan
+    }
+    return static_cast<std::uint16_t>((x + 0x7fffu + ((x >> 16) & 1u)) >> 16);
+}
+
+[[nodiscard]] constexpr float bf16_bits_to_float(std::uint16_t b) noexcept {
+    return std::bit_cast<float>(static_cast<std::uint32_t>(b) << 16);
+}
+
+} // namespace detail
+
+// IEEE 754 binary16: 11-bit significand, range about 6e-8 to 65504.
+struct half {
+    std::uint16_t bits = 0;
+
+    constexpr half() noexcept = default;
+    constexpr half(float f) noexcept : bits(detail::float_to_half_bits(f)) {}
+
+    constexpr operator float() const noexcept {
+        return detail::half_bits_to_float(bits);
+    }
+
+    // Compound assignment rounds the float result back into 16 bits.
+    constexpr half &operator+=(float f) noexcept {
+        return *this = half(float(*this) + f);
+    }
+    constexpr half &operator-=(float f) noexcept {
+        return *this = half(float(*this) - f);
+    }
+    constexpr half &operator*=(float f) noexcept {
+        return *this = half(float(*this) * f);
+    }
+    constexpr half &operator/=(float f) noexcept {
+        return *this = half(float(*this) / f);
+    }
+
+    [[nodiscard]] static constexpr half from_bits(std::uint16_t b) noexcept {
+        half h;
+        h.bits = b;
+        return h;
+    }
+};
+
+// bfloat16: float's 8-bit exponent with an 8-bit significand, so it covers
+// the full float range at lower precision.
+struct bfloat16 {
+    std::uint16_t bits = 0;
+
+    constexpr bfloat16() noexcept = default;
+    constexpr bfloat16(float f) noexcept
+        : bits(detail::float_to_bf16_bits(f)) {}
+
+    constexpr operator float() const noexcept {
+        return detail::bf16_bits_to_float(bits);
+    }
+
+    // Compound assignment rounds the float result back into 16 bits.
+    constexpr bfloat16 &operator+=(float f) noexcept {
+        return *this = bfloat16(float(*this) + f);
+    }
+    constexpr bfloat16 &operator-=(float f) noexcept {
+        return *this = bfloat16(float(*this) - f);
+    }
+    constexpr bfloat16 &operator*=(float f) noexcept {
+        return *this = bfloat16(float(*this) * f);
+    }
+    constexpr bfloat16 &operator/=(float f) noexcept {
+        return *this = bfloat16(float(*this) / f);
+    }
+
+    [[nodiscard]] static constexpr bfloat16
+    from_bits(std::uint16_t b) noexcept {
+        bfloat16 h;
+        h.bits = b;
+        return h;
+    }
+};
+
+static_assert(sizeof(half) == 2 && sizeof(bfloat16) == 2);
+
+template <typename T>
+inline constexpr bool is_half_float_v =
+    std::is_same_v<T, half> || std::is_same_v<T, bfloat16>;
+
+} // namespace physi
+
+// Every operation on the 16-bit types happens in float.
+template <> struct std::common_type<physi::half, physi::half> {
+    using type = float;
+};
+template <> struct std::common_type<physi::bfloat16, physi::bfloat16> {
+    using type = float;
+};
+template <> struct std::common_type<physi::half, physi::bfloat16> {
+    using type = float;
+};
+template <> struct std::common_type<physi::bfloat16, physi::half> {
+    using type = float;
+};
+
+template <typename T>
+    requires std::is_arithmetic_v<T>
+struct std::common_type<physi::half, T> : std::common_type<float, T> {};
+template <typename T>
+    requires std::is_arithmetic_v<T>
+struct std::common_type<T, physi::half> : std::common_type<T, float> {};
+template <typename T>
+    requires std::is_arithmetic_v<T>
+struct std::common_type<physi::bfloat16, T> : std::common_type<float, T> {};
+template <typename T>
+    requires std::is_arithmetic_v<T>
+struct std::common_type<T, physi::bfloat16> : std::common_type<T, float> {};
+
+template <> class std::numeric_limits<physi::half> {
+  public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr float_denorm_style has_denorm = denorm_present;
+    static constexpr bool has_denorm_loss = false;
+    static constexpr float_round_style round_style = round_to_nearest;
+    static constexpr bool is_iec559 = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr int digits = 11;
+    static constexpr int digits10 = 3;
+    static constexpr int max_digits10 = 5;
+    static constexpr int radix = 2;
+    static constexpr int min_exponent = -13;
+    static constexpr int min_exponent10 = -4;
+    static constexpr int max_exponent = 16;
+    static constexpr int max_exponent10 = 4;
+    static constexpr bool traps = false;
+    static constexpr bool tinyness_before = false;
+
+    static constexpr physi::half min() noexcept {
+        return physi::half::from_bits(0x0400);
+    }
+    static constexpr physi::half lowest() noexcept {
+        return physi::half::from_bits(0xfbff);
+    }
+    static constexpr physi::half max() noexcept {
+        return physi::half::from_bits(0x7bff);
+    }
+    static constexpr physi::half epsilon() noexcept {
+        return physi::half::from_bits(0x1400);
+    }
+    static constexpr physi::half round_error() noexcept {
+        return physi::half::from_bits(0x3800);
+    }
+    static constexpr physi::half infinity() noexcept {
+        return physi::half::from_bits(0x7c00);
+    }
+    static constexpr physi::half quiet_NaN() noexcept {
+        return physi::half::from_bits(0x7e00);
+    }
+    static constexpr physi::half signaling_NaN() noexcept {
+        return physi::half::from_bits(0x7d00);
+    }
+    static constexpr physi::half denorm_min() noexcept {
+        return physi::half::from_bits(0x0001);
+    }
+};
+
+template <> class std::numeric_limits<physi::bfloat16> {
+  public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr float_denorm_style has_denorm = denorm_present;
+    static constexpr bool has_denorm_loss = false;
+    static constexpr float_round_style round_style = round_to_nearest;
+    static constexpr bool is_iec559 = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr int digits = 8;
+    static constexpr int digits10 = 2;
+    static constexpr int max_digits10 = 4;
+    static constexpr int radix = 2;
+    static constexpr int min_exponent = -125;
+    static constexpr int min_exponent10 = -37;
+    static constexpr int max_exponent = 128;
+    static constexpr int max_exponent10 = 38;
+    static constexpr bool traps = false;
+    static constexpr bool tinyness_before = false;
+
+    static constexpr physi::bfloat16 min() noexcept {
+        return physi::bfloat16::from_bits(0x0080);
+    }
+    static constexpr physi::bfloat16 lowest() noexcept {
+        return physi::bfloat16::from_bits(0xff7f);
+    }
+    static constexpr physi::bfloat16 max() noexcept {
+        return physi::bfloat16::from_bits(0x7f7f);
+    }
+    static constexpr physi::bfloat16 epsilon() noexcept {
+        return physi::bfloat16::from_bits(0x3c00);
+    }
+    static constexpr physi::bfloat16 round_error() noexcept {
+        return physi::bfloat16::from_bits(0x3f00);
+    }
+    static constexpr physi::bfloat16 infinity() noexcept {
+        return physi::bfloat16::from_bits(0x7f80);
+    }
+    static constexpr physi::bfloat16 quiet_NaN() noexcept {
+        return physi::bfloat16::from_bits(0x7fc0);
+    }
+    static constexpr physi::bfloat16 signaling_NaN() noexcept {
+        return physi::bfloat16::from_bits(0x7fa0);
+    }
+    static constexpr physi::bfloat16 denorm_min() noexcept {
+        return physi::bfloat16::from_bits(0x0001);
+    }
+};
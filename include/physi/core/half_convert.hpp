@@ -0,0 +1,107 @@
+#pragma once
+
+#include "half.hpp"
+
+#include <cstddef>
+#include <span>
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PHYSI_HAS_F16C_DISPATCH 1
+#else
+#define PHYSI_HAS_F16C_DISPATCH 0
+#endif
+
+// Bulk conversion of half / bfloat16 spans to and from float:
+//
+//   from_float(samples, packed);   // std::span<float> -> std::span<half>
+//   to_float(packed, samples);
+//
+// half uses F16C on x86 CPUs that have it, selected at runtime. Kept apart
+// from half.hpp so the quantity headers do not parse <immintrin.h>.
+
+namespace physi {
+
+// ========== Bulk conversion ==========
+
+namespace detail {
+
+#if PHYSI_HAS_F16C_DISPATCH
+[[gnu::target("f16c,avx")]] inline void
+half_to_float_f16c(const half *in, float *out, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+    }
+    for (; i < n; ++i) {
+        out[i] = in[i];
+    }
+}
+
+[[gnu::target("f16c,avx")]] inline void
+float_to_half_f16c(const float *in, half *out, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i),
+                                          _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), h);
+    }
+    for (; i < n; ++i) {
+        out[i] = in[i];
+    }
+}
+
+[[nodiscard]] inline bool has_f16c() noexcept {
+    static const bool supported = __builtin_cpu_supports("f16c") &&
+                                  __builtin_cpu_supports("avx");
+    return supported;
+}
+#endif
+
+} // namespace detail
+
+// out[i] = float(in[i]); F16C when the CPU has it.
+inline void to_float(std::span<const half> in, std::span<float> out) noexcept {
+#if PHYSI_HAS_F16C_DISPATCH
+    if (detail::has_f16c()) {
+        detail::half_to_float_f16c(in.data(), out.data(), in.size());
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = in[i];
+    }
+}
+
+inline void from_float(std::span<const float> in,
+                       std::span<half> out) noexcept {
+#if PHYSI_HAS_F16C_DISPATCH
+    if (detail::has_f16c()) {
+        detail::float_to_half_f16c(in.data(), out.data(), in.size());
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = in[i];
+    }
+}
+
+// bfloat16 is a shift either way, which vectorizes as is.
+inline void to_float(std::span<const bfloat16> in,
+                     std::span<float> out) noexcept {
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = detail::bf16_bits_to_float(in[i].bits);
+    }
+}
+
+inline void from_float(std::span<const float> in,
+                       std::span<bfloat16> out) noexcept {
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i].bits = detail::float_to_bf16_bits(in[i]);
+    }
+}
+
+} // namespace physi
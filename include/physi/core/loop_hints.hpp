@@ -0,0 +1,24 @@
+#pragma once
+
+// Compiler hints shared by the element-wise kernels. Kept free of includes
+// so the unit tables in unit.hpp can use them without pulling in simd.hpp.
+
+// Forces inlining where a kernel must be compiled as part of its caller (see
+// simd_for in simd.hpp).
+#if defined(__GNUC__) || defined(__clang__)
+#define PHYSI_FORCE_INLINE [[gnu::always_inline]] inline
+#else
+#define PHYSI_FORCE_INLINE inline
+#endif
+
+// Loop hint for element-wise kernels: tells the compiler that iterations are
+// independent so it vectorizes without emitting runtime alias checks.
+#if defined(__clang__)
+#define PHYSI_IVDEP _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+#define PHYSI_IVDEP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define PHYSI_IVDEP __pragma(loop(ivdep))
+#else
+#define PHYSI_IVDEP
+#endif
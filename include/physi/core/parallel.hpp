@@ -0,0 +1,70 @@
+#pragma once
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace physi {
+
+// Runs f(begin, end) over [0, n) split into at most `threads` contiguous
+// chunks (0 = one per hardware thread) on the shared thread_pool, with the
+// calling thread taking part. The chunk bounds depend only on n and
+// `threads`. The first exception thrown by any chunk is rethrown after all
+// of them have finished.
+template <typename F>
+void parallel_for(std::size_t n, F &&f, std::size_t threads = 0) {
+    if (threads == 0) {
+        threads = default_thread_count();
+    }
+    threads = std::min(threads, n);
+    if (threads <= 1) {
+        if (n > 0) {
+            f(std::size_t{0}, n);
+        }
+        return;
+    }
+    thread_pool::shared().run(threads, [&](std::size_t chunk) {
+        f(n * chunk / threads, n * (chunk + 1) / threads);
+    });
+}
+
+namespace detail {
+
+// Sorts keys with up to `threads` threads: chunks are sorted in parallel,
+// then neighbouring runs are merged pairwise.
+template <typename K>
+void parallel_sort(std::vector<K> &keys, std::size_t threads) {
+    const std::size_t n = keys.size();
+    const std::size_t chunks = std::max<std::size_t>(1, std::min(threads, n));
+    const auto bound = [&](std::size_t c) { return n * c / chunks; };
+    parallel_for(
+        chunks,
+        [&](std::size_t first, std::size_t last) {
+            for (std::size_t c = first; c < last; ++c) {
+                std::sort(keys.begin() + bound(c), keys.begin() + bound(c + 1));
+            }
+        },
+        chunks);
+    for (std::size_t width = 1; width < chunks; width *= 2) {
+        const std::size_t merges = (chunks + 2 * width - 1) / (2 * width);
+        parallel_for(
+            merges,
+            [&](std::size_t first, std::size_t last) {
+                for (std::size_t k = first; k < last; ++k) {
+                    const std::size_t lo = 2 * width * k;
+                    const std::size_t mid = std::min(lo + width, chunks);
+                    const std::size_t hi = std::min(lo + 2 * width, chunks);
+                    std::inplace_merge(keys.begin() + bound(lo),
+                                       keys.begin() + bound(mid),
+                                       keys.begin() + bound(hi));
+                }
+            },
+            merges);
+    }
+}
+
+} // namespace detail
+
+} // namespace physi
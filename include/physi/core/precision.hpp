@@ -0,0 +1,232 @@
+#pragma once
+
+#include "half.hpp"
+
+#include <concepts>
+#include <string_view>
+#include <type_traits>
+
+// Precision policy of the quantity arithmetic, chosen per build:
+//
+//   -DPHYSI_STRICT_PRECISION   length_f + length_d, length_f * 0.5 and
+//                              length_f x = length_ld(...) do not compile;
+//                              precision_cast<float>(x) says it on purpose.
+//   -DPHYSI_COUNT_PROMOTIONS   (without strict) every mixed-precision
+//                              operation is counted per source line; see
+//                              promotion_counts().
+//
+// By default operands of different precision meet in their std::common_type
+// and a quantity converts implicitly to any other scalar, which is
+// convenient but lets one double or long double operand widen a whole float
+// kernel without a trace. Both macros change the operators' declarations,
+// so every translation unit of a program must agree on them.
+
+#if defined(PHYSI_COUNT_PROMOTIONS) && !defined(PHYSI_STRICT_PRECISION)
+#define PHYSI_HAS_PROMOTION_COUNTS 1
+#else
+#define PHYSI_HAS_PROMOTION_COUNTS 0
+#endif
+
+#if PHYSI_HAS_PROMOTION_COUNTS
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <source_location>
+#include <unordered_map>
+#include <vector>
+#endif
+
+namespace physi {
+
+#ifdef PHYSI_STRICT_PRECISION
+inline constexpr bool strict_precision = true;
+#else
+inline constexpr bool strict_precision = false;
+#endif
+
+namespace detail {
+
+// Integers < 16-bit floats < float < double < long double. half and
+// bfloat16 share a rank: neither holds every value of the other.
+template <typename T>
+inline constexpr int precision_rank = std::is_integral_v<T>      ? 0
+                                      : is_half_float_v<T>        ? 1
+                                      : std::is_same_v<T, float>  ? 2
+                                      : std::is_same_v<T, double> ? 3
+                                                                  : 4;
+
+} // namespace detail
+
+// Whether a From value converts to To without losing precision. Integers
+// count as exact in every floating type, as they do in the scalar operators.
+template <typename From, typename To>
+inline constexpr bool is_widening_v =
+    std::is_same_v<From, To> ||
+    detail::precision_rank<From> < detail::precision_rank<To>;
+
+// Conversions the quantity constructors and compound assignments perform
+// implicitly: all of them by default, only the widening ones when strict.
+template <typename From, typename To>
+concept implicitly_convertible_precision =
+    !strict_precision || is_widening_v<From, To>;
+
+// A scalar operand that would lift T's arithmetic into a wider type, e.g.
+// the double in length_f * 0.5. Integers and narrower floats do not.
+template <typename T, typename Scalar>
+concept promoting_scalar =
+    !std::is_same_v<std::common_type_t<T, Scalar>, std::common_type_t<T, T>>;
+
+namespace detail {
+
+template <typename T> constexpr std::string_view scalar_name() noexcept {
+    if constexpr (std::is_same_v<T, float>) {
+        return "float";
+    } else if constexpr (std::is_same_v<T, double>) {
+        return "double";
+    } else if constexpr (std::is_same_v<T, long double>) {
+        return "long double";
+    } else if constexpr (std::is_same_v<T, half>) {
+        return "half";
+    } else if constexpr (std::is_same_v<T, bfloat16>) {
+        return "bfloat16";
+    } else {
+        return "integer";
+    }
+}
+
+} // namespace detail
+
+#if PHYSI_HAS_PROMOTION_COUNTS
+
+// One line that mixed precisions, with how often it ran.
+struct promotion_site {
+    std::source_location where;
+    // The operator, e.g. "+" or "*"
+    std::string_view operation;
+    // The operand's scalar and the one the operation ran in
+    std::string_view from;
+    std::string_view to;
+    std::uint64_t count = 0;
+};
+
+namespace detail {
+
+class promotion_registry {
+  public:
+    static promotion_registry &instance() {
+        static promotion_registry registry;
+        return registry;
+    }
+
+    void add(const std::source_location &where, std::string_view operation,
+             std::string_view from, std::string_view to) {
+        const key k{where.file_name(), where.line(), where.column(),
+                    operation.data(), from.data(), to.data()};
+        std::lock_guard lock(mutex_);
+        auto [it, inserted] = sites_.try_emplace(k);
+        if (inserted) {
+            it->second = {where, operation, from, to, 0};
+        }
+        ++it->second.count;
+    }
+
+    [[nodiscard]] std::vector<promotion_site> snapshot() const {
+        std::vector<promotion_site> sites;
+        {
+            std::lock_guard lock(mutex_);
+            sites.reserve(sites_.size());
+            for (const auto &entry : sites_) {
+                sites.push_back(entry.second);
+            }
+        }
+        std::sort(sites.begin(), sites.end(),
+                  [](const promotion_site &a, const promotion_site &b) {
+                      return a.count > b.count;
+                  });
+        return sites;
+    }
+
+    void clear() {
+        std::lock_guard lock(mutex_);
+        sites_.clear();
+    }
+
+  private:
+    // The strings are literals, so their addresses identify them.
+    struct key {
+        const char *file;
+        std::uint_least32_t line;
+        std::uint_least32_t column;
+        const char *operation;
+        const char *from;
+        const char *to;
+
+        bool operator==(const key &) const = default;
+    };
+
+    struct key_hash {
+        std::size_t operator()(const key &k) const noexcept {
+            std::size_t h = std::hash<const char *>{}(k.file);
+            for (const std::size_t part :
+                 {std::size_t(k.line), std::size_t(k.column),
+                  std::hash<const char *>{}(k.operation),
+                  std::hash<const char *>{}(k.from),
+                  std::hash<const char *>{}(k.to)}) {
+                h = h * 31 + part;
+            }
+            return h;
+        }
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<key, promotion_site, key_hash> sites_;
+};
+
+} // namespace detail
+
+// Every line that has run a mixed-precision operation since the start (or
+// the last reset), the most frequent first.
+[[nodiscard]] inline std::vector<promotion_site> promotion_counts() {
+    return detail::promotion_registry::instance().snapshot();
+}
+
+inline void reset_promotion_counts() {
+    detail::promotion_registry::instance().clear();
+}
+
+#endif
+
+namespace detail {
+
+// The left operand of a mixed-precision operator. Operators cannot take a
+// defaulted std::source_location, but the constructor of a parameter can:
+// it runs where the expression is written.
+template <typename Q> struct located {
+    const Q &value;
+#if PHYSI_HAS_PROMOTION_COUNTS
+    std::source_location where;
+
+    constexpr located(const Q &q, std::source_location loc =
+                                      std::source_location::current()) noexcept
+        : value(q), where(loc) {}
+#else
+    constexpr located(const Q &q) noexcept : value(q) {}
+#endif
+
+    // Records that this operation widened From to To.
+    template <typename From, typename To>
+    constexpr void promoted([[maybe_unused]] std::string_view operation) const {
+#if PHYSI_HAS_PROMOTION_COUNTS
+        if (!std::is_constant_evaluated()) {
+            promotion_registry::instance().add(where, operation,
+                                               scalar_name<From>(),
+                                               scalar_name<To>());
+        }
+#endif
+    }
+};
+
+} // namespace detail
+
+} // namespace physi
@@ -1,6 +1,14 @@
 #pragma once
 
+#include "dimension.hpp"
+#include "half.hpp"
+#include "precision.hpp"
+#include "unit.hpp"
+
 #include <concepts>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
@@ -8,16 +16,52 @@
     template <typename T = double> struct Name : quantity<Name, T> {           \
         using base = quantity<Name, T>;                                        \
         using base::base;                                                      \
+        static constexpr int physi_units_begin_ = __LINE__;                    \
                                                                                \
       public:
 
-// Close the struct and create the three precision aliases: _f, _d, _ld
+// Close the struct and create the precision aliases: _f, _d, _ld, plus the
+// 16-bit storage types _h (half) and _bf16 (bfloat16)
 #define PHYSI_QUANTITY_END(Name)                                               \
+        /* every unit declared above, for lookup by name at runtime */         \
+        [[nodiscard]] static constexpr std::span<const ::physi::unit_info>     \
+        units() noexcept {                                                     \
+            return ::physi::detail::unit_table<Name, physi_units_begin_,       \
+                                               __LINE__>;                      \
+        }                                                                      \
+        [[nodiscard]] static constexpr std::optional<::physi::unit_info>       \
+        find_unit(std::string_view name) noexcept {                            \
+            return ::physi::detail::find_unit(units(), name);                  \
+        }                                                                      \
     }                                                                          \
     ;                                                                          \
     using Name##_f = Name<float>;                                              \
     using Name##_d = Name<double>;                                             \
-    using Name##_ld = Name<long double>;
+    using Name##_ld = Name<long double>;                                       \
+    using Name##_h = Name<::physi::half>;                                      \
+    using Name##_bf16 = Name<::physi::bfloat16>;
+
+// Per-unit tag, table entry and bulk span kernels shared by PHYSI_UNIT and
+// PHYSI_UNIT_INCREASE (one unit per source line: the line keys the table).
+#define PHYSI_UNIT_COMMON(QuantityType, unit_name, to_base_multiplier,         \
+                          base_increase)                                       \
+    struct unit_name##_unit {                                                  \
+        using quantity_type = QuantityType;                                    \
+        static constexpr ::physi::unit_info info{                              \
+            #unit_name, (to_base_multiplier), (base_increase)};                \
+    };                                                                         \
+    static constexpr ::physi::unit_info physi_unit_(                           \
+        ::physi::detail::unit_line<__LINE__>) noexcept {                       \
+        return unit_name##_unit::info;                                         \
+    }                                                                          \
+    static void from_##unit_name(std::span<const T> in,                        \
+                                 std::span<QuantityType> out) noexcept {       \
+        ::physi::detail::convert_from(in, out, unit_name##_unit::info);        \
+    }                                                                          \
+    static void to_##unit_name(std::span<const QuantityType> in,               \
+                               std::span<T> out) noexcept {                    \
+        ::physi::detail::convert_to(in, out, unit_name##_unit::info);          \
+    }
 
 #define PHYSI_UNIT(QuantityType, unit_name, to_base_multiplier)                \
     [[nodiscard]] constexpr T unit_name() const {                              \
@@ -25,7 +69,8 @@
     }                                                                          \
     [[nodiscard]] static constexpr QuantityType unit_name(T v) {               \
         return QuantityType(v * (to_base_multiplier));                         \
-    }
+    }                                                                          \
+    PHYSI_UNIT_COMMON(QuantityType, unit_name, to_base_multiplier, 0)
 
 #define PHYSI_UNIT_INCREASE(QuantityType, unit_name, to_base_multiplier,       \
                             base_increase)                                     \
@@ -34,42 +79,53 @@
     }                                                                          \
     [[nodiscard]] static constexpr QuantityType unit_name(T v) {               \
         return QuantityType((v + base_increase) * (to_base_multiplier));       \
-    }
-
+    }                                                                          \
+    PHYSI_UNIT_COMMON(QuantityType, unit_name, to_base_multiplier,             \
+                      base_increase)
+
+// Literals are declared inside physi::literals. The default family yields
+// long double quantities; the same suffixes in literals::f32 / literals::f64
+// yield float / double ones (the value is still converted in long double and
+// rounded once), so `using namespace physi::literals::f32;` keeps float
+// kernels in float.
 #define PHYSI_LITERAL(QuantityType, unit_name)                                 \
-    constexpr QuantityType operator""_##unit_name(long double v) {             \
-        return QuantityType::unit_name(v);                                     \
+    PHYSI_LITERAL_AS(QuantityType, unit_name, long double)                     \
+    namespace f32 {                                                            \
+    PHYSI_LITERAL_AS(QuantityType, unit_name, float)                           \
     }                                                                          \
-    constexpr QuantityType operator""_##unit_name(unsigned long long v) {      \
-        return QuantityType::unit_name(static_cast<long double>(v));           \
+    namespace f64 {                                                            \
+    PHYSI_LITERAL_AS(QuantityType, unit_name, double)                          \
     }
 
-// single internal macro that emits one operator overload (no duplication)
-#define PHYSI_BINARY_OP_DEF(ResultType, LeftType, Op, RightType)               \
-    template <typename U, typename N>                                          \
-    [[nodiscard]] constexpr ResultType<std::common_type_t<U, N>> operator Op(  \
-        const LeftType<U> &lhs, const RightType<N> &rhs) noexcept {            \
-        using R = std::common_type_t<U, N>;                                    \
-        return ResultType<R>(static_cast<R>(lhs.base_value())                  \
-                                 Op static_cast<R>(rhs.base_value()));         \
+#define PHYSI_LITERAL_AS(QuantityType, unit_name, Scalar)                      \
+    constexpr QuantityType::rebind<Scalar> operator""_##unit_name(             \
+        long double v) {                                                       \
+        return ::physi::precision_cast<Scalar>(QuantityType::unit_name(v));    \
+    }                                                                          \
+    constexpr QuantityType::rebind<Scalar> operator""_##unit_name(             \
+        unsigned long long v) {                                                \
+        return ::physi::precision_cast<Scalar>(                                \
+            QuantityType::unit_name(static_cast<long double>(v)));             \
     }
 
-// Specific expansions for each algebraic operator (forward + 2 inverses)
-#define PHYSI_BINARY_OP_DIV(ResultType, LeftType, RightType)                   \
-    PHYSI_BINARY_OP_DEF(ResultType, LeftType, /,                               \
-                        RightType) /* forward: Left / Right -> Result */       \
-    PHYSI_BINARY_OP_DEF(LeftType, ResultType, *,                               \
-                        RightType) /* inverse: Result * Right -> Left */       \
-    PHYSI_BINARY_OP_DEF(RightType, LeftType, /,                                \
-                        ResultType) /* inverse: Left / Result -> Right */
-
+// Products and quotients are deduced from the dimension exponents registered
+// with PHYSI_DIMENSION, so these no longer emit operators: they document the
+// relation and check it at compile time.
 #define PHYSI_BINARY_OP_MUL(ResultType, LeftType, RightType)                   \
-    PHYSI_BINARY_OP_DEF(ResultType, LeftType, *,                               \
-                        RightType) /* forward: Left * Right -> Result */       \
-    PHYSI_BINARY_OP_DEF(LeftType, ResultType, /,                               \
-                        RightType) /* inverse: Result / Right -> Left */       \
-    PHYSI_BINARY_OP_DEF(RightType, ResultType, /,                              \
-                        LeftType) /* inverse: Result / Left -> Right */
+    static_assert(                                                             \
+        std::is_same_v<::physi::quantity_dimension_t<ResultType>,              \
+                       ::physi::dimension_product_t<                           \
+                           ::physi::quantity_dimension_t<LeftType>,            \
+                           ::physi::quantity_dimension_t<RightType>>>,         \
+        #ResultType " is not " #LeftType " * " #RightType);
+
+#define PHYSI_BINARY_OP_DIV(ResultType, LeftType, RightType)                   \
+    static_assert(                                                             \
+        std::is_same_v<::physi::quantity_dimension_t<ResultType>,              \
+                       ::physi::dimension_quotient_t<                          \
+                           ::physi::quantity_dimension_t<LeftType>,            \
+                           ::physi::quantity_dimension_t<RightType>>>,         \
+        #ResultType " is not " #LeftType " / " #RightType);
 
 #define PHYSI_BINARY_OP_DISPATCH(OpKeyword, ResultType, LeftType, RightType)   \
     PHYSI_BINARY_OP_##OpKeyword(ResultType, LeftType, RightType)
@@ -83,18 +139,65 @@
 
 namespace physi {
 
+// Scalars a quantity can be stored in: the arithmetic types plus the 16-bit
+// storage floats, whose arithmetic promotes to float.
+template <typename T>
+struct is_quantity_scalar
+    : std::bool_constant<std::is_arithmetic_v<T> || is_half_float_v<T>> {};
+
+template <typename T>
+inline constexpr bool is_quantity_scalar_v = is_quantity_scalar<T>::value;
+
+template <template <typename> class Derived, typename T> struct quantity;
+
+// Quantity for a dimension that has no registered name, e.g. the volumetric
+// flow produced by volume / time. It keeps its dimension as a member so it
+// composes further and converts implicitly into a named quantity once the
+// dimension matches one.
+template <typename Dim> struct unnamed_quantity {
+    template <typename T = double> struct of : quantity<of, T> {
+        using base = quantity<of, T>;
+        using base::base;
+        using dimension_type = Dim;
+    };
+};
+
+namespace detail {
+
+template <typename Dim, typename T> struct quantity_for {
+    using type = typename unnamed_quantity<Dim>::template of<T>;
+};
+
+template <typename Dim, typename T>
+    requires requires { typename named_quantity_t<Dim, T>; }
+struct quantity_for<Dim, T> {
+    using type = named_quantity_t<Dim, T>;
+};
+
+template <typename T> struct quantity_for<dimensionless, T> {
+    using type = T;
+};
+
+} // namespace detail
+
+// The quantity type of dimension Dim over scalar T: the named quantity when
+// one is registered, T itself when dimensionless, an unnamed one otherwise.
+template <typename Dim, typename T>
+using quantity_for_t = typename detail::quantity_for<Dim, T>::type;
+
 // CRTP base for a *dimension* quantity where the Derived is a template:
 //   template<typename> struct Length;
 //   using length_f = Length<float>;
 //   using length_d = Length<double>;
-// Works: length_f + length_d, length_d = length_f, etc.
+// Works: length_f + length_d, length_d = length_f, etc. (unless built with
+// PHYSI_STRICT_PRECISION, see precision.hpp).
 //
 // Derived must be a template taking one typename parameter.
 // T is the underlying scalar type (default double).
 template <template <typename> class Derived, typename T = double>
 struct quantity {
-    static_assert(std::is_arithmetic_v<T>,
-                  "Underlying type T must be arithmetic");
+    static_assert(is_quantity_scalar_v<T>,
+                  "Underlying type T must be arithmetic (or half / bfloat16)");
 
   protected:
     T value_;
@@ -103,10 +206,15 @@ struct quantity {
     using value_type = T;
     using derived_t = Derived<T>;
 
+    // The same quantity with another scalar, e.g. length_ld::rebind<float>.
+    template <typename U> using rebind = Derived<U>;
+
     // default / copy / move
     constexpr quantity() noexcept = default;
     constexpr quantity(const quantity &) noexcept = default;
     constexpr quantity(quantity &&) noexcept = default;
+    constexpr quantity &operator=(const quantity &) noexcept = default;
+    constexpr quantity &operator=(quantity &&) noexcept = default;
     ~quantity() noexcept = default;
 
     // explicit value constructor (keep it explicit to avoid accidental implicit
@@ -114,12 +222,40 @@ struct quantity {
     explicit constexpr quantity(T v) noexcept : value_(v) {}
 
     // implicit converting constructor between underlying scalar types for the
-    // same Derived
+    // same Derived (widening only under PHYSI_STRICT_PRECISION; narrowing
+    // takes a precision_cast)
     template <typename U>
-        requires std::is_arithmetic_v<U>
+        requires is_quantity_scalar_v<U> &&
+                 implicitly_convertible_precision<U, T>
     constexpr quantity(const quantity<Derived, U> &other) noexcept
         : value_(static_cast<T>(other.base_value())) {}
 
+    // conversion from another quantity of the same dimension: implicit from
+    // the unnamed result of a product/quotient, explicit between two named
+    // quantities (e.g. torque and energy) so they are not mixed by accident.
+    // A quantity sharing its dimension (torque, angular_velocity) is not the
+    // one an unnamed result stands for, so it takes that explicitly too.
+    // (Two overloads rather than explicit(bool): GCC 12 drops a conditional
+    // explicit on the inherited constructors of the derived quantities.)
+    template <template <typename> class Other, typename U>
+        requires is_quantity_scalar_v<U> &&
+                 (!std::is_same_v<Other<U>, Derived<U>>) &&
+                 same_dimension<Derived, Other> && carries_dimension<Other> &&
+                 registered_quantity<Derived> &&
+                 implicitly_convertible_precision<U, T>
+    constexpr quantity(const quantity<Other, U> &other) noexcept
+        : value_(static_cast<T>(other.base_value())) {}
+
+    template <template <typename> class Other, typename U>
+        requires is_quantity_scalar_v<U> &&
+                 (!std::is_same_v<Other<U>, Derived<U>>) &&
+                 same_dimension<Derived, Other> &&
+                 (!carries_dimension<Other> ||
+                  !registered_quantity<Derived>) &&
+                 implicitly_convertible_precision<U, T>
+    explicit constexpr quantity(const quantity<Other, U> &other) noexcept
+        : value_(static_cast<T>(other.base_value())) {}
+
     // accessors
     [[nodiscard]] constexpr T base_value() const noexcept { return value_; }
 
@@ -131,9 +267,10 @@ struct quantity {
         return derived_t(-value_);
     }
 
-    // arithmetic with same-dimension quantities (promotes to common_type)
+    // arithmetic with same-dimension quantities of the same precision; mixed
+    // precisions are handled by the friends below
     template <typename U>
-        requires std::is_arithmetic_v<U>
+        requires std::is_same_v<U, T>
     [[nodiscard]] constexpr Derived<std::common_type_t<T, U>>
     operator+(const Derived<U> &other) const noexcept {
         using R = std::common_type_t<T, U>;
@@ -142,7 +279,7 @@ struct quantity {
     }
 
     template <typename U>
-        requires std::is_arithmetic_v<U>
+        requires std::is_same_v<U, T>
     [[nodiscard]] constexpr Derived<std::common_type_t<T, U>>
     operator-(const Derived<U> &other) const noexcept {
         using R = std::common_type_t<T, U>;
@@ -152,7 +289,8 @@ struct quantity {
 
     // scalar multiply/divide
     template <typename Scalar>
-        requires std::is_arithmetic_v<Scalar>
+        requires std::is_arithmetic_v<Scalar> &&
+                 (!promoting_scalar<T, Scalar>)
     [[nodiscard]] constexpr Derived<std::common_type_t<T, Scalar>>
     operator*(Scalar s) const noexcept {
         using R = std::common_type_t<T, Scalar>;
@@ -160,7 +298,8 @@ struct quantity {
     }
 
     template <typename Scalar>
-        requires std::is_arithmetic_v<Scalar>
+        requires std::is_arithmetic_v<Scalar> &&
+                 (!promoting_scalar<T, Scalar>)
     [[nodiscard]] constexpr Derived<std::common_type_t<T, Scalar>>
     operator/(Scalar s) const noexcept {
         using R = std::common_type_t<T, Scalar>;
@@ -169,43 +308,50 @@ struct quantity {
 
     // scalar * quantity
     template <typename Scalar>
-        requires std::is_arithmetic_v<Scalar>
+        requires std::is_arithmetic_v<Scalar> &&
+                 (!promoting_scalar<T, Scalar>)
     friend constexpr Derived<std::common_type_t<T, Scalar>>
     operator*(Scalar s, const Derived<T> &q) noexcept {
         using R = std::common_type_t<T, Scalar>;
         return Derived<R>(static_cast<R>(s) * static_cast<R>(q.base_value()));
     }
 
-    // quantity / quantity -> scalar
-    template <typename U>
-    friend constexpr std::common_type_t<T, U>
-    operator/(const Derived<T> &a, const Derived<U> &b) noexcept {
-        using R = std::common_type_t<T, U>;
+    // quantity / quantity -> scalar (both deduced, so neither operand is
+    // converted to reach it)
+    template <typename U, typename V>
+        requires std::is_same_v<U, T> && std::is_same_v<V, T>
+    friend constexpr std::common_type_t<T, T>
+    operator/(const Derived<U> &a, const Derived<V> &b) noexcept {
+        using R = std::common_type_t<T, T>;
         return static_cast<R>(a.base_value()) / static_cast<R>(b.base_value());
     }
 
     // compound assignment (keeps underlying type T)
     template <typename U>
+        requires implicitly_convertible_precision<U, T>
     constexpr Derived<T> &operator+=(const Derived<U> &other) noexcept {
         value_ += static_cast<T>(other.base_value());
         return static_cast<Derived<T> &>(*this);
     }
 
     template <typename U>
+        requires implicitly_convertible_precision<U, T>
     constexpr Derived<T> &operator-=(const Derived<U> &other) noexcept {
         value_ -= static_cast<T>(other.base_value());
         return static_cast<Derived<T> &>(*this);
     }
 
     template <typename Scalar>
-        requires std::is_arithmetic_v<Scalar>
+        requires std::is_arithmetic_v<Scalar> &&
+                 implicitly_convertible_precision<Scalar, T>
     constexpr Derived<T> &operator*=(Scalar s) noexcept {
         value_ *= static_cast<T>(s);
         return static_cast<Derived<T> &>(*this);
     }
 
     template <typename Scalar>
-        requires std::is_arithmetic_v<Scalar>
+        requires std::is_arithmetic_v<Scalar> &&
+                 implicitly_convertible_precision<Scalar, T>
     constexpr Derived<T> &operator/=(Scalar s) noexcept {
         value_ /= static_cast<T>(s);
         return static_cast<Derived<T> &>(*this);
@@ -213,42 +359,335 @@ struct quantity {
 
     // comparisons
     template <typename U>
+        requires std::is_same_v<U, T>
     [[nodiscard]] constexpr bool
     operator==(const Derived<U> &other) const noexcept {
-        using R = std::common_type_t<T, U>;
-        return static_cast<R>(value_) == static_cast<R>(other.base_value());
+        return value_ == other.base_value();
     }
 
     template <typename U>
+        requires std::is_same_v<U, T>
     [[nodiscard]] constexpr bool
     operator!=(const Derived<U> &other) const noexcept {
         return !(*this == other);
     }
 
     template <typename U>
+        requires std::is_same_v<U, T>
     [[nodiscard]] constexpr bool
     operator<(const Derived<U> &other) const noexcept {
-        using R = std::common_type_t<T, U>;
-        return static_cast<R>(value_) < static_cast<R>(other.base_value());
+        return value_ < other.base_value();
     }
 
     template <typename U>
+        requires std::is_same_v<U, T>
     [[nodiscard]] constexpr bool
     operator<=(const Derived<U> &other) const noexcept {
         return !(other < *this);
     }
 
     template <typename U>
+        requires std::is_same_v<U, T>
     [[nodiscard]] constexpr bool
     operator>(const Derived<U> &other) const noexcept {
         return other < *this;
     }
 
     template <typename U>
+        requires std::is_same_v<U, T>
     [[nodiscard]] constexpr bool
     operator>=(const Derived<U> &other) const noexcept {
         return !(*this < other);
     }
+
+    // ========== Mixed precision ==========
+    // length_f + length_d runs in std::common_type (double here). These
+    // operators do not exist under PHYSI_STRICT_PRECISION, and count their
+    // call sites under PHYSI_COUNT_PROMOTIONS.
+  private:
+    template <typename U>
+    static constexpr bool mixes_with =
+        !strict_precision && is_quantity_scalar_v<U> && !std::is_same_v<U, T>;
+
+    template <typename Scalar>
+    static constexpr bool promoted_by =
+        !strict_precision && std::is_arithmetic_v<Scalar> &&
+        promoting_scalar<T, Scalar>;
+
+    // Records the widening of whichever operand is not already in R.
+    template <typename U, typename R>
+    static constexpr void
+    note_mixed(const detail::located<Derived<T>> &site,
+               std::string_view operation) {
+        if constexpr (std::is_same_v<T, R>) {
+            site.template promoted<U, R>(operation);
+        } else {
+            site.template promoted<T, R>(operation);
+        }
+    }
+
+  public:
+    template <typename U>
+        requires mixes_with<U>
+    friend constexpr Derived<std::common_type_t<T, U>>
+    operator+(const detail::located<Derived<T>> &a,
+              const Derived<U> &b) noexcept {
+        using R = std::common_type_t<T, U>;
+        note_mixed<U, R>(a, "+");
+        return Derived<R>(static_cast<R>(a.value.base_value()) +
+                          static_cast<R>(b.base_value()));
+    }
+
+    template <typename U>
+        requires mixes_with<U>
+    friend constexpr Derived<std::common_type_t<T, U>>
+    operator-(const detail::located<Derived<T>> &a,
+              const Derived<U> &b) noexcept {
+        using R = std::common_type_t<T, U>;
+        note_mixed<U, R>(a, "-");
+        return Derived<R>(static_cast<R>(a.value.base_value()) -
+                          static_cast<R>(b.base_value()));
+    }
+
+    template <typename Scalar>
+        requires promoted_by<Scalar>
+    friend constexpr Derived<std::common_type_t<T, Scalar>>
+    operator*(const detail::located<Derived<T>> &q, Scalar s) noexcept {
+        using R = std::common_type_t<T, Scalar>;
+        q.template promoted<T, R>("*");
+        return Derived<R>(static_cast<R>(q.value.base_value()) *
+                          static_cast<R>(s));
+    }
+
+    template <typename Scalar>
+        requires promoted_by<Scalar>
+    friend constexpr Derived<std::common_type_t<T, Scalar>>
+    operator/(const detail::located<Derived<T>> &q, Scalar s) noexcept {
+        using R = std::common_type_t<T, Scalar>;
+        q.template promoted<T, R>("/");
+        return Derived<R>(static_cast<R>(q.value.base_value()) /
+                          static_cast<R>(s));
+    }
+
+    template <typename Scalar>
+        requires promoted_by<Scalar>
+    friend constexpr Derived<std::common_type_t<T, Scalar>>
+    operator*(Scalar s, const detail::located<Derived<T>> &q) noexcept {
+        using R = std::common_type_t<T, Scalar>;
+        q.template promoted<T, R>("*");
+        return Derived<R>(static_cast<R>(s) *
+                          static_cast<R>(q.value.base_value()));
+    }
+
+    template <typename U>
+        requires mixes_with<U>
+    [[nodiscard]] friend constexpr bool
+    operator==(const detail::located<Derived<T>> &a,
+               const Derived<U> &b) noexcept {
+        using R = std::common_type_t<T, U>;
+        note_mixed<U, R>(a, "==");
+        return static_cast<R>(a.value.base_value()) ==
+               static_cast<R>(b.base_value());
+    }
+
+    template <typename U>
+        requires mixes_with<U>
+    [[nodiscard]] friend constexpr bool
+    operator!=(const detail::located<Derived<T>> &a,
+               const Derived<U> &b) noexcept {
+        using R = std::common_type_t<T, U>;
+        note_mixed<U, R>(a, "!=");
+        return static_cast<R>(a.value.base_value()) !=
+               static_cast<R>(b.base_value());
+    }
+
+    template <typename U>
+        requires mixes_with<U>
+    [[nodiscard]] friend constexpr bool
+    operator<(const detail::located<Derived<T>> &a,
+              const Derived<U> &b) noexcept {
+        using R = std::common_type_t<T, U>;
+        note_mixed<U, R>(a, "<");
+        return static_cast<R>(a.value.base_value()) <
+               static_cast<R>(b.base_value());
+    }
+
+    template <typename U>
+        requires mixes_with<U>
+    [[nodiscard]] friend constexpr bool
+    operator<=(const detail::located<Derived<T>> &a,
+               const Derived<U> &b) noexcept {
+        using R = std::common_type_t<T, U>;
+        note_mixed<U, R>(a, "<=");
+        return static_cast<R>(a.value.base_value()) <=
+               static_cast<R>(b.base_value());
+    }
+
+    template <typename U>
+        requires mixes_with<U>
+    [[nodiscard]] friend constexpr bool
+    operator>(const detail::located<Derived<T>> &a,
+              const Derived<U> &b) noexcept {
+        using R = std::common_type_t<T, U>;
+        note_mixed<U, R>(a, ">");
+        return static_cast<R>(a.value.base_value()) >
+               static_cast<R>(b.base_value());
+    }
+
+    template <typename U>
+        requires mixes_with<U>
+    [[nodiscard]] friend constexpr bool
+    operator>=(const detail::located<Derived<T>> &a,
+               const Derived<U> &b) noexcept {
+        using R = std::common_type_t<T, U>;
+        note_mixed<U, R>(a, ">=");
+        return static_cast<R>(a.value.base_value()) >=
+               static_cast<R>(b.base_value());
+    }
+
+    // Products and quotients, e.g. force_f * length_d (length_f / length_d
+    // is dimensionless and yields a plain double)
+    template <template <typename> class B, typename N>
+        requires mixes_with<N> && has_dimension<Derived> && has_dimension<B>
+    [[nodiscard]] friend constexpr auto
+    operator*(const detail::located<Derived<T>> &lhs,
+              const quantity<B, N> &rhs) noexcept {
+        using R = std::common_type_t<T, N>;
+        using result = quantity_for_t<
+            dimension_product_t<quantity_dimension_t<Derived>,
+                                quantity_dimension_t<B>>,
+            R>;
+        note_mixed<N, R>(lhs, "*");
+        return result(static_cast<R>(lhs.value.base_value()) *
+                      static_cast<R>(rhs.base_value()));
+    }
+
+    template <template <typename> class B, typename N>
+        requires mixes_with<N> && has_dimension<Derived> && has_dimension<B>
+    [[nodiscard]] friend constexpr auto
+    operator/(const detail::located<Derived<T>> &lhs,
+              const quantity<B, N> &rhs) noexcept {
+        using R = std::common_type_t<T, N>;
+        using result = quantity_for_t<
+            dimension_quotient_t<quantity_dimension_t<Derived>,
+                                 quantity_dimension_t<B>>,
+            R>;
+        note_mixed<N, R>(lhs, "/");
+        return result(static_cast<R>(lhs.value.base_value()) /
+                      static_cast<R>(rhs.base_value()));
+    }
+
+    // scalar / quantity with a wider scalar, e.g. 1.0 / time_f
+    template <typename Scalar>
+        requires promoted_by<Scalar> && has_dimension<Derived>
+    [[nodiscard]] friend constexpr auto
+    operator/(Scalar s, const detail::located<Derived<T>> &rhs) noexcept {
+        using R = std::common_type_t<T, Scalar>;
+        using result = quantity_for_t<
+            dimension_quotient_t<dimensionless, quantity_dimension_t<Derived>>,
+            R>;
+        rhs.template promoted<T, R>("/");
+        return result(static_cast<R>(s) /
+                      static_cast<R>(rhs.value.base_value()));
+    }
+};
+
+// ========== Dimension algebra ==========
+
+// A single generic product and quotient cover every pair of dimensioned
+// quantities of one precision; same-quantity division keeps its dedicated
+// friend above, and mixed precisions have theirs.
+template <template <typename> class A, typename U, template <typename> class B,
+          typename N>
+    requires has_dimension<A> && has_dimension<B> && std::is_same_v<U, N>
+[[nodiscard]] constexpr quantity_for_t<
+    dimension_product_t<quantity_dimension_t<A>, quantity_dimension_t<B>>,
+    std::common_type_t<U, N>>
+operator*(const quantity<A, U> &lhs, const quantity<B, N> &rhs) noexcept {
+    using R = std::common_type_t<U, N>;
+    using result = quantity_for_t<
+        dimension_product_t<quantity_dimension_t<A>, quantity_dimension_t<B>>,
+        R>;
+    return result(static_cast<R>(lhs.base_value()) *
+                  static_cast<R>(rhs.base_value()));
+}
+
+template <template <typename> class A, typename U, template <typename> class B,
+          typename N>
+    requires has_dimension<A> && has_dimension<B> && std::is_same_v<U, N>
+[[nodiscard]] constexpr quantity_for_t<
+    dimension_quotient_t<quantity_dimension_t<A>, quantity_dimension_t<B>>,
+    std::common_type_t<U, N>>
+operator/(const quantity<A, U> &lhs, const quantity<B, N> &rhs) noexcept {
+    using R = std::common_type_t<U, N>;
+    using result = quantity_for_t<
+        dimension_quotient_t<quantity_dimension_t<A>, quantity_dimension_t<B>>,
+        R>;
+    return result(static_cast<R>(lhs.base_value()) /
+                  static_cast<R>(rhs.base_value()));
+}
+
+// scalar / quantity -> inverse dimension (1 / time is a frequency)
+template <typename Scalar, template <typename> class B, typename N>
+    requires std::is_arithmetic_v<Scalar> && has_dimension<B> &&
+             (!promoting_scalar<N, Scalar>)
+[[nodiscard]] constexpr quantity_for_t<
+    dimension_quotient_t<dimensionless, quantity_dimension_t<B>>,
+    std::common_type_t<Scalar, N>>
+operator/(Scalar s, const quantity<B, N> &rhs) noexcept {
+    using R = std::common_type_t<Scalar, N>;
+    using result = quantity_for_t<
+        dimension_quotient_t<dimensionless, quantity_dimension_t<B>>, R>;
+    return result(static_cast<R>(s) / static_cast<R>(rhs.base_value()));
+}
+
+// ========== Precision ==========
+
+// The same quantity in another scalar type, e.g. precision_cast<float>(x)
+// for a length_ld x. The one conversion PHYSI_STRICT_PRECISION never
+// rejects, so narrowing stays visible in the source.
+template <typename To, template <typename> class Derived, typename U>
+    requires is_quantity_scalar_v<To>
+[[nodiscard]] constexpr Derived<To>
+precision_cast(const quantity<Derived, U> &q) noexcept {
+    return Derived<To>(static_cast<To>(q.base_value()));
+}
+
+// ========== Traits ==========
+
+// True for every type produced by PHYSI_QUANTITY_BEGIN (length<float>, ...).
+template <typename T>
+inline constexpr bool is_quantity_v = requires {
+    typename T::derived_t;
+    requires std::is_same_v<typename T::derived_t, std::remove_cv_t<T>>;
+};
+
+// Underlying scalar of a quantity; plain arithmetic types stand for
+// dimensionless values and are their own scalar.
+template <typename T> struct scalar_type {
+    using type = T;
 };
 
+template <typename T>
+    requires is_quantity_v<T>
+struct scalar_type<T> {
+    using type = typename T::value_type;
+};
+
+template <typename T> using scalar_type_t = typename scalar_type<T>::type;
+
+// Result types of the dimensional operators, e.g. product_t<force_d, length_d>
+// is energy_d. Substitution fails when the operator is not defined.
+template <typename A, typename B>
+using sum_t = decltype(std::declval<const A &>() + std::declval<const B &>());
+template <typename A, typename B>
+using difference_t =
+    decltype(std::declval<const A &>() - std::declval<const B &>());
+template <typename A, typename B>
+using product_t =
+    decltype(std::declval<const A &>() * std::declval<const B &>());
+template <typename A, typename B>
+using quotient_t =
+    decltype(std::declval<const A &>() / std::declval<const B &>());
+
 } // namespace physi
\ No newline at end of file
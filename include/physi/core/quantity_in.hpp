@@ -0,0 +1,275 @@
+#pragma once
+
+#include "quantity.hpp"
+#include "unit.hpp"
+
+#include <cassert>
+#include <compare>
+#include <span>
+#include <type_traits>
+
+namespace physi {
+
+namespace detail {
+
+// v_to = v_from * mul + add, folded in long double at compile time:
+//   base = (v_from + o_from) * s_from,  v_to = base / s_to - o_to
+template <typename From, typename To, typename T> struct unit_conversion {
+    static constexpr long double ratio = From::info.scale / To::info.scale;
+    static constexpr T mul = static_cast<T>(ratio);
+    static constexpr T add =
+        static_cast<T>(From::info.offset * ratio - To::info.offset);
+    static constexpr bool identity = ratio == 1.0L && add == T(0);
+};
+
+// The base SI unit, as a conversion endpoint: unit_conversion<U, base_unit,
+// T> folds (v + offset) * scale into one multiply and add in T.
+struct base_unit {
+    static constexpr unit_info info{};
+};
+
+} // namespace detail
+
+// A quantity stored in a declared unit instead of the base SI unit, e.g.
+//
+//   using kmh = quantity_in<speed_d, speed_d::km_h_unit>;
+//   kmh v(100.0);                    // holds 100, not 27.78
+//   kmh w = v + v * 0.5;             // no conversion at all
+//   quantity_in<speed_d, speed_d::mph_unit> m = w.in<speed_d::mph_unit>();
+//   speed_d base = w;                // converts only here
+//
+// Values pass through stages that read and write the same unit without
+// being multiplied into base units and divided back out. Conversions to
+// another unit use one factor folded at compile time from the two unit
+// scales, so chains of units never go through base. Arithmetic other than
+// comparison requires a plain (non-affine) unit; convert °C/°F values to
+// the base quantity to do arithmetic on them.
+template <typename Quantity, typename Unit> class quantity_in {
+    static_assert(is_quantity_v<Quantity>, "quantity_in wraps a quantity");
+    static_assert(std::is_same_v<dimension_of_t<Quantity>,
+                                 dimension_of_t<typename Unit::quantity_type>>,
+                  "Unit does not belong to Quantity");
+
+  public:
+    using quantity_type = Quantity;
+    using unit_type = Unit;
+    using value_type = typename Quantity::value_type;
+
+    static constexpr bool is_affine = Unit::info.offset != 0.0L;
+
+  private:
+    using T = value_type;
+
+    T value_ = 0;
+
+    template <typename Q2, typename U2> friend class quantity_in;
+
+    template <typename From, typename To>
+    [[nodiscard]] static constexpr T rescale(T v) noexcept {
+        using conv = detail::unit_conversion<From, To, T>;
+        if constexpr (conv::identity) {
+            return v;
+        } else if constexpr (conv::add == T(0)) {
+            return v * conv::mul;
+        } else {
+            return v * conv::mul + conv::add;
+        }
+    }
+
+  public:
+    constexpr quantity_in() noexcept = default;
+
+    // Value already expressed in Unit.
+    explicit constexpr quantity_in(T v) noexcept : value_(v) {}
+
+    // From the base representation: one multiply (and add for affine
+    // units) in T, by factors folded at compile time.
+    explicit constexpr quantity_in(const Quantity &q) noexcept
+        : value_(rescale<detail::base_unit, Unit>(q.base_value())) {}
+
+    // Same quantity stored in another unit: one folded multiply (and add
+    // for affine units).
+    template <typename U2>
+    explicit constexpr quantity_in(
+        const quantity_in<Quantity, U2> &other) noexcept
+        : value_(other.template in<Unit>().value()) {}
+
+    // ========== Access ==========
+    [[nodiscard]] constexpr T value() const noexcept { return value_; }
+
+    [[nodiscard]] static constexpr const unit_info &unit() noexcept {
+        return Unit::info;
+    }
+
+    // Converts to another unit of the same quantity.
+    template <typename U2>
+    [[nodiscard]] constexpr quantity_in<Quantity, U2> in() const noexcept {
+        return quantity_in<Quantity, U2>(rescale<Unit, U2>(value_));
+    }
+
+    // Converts to the base representation.
+    [[nodiscard]] constexpr Quantity base() const noexcept {
+        return Quantity(rescale<Unit, detail::base_unit>(value_));
+    }
+
+    constexpr operator Quantity() const noexcept { return base(); }
+
+    // ========== Same-unit arithmetic (no conversion) ==========
+    [[nodiscard]] constexpr quantity_in operator-() const noexcept
+        requires(!is_affine)
+    {
+        return quantity_in(-value_);
+    }
+
+    [[nodiscard]] friend constexpr quantity_in
+    operator+(quantity_in a, quantity_in b) noexcept
+        requires(!is_affine)
+    {
+        return quantity_in(a.value_ + b.value_);
+    }
+
+    [[nodiscard]] friend constexpr quantity_in
+    operator-(quantity_in a, quantity_in b) noexcept
+        requires(!is_affine)
+    {
+        return quantity_in(a.value_ - b.value_);
+    }
+
+    constexpr quantity_in &operator+=(quantity_in other) noexcept
+        requires(!is_affine)
+    {
+        value_ += other.value_;
+        return *this;
+    }
+
+    constexpr quantity_in &operator-=(quantity_in other) noexcept
+        requires(!is_affine)
+    {
+        value_ -= other.value_;
+        return *this;
+    }
+
+    template <typename Scalar>
+        requires std::is_arithmetic_v<Scalar> && (!is_affine)
+    [[nodiscard]] friend constexpr quantity_in
+    operator*(quantity_in a, Scalar s) noexcept {
+        return quantity_in(a.value_ * static_cast<T>(s));
+    }
+
+    template <typename Scalar>
+        requires std::is_arithmetic_v<Scalar> && (!is_affine)
+    [[nodiscard]] friend constexpr quantity_in
+    operator*(Scalar s, quantity_in a) noexcept {
+        return quantity_in(static_cast<T>(s) * a.value_);
+    }
+
+    template <typename Scalar>
+        requires std::is_arithmetic_v<Scalar> && (!is_affine)
+    [[nodiscard]] friend constexpr quantity_in
+    operator/(quantity_in a, Scalar s) noexcept {
+        return quantity_in(a.value_ / static_cast<T>(s));
+    }
+
+    // Ratio of two values in the same unit.
+    [[nodiscard]] friend constexpr T operator/(quantity_in a,
+                                               quantity_in b) noexcept
+        requires(!is_affine)
+    {
+        return a.value_ / b.value_;
+    }
+
+    [[nodiscard]] friend constexpr bool
+    operator==(quantity_in, quantity_in) noexcept = default;
+    [[nodiscard]] friend constexpr auto
+    operator<=>(quantity_in, quantity_in) noexcept = default;
+
+    // ========== Mixed units ==========
+    // The right-hand side is converted into the left-hand unit.
+    template <typename U2>
+        requires(!std::is_same_v<U2, Unit>) && (!is_affine)
+    [[nodiscard]] friend constexpr quantity_in
+    operator+(quantity_in a, const quantity_in<Quantity, U2> &b) noexcept {
+        return a + quantity_in(b);
+    }
+
+    template <typename U2>
+        requires(!std::is_same_v<U2, Unit>) && (!is_affine)
+    [[nodiscard]] friend constexpr quantity_in
+    operator-(quantity_in a, const quantity_in<Quantity, U2> &b) noexcept {
+        return a - quantity_in(b);
+    }
+
+    // With base-unit quantities and across dimensions the value goes to the
+    // base representation and the existing operators apply.
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator+(quantity_in a,
+                                                  const Other &b) noexcept
+        -> sum_t<Quantity, Other> {
+        return a.base() + b;
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator-(quantity_in a,
+                                                  const Other &b) noexcept
+        -> difference_t<Quantity, Other> {
+        return a.base() - b;
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator*(quantity_in a,
+                                                  const Other &b) noexcept
+        -> product_t<Quantity, Other> {
+        return a.base() * b;
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator*(const Other &a,
+                                                  quantity_in b) noexcept
+        -> product_t<Other, Quantity> {
+        return a * b.base();
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator/(quantity_in a,
+                                                  const Other &b) noexcept
+        -> quotient_t<Quantity, Other> {
+        return a.base() / b;
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator/(const Other &a,
+                                                  quantity_in b) noexcept
+        -> quotient_t<Other, Quantity> {
+        return a / b.base();
+    }
+};
+
+// Bulk re-expression of a column from one unit to another in a single
+// vectorized pass (out may alias in).
+template <typename Quantity, typename From, typename To>
+void convert(std::span<const quantity_in<Quantity, From>> in,
+             std::span<quantity_in<Quantity, To>> out) noexcept {
+    using T = typename Quantity::value_type;
+    using conv = detail::unit_conversion<From, To, T>;
+    static_assert(sizeof(quantity_in<Quantity, From>) == sizeof(T));
+    assert(in.size() == out.size());
+    detail::affine_map(reinterpret_cast<const T *>(in.data()),
+                       reinterpret_cast<T *>(out.data()), in.size(), conv::mul,
+                       conv::add);
+}
+
+template <typename T> struct is_quantity_in : std::false_type {};
+
+template <typename Q, typename U>
+struct is_quantity_in<quantity_in<Q, U>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_quantity_in_v = is_quantity_in<T>::value;
+
+} // namespace physi
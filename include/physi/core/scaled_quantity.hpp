@@ -0,0 +1,288 @@
+#pragma once
+
+#include "quantity.hpp"
+
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+
+namespace physi {
+
+// Integer-backed quantity with a compile-time scale, for compact storage
+// and integer-fast comparison and sorting:
+//
+//   using length_mm = scaled_quantity<length, std::milli, std::int32_t>;
+//   length_mm p(1.2345_m);           // 1235 ticks of 1 mm (rounded)
+//   length_d d = p;                  // back to floating point
+//   auto v = p / 2.0_s;              // speed_ld, via the floating operators
+//
+// One tick is Scale base units (Scale is a std::ratio). Converting to a
+// floating quantity whose significand holds every Rep value (double for
+// int32 ticks) is implicit, and converting that value back yields the same
+// ticks; narrower floating types (float for int32) take as<float>() or an
+// explicit conversion, since large tick counts round. Sums and differences
+// of the same scaled type stay in integer ticks; every other operation goes
+// through the floating quantity.
+template <template <typename> class Quantity, typename Scale,
+          std::integral Rep = std::int32_t>
+class scaled_quantity {
+    static_assert(Scale::num > 0 && Scale::den > 0, "Scale must be positive");
+
+  public:
+    using rep = Rep;
+    using scale = Scale;
+    template <typename T> using quantity_type = Quantity<T>;
+
+  private:
+    Rep ticks_ = 0;
+
+    // Rep's max() + 1, a power of two and so exact in any floating type
+    template <typename T>
+    static constexpr T rep_end =
+        static_cast<T>(std::numeric_limits<Rep>::max() / 2 + 1) * T(2);
+
+    // Nearest tick, halves away from zero. The fraction ticks - trunc(ticks)
+    // is exact in T, whereas adding 0.5 before truncating would round the
+    // largest values below .5 up.
+    template <typename T>
+    [[nodiscard]] static constexpr Rep round_to_ticks(T base) noexcept {
+        const T ticks = base * static_cast<T>(Scale::den) /
+                        static_cast<T>(Scale::num);
+        assert(ticks >= static_cast<T>(std::numeric_limits<Rep>::min()) &&
+               ticks < rep_end<T> &&
+               "value out of range for the scaled representation");
+        const Rep whole = static_cast<Rep>(ticks);
+        const T rest = ticks - static_cast<T>(whole);
+        if (rest >= T(0.5)) {
+            assert(whole < std::numeric_limits<Rep>::max() &&
+                   "value out of range for the scaled representation");
+            return static_cast<Rep>(whole + 1);
+        }
+        if (rest <= T(-0.5)) {
+            assert(whole > std::numeric_limits<Rep>::min() &&
+                   "value out of range for the scaled representation");
+            return static_cast<Rep>(whole - 1);
+        }
+        return whole;
+    }
+
+    // Bits needed for n, i.e. ceil(log2(n)) for n >= 1
+    [[nodiscard]] static constexpr int ceil_log2(std::intmax_t n) noexcept {
+        int bits = 0;
+        while ((std::intmax_t{1} << bits) < n) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    template <typename S2, typename R2>
+    static constexpr bool lossless_rescale =
+        std::ratio_divide<S2, Scale>::den == 1 &&
+        std::numeric_limits<Rep>::digits >=
+            std::numeric_limits<R2>::digits +
+                ceil_log2(std::ratio_divide<S2, Scale>::num);
+
+  public:
+    constexpr scaled_quantity() noexcept = default;
+
+    // Rounds to the nearest tick.
+    template <typename T>
+        requires std::floating_point<T>
+    explicit constexpr scaled_quantity(const Quantity<T> &q) noexcept
+        : ticks_(round_to_ticks(q.base_value())) {}
+
+    // Rescaling from another tick size: implicit when every source value is
+    // representable (the source tick is a whole number `k` of ours and Rep
+    // has room for R2's digits plus log2(k) more), explicit otherwise, where
+    // it rounds and asserts that the value fits.
+    template <typename S2, typename R2>
+    explicit(!lossless_rescale<S2, R2>) constexpr scaled_quantity(
+        const scaled_quantity<Quantity, S2, R2> &other) noexcept {
+        using factor = std::ratio_divide<S2, Scale>;
+        if constexpr (factor::den == 1) {
+            const long double product =
+                static_cast<long double>(other.ticks()) *
+                static_cast<long double>(factor::num);
+            assert(product >= static_cast<long double>(
+                                  std::numeric_limits<Rep>::min()) &&
+                   product <= static_cast<long double>(
+                                  std::numeric_limits<Rep>::max()) &&
+                   "value out of range for the scaled representation");
+            (void)product;
+            ticks_ = static_cast<Rep>(other.ticks() * factor::num);
+        } else {
+            ticks_ = round_to_ticks(other.template as<long double>()
+                                        .base_value());
+        }
+    }
+
+    [[nodiscard]] static constexpr scaled_quantity
+    from_ticks(Rep ticks) noexcept {
+        scaled_quantity q;
+        q.ticks_ = ticks;
+        return q;
+    }
+
+    // ========== Access ==========
+    [[nodiscard]] constexpr Rep ticks() const noexcept { return ticks_; }
+
+    template <typename T = double>
+        requires std::floating_point<T>
+    [[nodiscard]] constexpr Quantity<T> as() const noexcept {
+        return Quantity<T>(static_cast<T>(ticks_) *
+                           static_cast<T>(Scale::num) /
+                           static_cast<T>(Scale::den));
+    }
+
+    // Implicit only when T holds every tick count exactly.
+    template <typename T>
+        requires std::floating_point<T>
+    explicit(std::numeric_limits<T>::digits < std::numeric_limits<Rep>::digits)
+    constexpr operator Quantity<T>() const noexcept {
+        return as<T>();
+    }
+
+    // ========== Integer arithmetic (same scale) ==========
+    [[nodiscard]] constexpr scaled_quantity operator-() const noexcept {
+        return from_ticks(static_cast<Rep>(-ticks_));
+    }
+
+    [[nodiscard]] friend constexpr scaled_quantity
+    operator+(scaled_quantity a, scaled_quantity b) noexcept {
+        return from_ticks(static_cast<Rep>(a.ticks_ + b.ticks_));
+    }
+
+    [[nodiscard]] friend constexpr scaled_quantity
+    operator-(scaled_quantity a, scaled_quantity b) noexcept {
+        return from_ticks(static_cast<Rep>(a.ticks_ - b.ticks_));
+    }
+
+    constexpr scaled_quantity &operator+=(scaled_quantity other) noexcept {
+        ticks_ = static_cast<Rep>(ticks_ + other.ticks_);
+        return *this;
+    }
+
+    constexpr scaled_quantity &operator-=(scaled_quantity other) noexcept {
+        ticks_ = static_cast<Rep>(ticks_ - other.ticks_);
+        return *this;
+    }
+
+    template <std::integral I>
+    [[nodiscard]] friend constexpr scaled_quantity
+    operator*(scaled_quantity a, I n) noexcept {
+        return from_ticks(static_cast<Rep>(a.ticks_ * n));
+    }
+
+    template <std::integral I>
+    [[nodiscard]] friend constexpr scaled_quantity
+    operator*(I n, scaled_quantity a) noexcept {
+        return a * n;
+    }
+
+    [[nodiscard]] friend constexpr bool
+    operator==(scaled_quantity, scaled_quantity) noexcept = default;
+    [[nodiscard]] friend constexpr auto
+    operator<=>(scaled_quantity, scaled_quantity) noexcept = default;
+
+    // ========== Floating-point interop ==========
+    // Mixed with a floating quantity, the scaled value is converted to that
+    // quantity's precision and the existing operators apply.
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator+(scaled_quantity a,
+                                                  const Other &b) noexcept
+        -> sum_t<Quantity<typename Other::value_type>, Other> {
+        return a.template as<typename Other::value_type>() + b;
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator+(const Other &a,
+                                                  scaled_quantity b) noexcept
+        -> sum_t<Other, Quantity<typename Other::value_type>> {
+        return a + b.template as<typename Other::value_type>();
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator-(scaled_quantity a,
+                                                  const Other &b) noexcept
+        -> difference_t<Quantity<typename Other::value_type>, Other> {
+        return a.template as<typename Other::value_type>() - b;
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator-(const Other &a,
+                                                  scaled_quantity b) noexcept
+        -> difference_t<Other, Quantity<typename Other::value_type>> {
+        return a - b.template as<typename Other::value_type>();
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator*(scaled_quantity a,
+                                                  const Other &b) noexcept {
+        return a.template as<typename Other::value_type>() * b;
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator*(const Other &a,
+                                                  scaled_quantity b) noexcept {
+        return a * b.template as<typename Other::value_type>();
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator/(scaled_quantity a,
+                                                  const Other &b) noexcept {
+        return a.template as<typename Other::value_type>() / b;
+    }
+
+    template <typename Other>
+        requires is_quantity_v<Other>
+    [[nodiscard]] friend constexpr auto operator/(const Other &a,
+                                                  scaled_quantity b) noexcept {
+        return a / b.template as<typename Other::value_type>();
+    }
+
+    // Floating scalars leave the integer domain.
+    template <std::floating_point S>
+    [[nodiscard]] friend constexpr auto operator*(scaled_quantity a,
+                                                  S s) noexcept {
+        return a.template as<S>() * s;
+    }
+
+    template <std::floating_point S>
+    [[nodiscard]] friend constexpr auto operator*(S s,
+                                                  scaled_quantity a) noexcept {
+        return s * a.template as<S>();
+    }
+
+    template <std::floating_point S>
+    [[nodiscard]] friend constexpr auto operator/(scaled_quantity a,
+                                                  S s) noexcept {
+        return a.template as<S>() / s;
+    }
+
+    // Ratio of two values of the same type.
+    [[nodiscard]] friend constexpr double
+    operator/(scaled_quantity a, scaled_quantity b) noexcept {
+        return static_cast<double>(a.ticks_) / static_cast<double>(b.ticks_);
+    }
+};
+
+template <typename T> struct is_scaled_quantity : std::false_type {};
+
+template <template <typename> class Q, typename S, typename R>
+struct is_scaled_quantity<scaled_quantity<Q, S, R>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_scaled_quantity_v = is_scaled_quantity<T>::value;
+
+} // namespace physi
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "loop_hints.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PHYSI_HAS_SIMD_DISPATCH 1
+#else
+#define PHYSI_HAS_SIMD_DISPATCH 0
+#endif
+
+namespace physi {
+
+// Alignment of every column buffer: one cache line, which also covers the
+// widest vector registers (AVX-512).
+inline constexpr std::size_t simd_alignment = 64;
+
+// Minimal allocator returning simd_alignment-aligned storage.
+template <typename T, std::size_t Align = simd_alignment>
+struct aligned_allocator {
+    static_assert(Align >= alignof(T), "Alignment weaker than alignof(T)");
+
+    using value_type = T;
+
+    template <typename U> struct rebind {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    constexpr aligned_allocator() noexcept = default;
+
+    template <typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, Align> &) noexcept {}
+
+    [[nodiscard]] T *allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(
+            ::operator new(n * sizeof(T), std::align_val_t{Align}));
+    }
+
+    void deallocate(T *p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t{Align});
+    }
+
+    template <typename U>
+    constexpr bool
+    operator==(const aligned_allocator<U, Align> &) const noexcept {
+        return true;
+    }
+};
+
+// Tell the optimizer a column pointer is simd_alignment-aligned.
+template <typename T> [[nodiscard]] constexpr T *assume_aligned(T *p) noexcept {
+    return std::assume_aligned<simd_alignment>(p);
+}
+
+// ========== Runtime dispatch ==========
+
+// Widest instruction set the kernels below are compiled for.
+enum class simd_level { scalar, avx2, avx512 };
+
+// Best level the running CPU supports (checked once).
+[[nodiscard]] inline simd_level cpu_simd_level() noexcept {
+#if PHYSI_HAS_SIMD_DISPATCH
+    static const simd_level level = [] {
+        if (__builtin_cpu_supports("avx512f")) {
+            return simd_level::avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return simd_level::avx2;
+        }
+        return simd_level::scalar;
+    }();
+    return level;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+namespace detail {
+
+// Fixed-width register of T for level L with the handful of operations the
+// geometry kernels need. The scalar pack (width 1) handles every T and the
+// loop tails.
+template <typename T, simd_level L> struct simd_pack {
+    static constexpr std::size_t width = 1;
+    T v;
+
+    [[nodiscard]] static simd_pack load(const T *p) noexcept { return {*p}; }
+    [[nodiscard]] static simd_pack broadcast(T x) noexcept { return {x}; }
+    void store(T *p) const noexcept { *p = v; }
+
+    [[nodiscard]] friend simd_pack operator+(simd_pack a,
+                                             simd_pack b) noexcept {
+        return {a.v + b.v};
+    }
+    [[nodiscard]] friend simd_pack operator-(simd_pack a,
+                                             simd_pack b) noexcept {
+        return {a.v - b.v};
+    }
+    [[nodiscard]] friend simd_pack operator*(simd_pack a,
+                                             simd_pack b) noexcept {
+        return {a.v * b.v};
+    }
+    [[nodiscard]] friend simd_pack operator/(simd_pack a,
+                                             simd_pack b) noexcept {
+        return {a.v / b.v};
+    }
+    [[nodiscard]] friend simd_pack sqrt(simd_pack a) noexcept {
+        using std::sqrt;
+        return {sqrt(a.v)};
+    }
+    // 1 / sqrt(a). Vector packs may refine a hardware estimate: within a few
+    // ulp for positive finite a, but not correctly rounded.
+    [[nodiscard]] friend simd_pack rsqrt(simd_pack a) noexcept {
+        using std::sqrt;
+        return {T(1) / sqrt(a.v)};
+    }
+};
+
+// Runs Op::apply<P>(i, args...) for every full pack of [0, n) and the
+// scalar pack for the tail. Force-inlined, like Op::apply, so the whole loop
+// lands in the entry point compiled for P's instruction set.
+template <typename P, typename Op, typename T, typename... Args>
+PHYSI_FORCE_INLINE void simd_loop(std::size_t n, const Args &...args) noexcept {
+    std::size_t i = 0;
+    if constexpr (P::width > 1) {
+        for (; i + P::width <= n; i += P::width) {
+            Op::template apply<P>(i, args...);
+        }
+    }
+    for (; i < n; ++i) {
+        Op::template apply<simd_pack<T, simd_level::scalar>>(i, args...);
+    }
+}
+
+#if PHYSI_HAS_SIMD_DISPATCH
+// Newton-Raphson refinement y <- y * (1.5 - 0.5 * x * y^2) of an estimate y
+// of 1 / sqrt(x); each step doubles the correct bits.
+template <int Steps, typename T, typename P>
+[[nodiscard]] PHYSI_FORCE_INLINE P refine_rsqrt(const P &x,
+                                                const P &estimate) noexcept {
+    const P half_x = P::broadcast(T(0.5)) * x;
+    P y = estimate;
+    const P three_halves = P::broadcast(T(1.5));
+    for (int k = 0; k < Steps; ++k) {
+        y = y * (three_halves - half_x * y * y);
+    }
+    return y;
+}
+
+// One specialization per (scalar, level); `pre` and `sfx` spell the
+// intrinsic family, e.g. _mm256_add_ps. `root` is the square root of a.v and
+// `rroot` its reciprocal.
+#define PHYSI_SIMD_PACK(T, L, isa, reg, pre, sfx, root, rroot)                 \
+    template <> struct simd_pack<T, simd_level::L> {                           \
+        static constexpr std::size_t width = sizeof(reg) / sizeof(T);          \
+        reg v;                                                                 \
+                                                                               \
+        [[nodiscard, gnu::target(isa)]] static simd_pack                       \
+        load(const T *p) noexcept {                                            \
+            return {pre##_loadu_##sfx(p)};                                     \
+        }                                                                      \
+        [[nodiscard, gnu::target(isa)]] static simd_pack                       \
+        broadcast(T x) noexcept {                                              \
+            return {pre##_set1_##sfx(x)};                                      \
+        }                                                                      \
+        [[gnu::target(isa)]] void store(T *p) const noexcept {                 \
+            pre##_storeu_##sfx(p, v);                                          \
+        }                                                                      \
+        [[nodiscard, gnu::target(isa)]] friend simd_pack                       \
+        operator+(simd_pack a, simd_pack b) noexcept {                         \
+            return {pre##_add_##sfx(a.v, b.v)};                                \
+        }                                                                      \
+        [[nodiscard, gnu::target(isa)]] friend simd_pack                       \
+        operator-(simd_pack a, simd_pack b) noexcept {                         \
+            return {pre##_sub_##sfx(a.v, b.v)};                                \
+        }                                                                      \
+        [[nodiscard, gnu::target(isa)]] friend simd_pack                       \
+        operator*(simd_pack a, simd_pack b) noexcept {                         \
+            return {pre##_mul_##sfx(a.v, b.v)};                                \
+        }                                                                      \
+        [[nodiscard, gnu::target(isa)]] friend simd_pack                       \
+        operator/(simd_pack a, simd_pack b) noexcept {                         \
+            return {pre##_div_##sfx(a.v, b.v)};                                \
+        }                                                                      \
+        [[nodiscard, gnu::target(isa)]] friend simd_pack                       \
+        sqrt(simd_pack a) noexcept {                                           \
+            return {root};                                                     \
+        }                                                                      \
+        [[nodiscard, gnu::target(isa)]] friend simd_pack                       \
+        rsqrt(simd_pack a) noexcept {                                          \
+            return rroot;                                                      \
+        }                                                                      \
+    };
+
+// The hardware estimates give 12 (rsqrt_ps) or 14 (rsqrt14) bits; AVX2 has
+// no double estimate, so that pack divides.
+PHYSI_SIMD_PACK(float, avx2, "avx2,fma", __m256, _mm256, ps,
+                _mm256_sqrt_ps(a.v),
+                (refine_rsqrt<1, float>(a, simd_pack{_mm256_rsqrt_ps(a.v)})))
+PHYSI_SIMD_PACK(double, avx2, "avx2,fma", __m256d, _mm256, pd,
+                _mm256_sqrt_pd(a.v),
+                (simd_pack{_mm256_div_pd(_mm256_set1_pd(1.0),
+                                         _mm256_sqrt_pd(a.v))}))
+// (the masked forms: GCC 12 flags the plain intrinsics' undefined
+// passthrough)
+PHYSI_SIMD_PACK(float, avx512, "avx512f", __m512, _mm512, ps,
+                _mm512_mask_sqrt_ps(a.v, 0xffff, a.v),
+                (refine_rsqrt<1, float>(
+                    a, simd_pack{_mm512_mask_rsqrt14_ps(a.v, 0xffff, a.v)})))
+PHYSI_SIMD_PACK(double, avx512, "avx512f", __m512d, _mm512, pd,
+                _mm512_mask_sqrt_pd(a.v, 0xff, a.v),
+                (refine_rsqrt<2, double>(
+                    a, simd_pack{_mm512_mask_rsqrt14_pd(a.v, 0xff, a.v)})))
+
+#undef PHYSI_SIMD_PACK
+
+// Entry points compiled for each level; the loop, the kernel and the pack
+// operations are all inlined into them, so wide registers never cross a
+// call into code built without that instruction set.
+template <typename Op, typename T, typename... Args>
+[[gnu::target("avx2,fma"), gnu::flatten]] void
+simd_loop_avx2(std::size_t n, const Args &...args) noexcept {
+    simd_loop<simd_pack<T, simd_level::avx2>, Op, T>(n, args...);
+}
+
+template <typename Op, typename T, typename... Args>
+[[gnu::target("avx512f"), gnu::flatten]] void
+simd_loop_avx512(std::size_t n, const Args &...args) noexcept {
+    simd_loop<simd_pack<T, simd_level::avx512>, Op, T>(n, args...);
+}
+#endif
+
+// Scalars with vector packs; everything else runs the scalar pack only.
+template <typename T>
+inline constexpr bool simd_packable =
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Runs Op over [0, n) with the widest pack the CPU supports. Op is a struct
+// with a force-inlined `template <typename P> static void apply(i, args...)`
+// that processes rows [i, i + P::width).
+template <typename Op, typename T, typename... Args>
+void simd_for(std::size_t n, const Args &...args) noexcept {
+#if PHYSI_HAS_SIMD_DISPATCH
+    if constexpr (simd_packable<T>) {
+        switch (cpu_simd_level()) {
+        case simd_level::avx512:
+            simd_loop_avx512<Op, T>(n, args...);
+            return;
+        case simd_level::avx2:
+            simd_loop_avx2<Op, T>(n, args...);
+            return;
+        case simd_level::scalar:
+            break;
+        }
+    }
+#endif
+    simd_loop<simd_pack<T, simd_level::scalar>, Op, T>(n, args...);
+}
+
+} // namespace detail
+
+} // namespace physi
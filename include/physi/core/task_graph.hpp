@@ -0,0 +1,377 @@
+#pragma once
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Frame stages scheduled from the data they touch:
+//
+//   task_graph frame;
+//   frame.stage("forces")
+//       .reads(positions, masses)
+//       .writes(accelerations)
+//       .run([&] { accelerations = tree.accelerations(); });
+//   frame.stage("integrate")
+//       .reads(accelerations)
+//       .writes(positions, velocities)
+//       .parallel(positions.size(), [&](std::size_t begin, std::size_t end) {
+//           /* rows [begin, end) */
+//       });
+//   frame.run();                            // "integrate" waits for "forces"
+//   task_graph_path slow = frame.critical_path();
+//
+// Stages are declared in the order a serial frame would run them. A stage
+// depends on every earlier stage that writes something it reads or writes,
+// or reads something it writes, so a run gives the same results as running
+// the stages one after another, while stages with disjoint data run side by
+// side. Data is identified by address: pass the arrays themselves, not
+// copies. Hidden dependencies can be added with after().
+//
+// A parallel() stage splits its rows into chunks (`threads`, 0 = one per
+// hardware thread) that run as separate pool tasks. Every run records when
+// each stage started and how long it took, and critical_path() picks the
+// chain of dependent stages that bounded the frame.
+
+namespace physi {
+
+struct task_graph_config {
+    // Chunks per parallel() stage (0 = one per hardware thread)
+    std::size_t threads = 0;
+};
+
+// When a stage ran during the last task_graph::run(), relative to its start
+struct stage_timing {
+    std::chrono::nanoseconds start{0};
+    std::chrono::nanoseconds duration{0};
+};
+
+// The chain of dependent stages with the largest summed duration
+struct task_graph_path {
+    std::vector<std::size_t> stages;
+    std::chrono::nanoseconds length{0};
+};
+
+class task_graph {
+    using clock = std::chrono::steady_clock;
+
+    struct stage_data {
+        std::string name;
+        std::vector<const void *> reads;
+        std::vector<const void *> writes;
+        std::vector<std::size_t> after;
+        std::vector<std::size_t> dependencies;
+        std::vector<std::size_t> successors;
+        // Row count of a parallel() stage; empty for a single task
+        std::function<std::size_t()> rows;
+        std::function<void(std::size_t, std::size_t)> body;
+    };
+
+  public:
+    using config = task_graph_config;
+
+    // Collects one stage's data accesses; run() or parallel() adds it.
+    class stage_builder {
+      public:
+        template <typename... Data>
+        stage_builder &reads(const Data &...data) {
+            (stage_.reads.push_back(std::addressof(data)), ...);
+            return *this;
+        }
+
+        template <typename... Data>
+        stage_builder &writes(const Data &...data) {
+            (stage_.writes.push_back(std::addressof(data)), ...);
+            return *this;
+        }
+
+        // Explicit dependency on an earlier stage
+        stage_builder &after(std::size_t id) {
+            assert(id < graph_->stages_.size() && "unknown stage");
+            stage_.after.push_back(id);
+            return *this;
+        }
+
+        // A single task; returns the stage id.
+        template <typename F>
+            requires std::invocable<F &>
+        std::size_t run(F f) {
+            stage_.body = [f = std::move(f)](std::size_t, std::size_t) mutable {
+                f();
+            };
+            return graph_->add(std::move(stage_));
+        }
+
+        // f(begin, end) over the rows [0, rows), in chunks. `rows` is a count
+        // or a callable returning one, evaluated each time the stage starts.
+        template <typename Rows, typename F>
+            requires std::invocable<F &, std::size_t, std::size_t>
+        std::size_t parallel(Rows rows, F f) {
+            if constexpr (std::is_invocable_r_v<std::size_t, Rows &>) {
+                stage_.rows = std::move(rows);
+            } else {
+                stage_.rows = [n = static_cast<std::size_t>(rows)] {
+                    return n;
+                };
+            }
+            stage_.body = std::move(f);
+            return graph_->add(std::move(stage_));
+        }
+
+      private:
+        friend class task_graph;
+
+        stage_builder(task_graph &graph, std::string name) : graph_(&graph) {
+            stage_.name = std::move(name);
+        }
+
+        task_graph *graph_;
+        stage_data stage_;
+    };
+
+    explicit task_graph(config cfg = {},
+                        thread_pool &pool = thread_pool::shared())
+        : config_(cfg), pool_(&pool) {}
+
+    task_graph(const task_graph &) = delete;
+    task_graph &operator=(const task_graph &) = delete;
+
+    // ========== Building ==========
+    [[nodiscard]] stage_builder stage(std::string name) {
+        return stage_builder(*this, std::move(name));
+    }
+
+    // ========== Running ==========
+    // Runs every stage once and returns when all have finished. If a stage
+    // throws, stages not yet started are skipped and the first exception is
+    // rethrown.
+    void run() {
+        const std::size_t n = stages_.size();
+        if (states_.size() != n) {
+            states_ = std::vector<stage_state>(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                states_[i].graph = this;
+                states_[i].id = i;
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            states_[i].pending.store(stages_[i].dependencies.size(),
+                                     std::memory_order_relaxed);
+            states_[i].started.store(false, std::memory_order_relaxed);
+        }
+        failed_.store(false, std::memory_order_relaxed);
+        error_ = nullptr;
+        remaining_.store(n, std::memory_order_relaxed);
+
+        origin_ = clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            if (stages_[i].dependencies.empty()) {
+                launch(i);
+            }
+        }
+        pool_->wait_until([this] {
+            return remaining_.load(std::memory_order_acquire) == 0;
+        });
+        wall_time_ = clock::now() - origin_;
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    // ========== Inspection ==========
+    [[nodiscard]] std::size_t size() const noexcept { return stages_.size(); }
+
+    [[nodiscard]] std::string_view name(std::size_t id) const noexcept {
+        return stages_[id].name;
+    }
+
+    // Earlier stages this one waits for, in increasing order
+    [[nodiscard]] const std::vector<std::size_t> &
+    dependencies(std::size_t id) const noexcept {
+        return stages_[id].dependencies;
+    }
+
+    // ========== Timings of the last run ==========
+    [[nodiscard]] stage_timing timing(std::size_t id) const noexcept {
+        if (id >= states_.size()) {
+            return {};
+        }
+        const stage_state &s = states_[id];
+        return {s.start - origin_, s.end - s.start};
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds wall_time() const noexcept {
+        return wall_time_;
+    }
+
+    // No run can finish faster than its critical path, however many threads
+    // it gets; wall_time() well above length() means stages were waiting
+    // for threads.
+    [[nodiscard]] task_graph_path critical_path() const {
+        const std::size_t n = std::min(states_.size(), stages_.size());
+        task_graph_path path;
+        if (n == 0) {
+            return path;
+        }
+        // Dependencies always point to earlier stages, so id order is a
+        // topological order.
+        std::vector<std::chrono::nanoseconds> finish(n);
+        std::vector<std::size_t> previous(n, n);
+        std::size_t last = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            std::chrono::nanoseconds before{0};
+            for (const std::size_t d : stages_[i].dependencies) {
+                if (finish[d] > before) {
+                    before = finish[d];
+                    previous[i] = d;
+                }
+            }
+            finish[i] = before + timing(i).duration;
+            if (finish[i] > finish[last]) {
+                last = i;
+            }
+        }
+        path.length = finish[last];
+        for (std::size_t i = last; i != n; i = previous[i]) {
+            path.stages.push_back(i);
+        }
+        std::reverse(path.stages.begin(), path.stages.end());
+        return path;
+    }
+
+    [[nodiscard]] const config &settings() const noexcept { return config_; }
+
+  private:
+    struct stage_state {
+        task_graph *graph = nullptr;
+        std::size_t id = 0;
+        std::atomic<std::size_t> pending{0};
+        std::atomic<std::size_t> chunks_left{0};
+        std::atomic<bool> started{false};
+        std::size_t rows = 0;
+        std::size_t chunks = 0;
+        clock::time_point start{};
+        clock::time_point end{};
+    };
+
+    [[nodiscard]] static bool overlaps(const std::vector<const void *> &a,
+                                       const std::vector<const void *> &b) {
+        return std::any_of(a.begin(), a.end(), [&b](const void *p) {
+            return std::find(b.begin(), b.end(), p) != b.end();
+        });
+    }
+
+    std::size_t add(stage_data s) {
+        const std::size_t id = stages_.size();
+        s.dependencies = std::move(s.after);
+        for (std::size_t i = 0; i < id; ++i) {
+            const stage_data &earlier = stages_[i];
+            if (overlaps(earlier.writes, s.reads) ||
+                overlaps(earlier.writes, s.writes) ||
+                overlaps(earlier.reads, s.writes)) {
+                s.dependencies.push_back(i);
+            }
+        }
+        auto &deps = s.dependencies;
+        std::sort(deps.begin(), deps.end());
+        deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+        for (const std::size_t d : s.dependencies) {
+            stages_[d].successors.push_back(id);
+        }
+        stages_.push_back(std::move(s));
+        return id;
+    }
+
+    // Called once a stage's dependencies have finished.
+    void launch(std::size_t id) {
+        stage_state &s = states_[id];
+        const stage_data &stage = stages_[id];
+        s.rows = 1;
+        s.chunks = 1;
+        if (failed_.load(std::memory_order_relaxed)) {
+            s.chunks = 0;
+        } else if (stage.rows) {
+            try {
+                s.rows = stage.rows();
+            } catch (...) {
+                fail(std::current_exception());
+                s.rows = 0;
+            }
+            const std::size_t threads = config_.threads == 0
+                                            ? default_thread_count()
+                                            : config_.threads;
+            s.chunks = std::min(threads, s.rows);
+        }
+        if (s.chunks == 0) {
+            s.start = clock::now();
+            finish(id);
+            return;
+        }
+        s.chunks_left.store(s.chunks, std::memory_order_relaxed);
+        pool_->submit(&run_chunk, &s, 0, s.chunks);
+    }
+
+    static void run_chunk(void *context, std::size_t chunk) {
+        stage_state &s = *static_cast<stage_state *>(context);
+        task_graph &graph = *s.graph;
+        if (!s.started.exchange(true, std::memory_order_relaxed)) {
+            s.start = clock::now();
+        }
+        if (!graph.failed_.load(std::memory_order_relaxed)) {
+            try {
+                graph.stages_[s.id].body(s.rows * chunk / s.chunks,
+                                         s.rows * (chunk + 1) / s.chunks);
+            } catch (...) {
+                graph.fail(std::current_exception());
+            }
+        }
+        if (s.chunks_left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            graph.finish(s.id);
+        }
+    }
+
+    void finish(std::size_t id) {
+        states_[id].end = clock::now();
+        for (const std::size_t next : stages_[id].successors) {
+            if (states_[next].pending.fetch_sub(
+                    1, std::memory_order_acq_rel) == 1) {
+                launch(next);
+            }
+        }
+        // run() may return, and the graph go away, once this reaches zero.
+        thread_pool *pool = pool_;
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pool->notify();
+        }
+    }
+
+    void fail(std::exception_ptr e) {
+        if (!failed_.exchange(true, std::memory_order_acq_rel)) {
+            error_ = std::move(e);
+        }
+    }
+
+    config config_;
+    thread_pool *pool_;
+    std::vector<stage_data> stages_;
+    std::vector<stage_state> states_;
+    std::atomic<std::size_t> remaining_{0};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+    clock::time_point origin_{};
+    std::chrono::nanoseconds wall_time_{0};
+};
+
+} // namespace physi
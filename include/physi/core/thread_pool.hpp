@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// A fixed set of worker threads fed from one FIFO queue:
+//
+//   thread_pool &pool = thread_pool::shared();
+//   pool.run(chunks, [&](std::size_t c) { /* ... */ });   // blocks
+//
+// A thread that waits on the pool runs queued tasks instead of sleeping, so
+// pool work may itself wait on nested pool work without deadlocking, and a
+// pool without workers runs everything on the waiting thread. parallel_for
+// and task_graph share the process-wide pool, so stages running side by
+// side split its threads rather than each spawning their own.
+
+namespace physi {
+
+// Number of worker threads used when a caller passes 0. Queried once:
+// hardware_concurrency() reads the system CPU list on every call.
+[[nodiscard]] inline std::size_t default_thread_count() noexcept {
+    static const std::size_t count =
+        std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    return count;
+}
+
+class thread_pool {
+  public:
+    // A queued call run(context, index). The pool does not own the context;
+    // whoever submits keeps it alive until the call has returned. Tasks must
+    // not throw.
+    struct task {
+        void (*run)(void *, std::size_t) = nullptr;
+        void *context = nullptr;
+        std::size_t index = 0;
+    };
+
+    // `workers` background threads; the threads waiting on the pool supply
+    // the rest of its concurrency.
+    explicit thread_pool(std::size_t workers) {
+        threads_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) {
+            threads_.emplace_back([this] { work(); });
+        }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    // Queued tasks still run; the workers are joined once the queue is empty.
+    ~thread_pool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+    }
+
+    // Process-wide pool: one worker per hardware thread besides the caller.
+    [[nodiscard]] static thread_pool &shared() {
+        static thread_pool pool(default_thread_count() - 1);
+        return pool;
+    }
+
+    [[nodiscard]] std::size_t workers() const noexcept {
+        return threads_.size();
+    }
+
+    // ========== Submission ==========
+    // Queues run(context, first) ... run(context, first + count - 1).
+    void submit(void (*run)(void *, std::size_t), void *context,
+                std::size_t first, std::size_t count) {
+        if (count == 0) {
+            return;
+        }
+        {
+            std::lock_guard lock(mutex_);
+            for (std::size_t i = 0; i < count; ++i) {
+                queue_.push_back({run, context, first + i});
+            }
+        }
+        if (count == 1) {
+            wake_.notify_one();
+        } else {
+            wake_.notify_all();
+        }
+    }
+
+    // Runs queued tasks on the calling thread until done() holds. Whatever
+    // makes done() true must call notify() afterwards.
+    template <typename Done> void wait_until(Done done) {
+        std::unique_lock lock(mutex_);
+        while (!done()) {
+            if (queue_.empty()) {
+                wake_.wait(lock);
+                continue;
+            }
+            const task t = queue_.front();
+            queue_.pop_front();
+            lock.unlock();
+            t.run(t.context, t.index);
+            lock.lock();
+        }
+    }
+
+    // Wakes the threads blocked in wait_until() to re-check their condition.
+    void notify() {
+        // Taking the lock orders the caller's update before any waiter's
+        // next check, so the wake-up cannot be lost.
+        { std::lock_guard lock(mutex_); }
+        wake_.notify_all();
+    }
+
+    // ========== Data-parallel loops ==========
+    // Calls f(i) for every i in [0, count) on the pool and the calling
+    // thread, returning once all calls have finished. The first exception
+    // thrown is rethrown after that.
+    template <typename F> void run(std::size_t count, F &&f) {
+        if (count <= 1 || threads_.empty()) {
+            for (std::size_t i = 0; i < count; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        struct batch {
+            std::remove_reference_t<F> *f;
+            thread_pool *pool;
+            std::atomic<std::size_t> remaining;
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+        } b{&f, this, count, false, nullptr};
+
+        const auto call = [](void *context, std::size_t i) {
+            auto &b = *static_cast<batch *>(context);
+            try {
+                (*b.f)(i);
+            } catch (...) {
+                if (!b.failed.exchange(true, std::memory_order_relaxed)) {
+                    b.error = std::current_exception();
+                }
+            }
+            // b may be gone as soon as the count reaches zero.
+            thread_pool *pool = b.pool;
+            if (b.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                pool->notify();
+            }
+        };
+
+        submit(call, &b, 1, count - 1);
+        call(&b, 0);
+        wait_until([&b] {
+            return b.remaining.load(std::memory_order_acquire) == 0;
+        });
+        if (b.error) {
+            std::rethrow_exception(b.error);
+        }
+    }
+
+  private:
+    void work() {
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            const task t = queue_.front();
+            queue_.pop_front();
+            lock.unlock();
+            t.run(t.context, t.index);
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<task> queue_;
+    bool stopping_ = false;
+    // Last, so the workers are joined before the queue goes away.
+    std::vector<std::jthread> threads_;
+};
+
+} // namespace physi
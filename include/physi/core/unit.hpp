@@ -0,0 +1,132 @@
+#pragma once
+
+#include "loop_hints.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace physi {
+
+// Runtime description of a unit generated by PHYSI_UNIT / PHYSI_UNIT_INCREASE:
+//   base = (value + offset) * scale
+// Plain units have offset 0; affine ones (°C, °F) carry their shift.
+struct unit_info {
+    std::string_view name;
+    long double scale = 1.0L;
+    long double offset = 0.0L;
+};
+
+namespace detail {
+
+// Slot type keyed on the source line of each PHYSI_UNIT, so a quantity can
+// enumerate its units between PHYSI_QUANTITY_BEGIN and PHYSI_QUANTITY_END.
+template <int Line> struct unit_line {};
+
+template <typename Q, int Line>
+concept unit_at = requires { Q::physi_unit_(unit_line<Line>{}); };
+
+template <typename Q, int First, int... I>
+constexpr auto collect_units(std::integer_sequence<int, I...>) {
+    constexpr std::size_t count =
+        (std::size_t{0} + ... + (unit_at<Q, First + I> ? 1u : 0u));
+    std::array<unit_info, count> table{};
+    std::size_t n = 0;
+    (
+        [&] {
+            if constexpr (unit_at<Q, First + I>) {
+                table[n++] = Q::physi_unit_(unit_line<First + I>{});
+            }
+        }(),
+        ...);
+    return table;
+}
+
+template <typename Q, int First, int Last>
+inline constexpr auto unit_table =
+    collect_units<Q, First>(std::make_integer_sequence<int, Last - First>{});
+
+[[nodiscard]] constexpr std::optional<unit_info>
+find_unit(std::span<const unit_info> table, std::string_view name) noexcept {
+    for (const auto &u : table) {
+        if (u.name == name) {
+            return u;
+        }
+    }
+    return std::nullopt;
+}
+
+// out[i] = in[i] * mul + add, one vectorizable pass. The add is skipped for
+// plain (non-affine) units so they stay a single multiply.
+template <typename T>
+void affine_map(const T *in, T *out, std::size_t n, T mul, T add) noexcept {
+    if (add == T(0)) {
+        PHYSI_IVDEP
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = in[i] * mul;
+        }
+    } else {
+        PHYSI_IVDEP
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = in[i] * mul + add;
+        }
+    }
+}
+
+// Unit values -> base quantities: (v + offset) * scale.
+template <typename Q, typename T>
+void convert_from(std::span<const T> in, std::span<Q> out,
+                  const unit_info &unit) noexcept {
+    static_assert(sizeof(Q) == sizeof(T), "Q must be stored as a bare T");
+    assert(in.size() == out.size());
+    affine_map(in.data(), reinterpret_cast<T *>(out.data()), in.size(),
+               static_cast<T>(unit.scale),
+               static_cast<T>(unit.offset * unit.scale));
+}
+
+// Base quantities -> unit values: base * (1 / scale) - offset, with the
+// reciprocal folded once in long double instead of a division per element.
+template <typename Q, typename T>
+void convert_to(std::span<const Q> in, std::span<T> out,
+                const unit_info &unit) noexcept {
+    static_assert(sizeof(Q) == sizeof(T), "Q must be stored as a bare T");
+    assert(in.size() == out.size());
+    affine_map(reinterpret_cast<const T *>(in.data()), out.data(), in.size(),
+               static_cast<T>(1.0L / unit.scale), static_cast<T>(-unit.offset));
+}
+
+} // namespace detail
+
+// ========== Bulk conversion ==========
+
+// Compile-time unit tag, e.g. to_unit(lengths, length_d::ft_unit{}, feet).
+template <typename Unit>
+void to_unit(std::span<const typename Unit::quantity_type> in, Unit,
+             std::span<typename Unit::quantity_type::value_type> out) noexcept {
+    detail::convert_to(in, out, Unit::info);
+}
+
+template <typename Unit>
+void from_unit(std::span<const typename Unit::quantity_type::value_type> in,
+               Unit, std::span<typename Unit::quantity_type> out) noexcept {
+    detail::convert_from(in, out, Unit::info);
+}
+
+// Runtime unit, e.g. one looked up by name with Q::find_unit("ft").
+template <typename Q>
+void to_unit(std::span<const Q> in, const unit_info &unit,
+             std::span<typename Q::value_type> out) noexcept {
+    detail::convert_to(in, out, unit);
+}
+
+template <typename Q>
+void from_unit(std::span<const typename Q::value_type> in,
+               const unit_info &unit, std::span<Q> out) noexcept {
+    detail::convert_from(in, out, unit);
+}
+
+} // namespace physi
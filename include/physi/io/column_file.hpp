@@ -0,0 +1,559 @@
+#pragma once
+
+#include "../array/quantity_array.hpp"
+#include "../array/vec_array.hpp"
+#include "../core/dimension.hpp"
+#include "../core/simd.hpp"
+#include "error.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PHYSI_HAS_MMAP 1
+#else
+#define PHYSI_HAS_MMAP 0
+#endif
+
+// Columnar binary format for quantity data, read back through mmap.
+//
+//   column_file_writer out;
+//   out.add("time", t).add("position", pos);   // quantity_array / vec_array
+//   out.write("dump.phc");
+//
+//   auto in = column_file::open("dump.phc", {column_spec::of<time_d>("time"),
+//                                            column_spec::of<length_f, 3>(
+//                                                "position")});
+//   std::span<const time_d> t = in.column<time_d>("time");     // zero-copy
+//   auto [x, y, z] = in.vec_column<length_f, 3>("position");
+//
+// Layout (native byte order, checked on open):
+//   64-byte file header: magic, version, byte-order mark, rows, columns
+//   64-byte descriptor per column: name, dimension exponents (L M T I Θ N J),
+//     scalar kind and size, vector width, data offset
+//   data: each column (each vec component, structure-of-arrays) is one
+//     contiguous run of `rows` scalars starting on a simd_alignment boundary
+//
+// Opening with a schema rejects missing columns and dimension, precision or
+// width mismatches up front; typed access re-checks the single column.
+
+namespace physi {
+
+// Stored scalar type of a column (the _f / _d / _ld precision).
+enum class column_scalar : std::uint8_t {
+    float32 = 1,
+    float64 = 2,
+    extended = 3, // long double
+};
+
+// What a column holds: name, dimension, scalar and vector width.
+struct column_spec {
+    std::string name;
+    std::array<std::int8_t, 7> dimension{};
+    column_scalar scalar = column_scalar::float64;
+    std::uint8_t scalar_size = sizeof(double);
+    std::uint8_t components = 1;
+
+    // Spec of a quantity_array<Q> (N == 1) or vec_array<Q, N> column.
+    template <typename Quantity, int N = 1>
+    [[nodiscard]] static column_spec of(std::string name);
+
+    [[nodiscard]] bool same_layout(const column_spec &other) const noexcept {
+        return dimension == other.dimension && scalar == other.scalar &&
+               scalar_size == other.scalar_size &&
+               components == other.components;
+    }
+
+    // e.g. "L1 M1 T-2 x3 f32", for error messages
+    [[nodiscard]] std::string describe() const {
+        static constexpr const char *symbols[7] = {"L", "M", "T", "I",
+                                                   "Θ", "N", "J"};
+        std::string out;
+        for (std::size_t i = 0; i < 7; ++i) {
+            if (dimension[i] != 0) {
+                out += symbols[i] + std::to_string(dimension[i]) + " ";
+            }
+        }
+        if (out.empty()) {
+            out = "dimensionless ";
+        }
+        if (components > 1) {
+            out += "x" + std::to_string(components) + " ";
+        }
+        out += scalar == column_scalar::float32   ? "f32"
+               : scalar == column_scalar::float64 ? "f64"
+                                                  : "ld";
+        return out;
+    }
+};
+
+namespace detail {
+
+template <typename T> constexpr column_scalar column_scalar_of() {
+    static_assert(std::is_floating_point_v<T>,
+                  "column files store float, double or long double");
+    if constexpr (std::is_same_v<T, float>) {
+        return column_scalar::float32;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return column_scalar::float64;
+    } else {
+        return column_scalar::extended;
+    }
+}
+
+template <typename Dim>
+constexpr std::array<std::int8_t, 7> dimension_exponents() noexcept {
+    return {Dim::length, Dim::mass, Dim::time, Dim::current,
+            Dim::temperature, Dim::amount, Dim::luminous_intensity};
+}
+
+template <typename Quantity>
+constexpr std::array<std::int8_t, 7> dimension_exponents_of() noexcept {
+    if constexpr (std::is_arithmetic_v<Quantity>) {
+        return {};
+    } else {
+        return dimension_exponents<dimension_of_t<Quantity>>();
+    }
+}
+
+inline constexpr char column_file_magic[8] = {'P', 'H', 'Y', 'S',
+                                              'I', 'C', 'O', 'L'};
+inline constexpr std::uint32_t column_file_version = 1;
+inline constexpr std::uint32_t column_file_byte_order = 0x01020304u;
+
+struct column_file_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t rows;
+    std::uint32_t columns;
+    std::uint8_t reserved[36];
+};
+static_assert(sizeof(column_file_header) == 64);
+
+struct column_descriptor {
+    char name[40]; // nul-padded
+    std::int8_t dimension[7];
+    std::uint8_t scalar;
+    std::uint8_t scalar_size;
+    std::uint8_t components;
+    std::uint8_t reserved[6];
+    std::uint64_t offset; // first component, from the start of the file
+};
+static_assert(sizeof(column_descriptor) == 64);
+
+// Bytes between consecutive components of a vec column.
+[[nodiscard]] constexpr std::uint64_t
+column_stride(std::uint64_t rows, std::uint64_t scalar_size) noexcept {
+    const std::uint64_t bytes = rows * scalar_size;
+    return (bytes + simd_alignment - 1) / simd_alignment * simd_alignment;
+}
+
+// Byte size a scalar kind is written with, or 0 for an unknown kind.
+[[nodiscard]] constexpr std::uint8_t
+column_scalar_size(column_scalar scalar) noexcept {
+    switch (scalar) {
+    case column_scalar::float32:
+        return sizeof(float);
+    case column_scalar::float64:
+        return sizeof(double);
+    case column_scalar::extended:
+        return sizeof(long double);
+    }
+    return 0;
+}
+
+// Whether `components` strides of `rows` scalars from `offset` end within
+// `size` bytes. Every step is checked, so a corrupt header cannot wrap the
+// arithmetic around into a small, valid-looking end.
+[[nodiscard]] constexpr bool
+column_fits(std::uint64_t offset, std::uint64_t rows,
+            std::uint64_t scalar_size, std::uint64_t components,
+            std::uint64_t size) noexcept {
+    constexpr std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+    if (scalar_size == 0 || components == 0 || offset > size ||
+        rows > (max - (simd_alignment - 1)) / scalar_size) {
+        return false;
+    }
+    return column_stride(rows, scalar_size) <= (size - offset) / components;
+}
+
+// Read-only view of a whole file: mmap where available, else a copy.
+class mapped_file {
+  public:
+    mapped_file() = default;
+
+    explicit mapped_file(const std::string &path) {
+#if PHYSI_HAS_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw io_error("column file: cannot open '" + path + "'");
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw io_error("column file: cannot stat '" + path + "'");
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void *p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw io_error("column file: cannot map '" + path + "'");
+            }
+            data_ = static_cast<const std::byte *>(p);
+        }
+        ::close(fd);
+#else
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            throw io_error("column file: cannot open '" + path + "'");
+        }
+        std::byte chunk[1 << 16];
+        std::size_t got = 0;
+        while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            copy_.insert(copy_.end(), chunk, chunk + got);
+        }
+        std::fclose(file);
+        data_ = copy_.data();
+        size_ = copy_.size();
+#endif
+    }
+
+    mapped_file(mapped_file &&other) noexcept { swap(other); }
+    mapped_file &operator=(mapped_file &&other) noexcept {
+        mapped_file(std::move(other)).swap(*this);
+        return *this;
+    }
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    ~mapped_file() {
+#if PHYSI_HAS_MMAP
+        if (data_ != nullptr) {
+            ::munmap(const_cast<std::byte *>(data_), size_);
+        }
+#endif
+    }
+
+    [[nodiscard]] const std::byte *data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  private:
+    const std::byte *data_ = nullptr;
+    std::size_t size_ = 0;
+#if !PHYSI_HAS_MMAP
+    std::vector<std::byte, aligned_allocator<std::byte>> copy_;
+#endif
+
+    void swap(mapped_file &other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#if !PHYSI_HAS_MMAP
+        std::swap(copy_, other.copy_);
+#endif
+    }
+};
+
+} // namespace detail
+
+template <typename Quantity, int N>
+column_spec column_spec::of(std::string name) {
+    using T = scalar_type_t<Quantity>;
+    static_assert(sizeof(Quantity) == sizeof(T),
+                  "Quantity must be stored as a bare scalar");
+    static_assert(N >= 1 && N <= 4, "vector width must be 1 to 4");
+    column_spec spec;
+    spec.name = std::move(name);
+    spec.dimension = detail::dimension_exponents_of<Quantity>();
+    spec.scalar = detail::column_scalar_of<T>();
+    spec.scalar_size = sizeof(T);
+    spec.components = static_cast<std::uint8_t>(N);
+    return spec;
+}
+
+// ========== Reader ==========
+
+class column_file {
+  public:
+    // Maps `path` and validates its header and column table.
+    [[nodiscard]] static column_file open(const std::string &path) {
+        column_file file;
+        file.path_ = path;
+        file.map_ = detail::mapped_file(path);
+        file.parse();
+        return file;
+    }
+
+    // As open(path), and also checks that every column in `schema` exists
+    // with exactly that dimension, precision and width.
+    [[nodiscard]] static column_file
+    open(const std::string &path, std::initializer_list<column_spec> schema) {
+        column_file file = open(path);
+        for (const auto &expected : schema) {
+            file.find(expected);
+        }
+        return file;
+    }
+
+    [[nodiscard]] std::size_t rows() const noexcept { return rows_; }
+    [[nodiscard]] const std::vector<column_spec> &columns() const noexcept {
+        return specs_;
+    }
+
+    // Zero-copy view of a quantity_array-style column.
+    template <typename Quantity>
+    [[nodiscard]] std::span<const Quantity>
+    column(std::string_view name) const {
+        const std::size_t i =
+            find(column_spec::of<Quantity>(std::string(name)));
+        return component<Quantity>(i, 0);
+    }
+
+    // Zero-copy views of the N component columns of a vec_array column.
+    template <typename Quantity, int N>
+    [[nodiscard]] std::array<std::span<const Quantity>, N>
+    vec_column(std::string_view name) const {
+        const std::size_t i =
+            find(column_spec::of<Quantity, N>(std::string(name)));
+        std::array<std::span<const Quantity>, N> out;
+        for (int c = 0; c < N; ++c) {
+            out[c] = component<Quantity>(i, c);
+        }
+        return out;
+    }
+
+  private:
+    std::string path_;
+    detail::mapped_file map_;
+    std::size_t rows_ = 0;
+    std::vector<column_spec> specs_;
+    std::vector<std::uint64_t> offsets_;
+
+    [[noreturn]] void fail(const std::string &what) const {
+        throw io_error("column file '" + path_ + "': " + what);
+    }
+
+    void parse() {
+        using detail::column_descriptor;
+        using detail::column_file_header;
+        if (map_.size() < sizeof(column_file_header)) {
+            fail("truncated header");
+        }
+        column_file_header header;
+        std::memcpy(&header, map_.data(), sizeof(header));
+        if (std::memcmp(header.magic, detail::column_file_magic, 8) != 0) {
+            fail("not a physi column file");
+        }
+        if (header.byte_order != detail::column_file_byte_order) {
+            fail("written with a different byte order");
+        }
+        if (header.version != detail::column_file_version) {
+            fail("unsupported version " + std::to_string(header.version));
+        }
+        rows_ = header.rows;
+        const std::uint64_t table_end =
+            sizeof(header) +
+            std::uint64_t{header.columns} * sizeof(column_descriptor);
+        if (table_end > map_.size()) {
+            fail("truncated column table");
+        }
+
+        for (std::uint32_t i = 0; i < header.columns; ++i) {
+            column_descriptor d;
+            std::memcpy(&d,
+                        map_.data() + sizeof(header) +
+                            i * sizeof(column_descriptor),
+                        sizeof(d));
+            column_spec spec;
+            spec.name.assign(d.name, std::find(d.name, std::end(d.name), '\0'));
+            std::memcpy(spec.dimension.data(), d.dimension, 7);
+            spec.scalar = static_cast<column_scalar>(d.scalar);
+            spec.scalar_size = d.scalar_size;
+            spec.components = d.components;
+
+            if (spec.scalar_size == 0 ||
+                spec.scalar_size != detail::column_scalar_size(spec.scalar)) {
+                fail("column '" + spec.name + "' has an unknown scalar type");
+            }
+            if (d.offset % simd_alignment != 0 || spec.components < 1 ||
+                spec.components > 4 ||
+                !detail::column_fits(d.offset, header.rows, spec.scalar_size,
+                                     spec.components, map_.size())) {
+                fail("column '" + spec.name + "' is out of bounds");
+            }
+            specs_.push_back(std::move(spec));
+            offsets_.push_back(d.offset);
+        }
+    }
+
+    std::size_t find(const column_spec &expected) const {
+        for (std::size_t i = 0; i < specs_.size(); ++i) {
+            if (specs_[i].name != expected.name) {
+                continue;
+            }
+            if (!specs_[i].same_layout(expected)) {
+                fail("column '" + expected.name + "' holds " +
+                     specs_[i].describe() + ", requested " +
+                     expected.describe());
+            }
+            return i;
+        }
+        fail("no column '" + expected.name + "'");
+    }
+
+    template <typename Quantity>
+    [[nodiscard]] std::span<const Quantity> component(std::size_t column,
+                                                      int c) const noexcept {
+        const std::byte *p =
+            map_.data() + offsets_[column] +
+            static_cast<std::uint64_t>(c) *
+                detail::column_stride(rows_, sizeof(Quantity));
+        return {reinterpret_cast<const Quantity *>(p), rows_};
+    }
+};
+
+// ========== Writer ==========
+
+class column_file_writer {
+  public:
+    // The arrays are referenced, not copied, until write() returns.
+    template <typename Quantity>
+    column_file_writer &add(std::string name,
+                            const quantity_array<Quantity> &values) {
+        add_column(column_spec::of<Quantity>(std::move(name)),
+                   {{values.base_data(), values.size()}});
+        return *this;
+    }
+
+    template <typename Quantity, glm::length_t N>
+    column_file_writer &add(std::string name,
+                            const vec_array<Quantity, N> &values) {
+        std::vector<block> blocks;
+        for (glm::length_t c = 0; c < N; ++c) {
+            blocks.push_back({values.component(c).base_data(), values.size()});
+        }
+        add_column(column_spec::of<Quantity, N>(std::move(name)),
+                   std::move(blocks));
+        return *this;
+    }
+
+    void write(const std::string &path) const {
+        using detail::column_descriptor;
+        using detail::column_file_header;
+        const std::uint64_t rows = columns_.empty() ? 0 : rows_;
+
+        column_file_header header{};
+        std::memcpy(header.magic, detail::column_file_magic, 8);
+        header.version = detail::column_file_version;
+        header.byte_order = detail::column_file_byte_order;
+        header.rows = rows;
+        header.columns = static_cast<std::uint32_t>(columns_.size());
+
+        std::vector<column_descriptor> table(columns_.size());
+        std::uint64_t offset = aligned(
+            sizeof(header) + columns_.size() * sizeof(column_descriptor));
+        for (std::size_t i = 0; i < columns_.size(); ++i) {
+            const auto &spec = columns_[i].spec;
+            auto &d = table[i];
+            d = {};
+            std::memcpy(d.name, spec.name.data(), spec.name.size());
+            std::memcpy(d.dimension, spec.dimension.data(), 7);
+            d.scalar = static_cast<std::uint8_t>(spec.scalar);
+            d.scalar_size = spec.scalar_size;
+            d.components = spec.components;
+            d.offset = offset;
+            offset += spec.components *
+                      detail::column_stride(rows, spec.scalar_size);
+        }
+
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            throw io_error("column file: cannot open '" + path +
+                           "' for writing");
+        }
+        static constexpr std::byte zeros[simd_alignment] = {};
+        std::uint64_t written = 0;
+        bool ok = true;
+        const auto put = [&](const void *data, std::uint64_t bytes) {
+            ok = ok && std::fwrite(data, 1, bytes, file) == bytes;
+            written += bytes;
+        };
+        const auto pad = [&] {
+            put(zeros, aligned(written) - written);
+        };
+
+        put(&header, sizeof(header));
+        put(table.data(), table.size() * sizeof(column_descriptor));
+        pad();
+        for (const auto &col : columns_) {
+            for (const auto &b : col.blocks) {
+                put(b.data, rows * col.spec.scalar_size);
+                pad();
+            }
+        }
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok) {
+            throw io_error("column file: cannot write '" + path + "'");
+        }
+    }
+
+  private:
+    struct block {
+        const void *data;
+        std::size_t rows;
+    };
+    struct pending_column {
+        column_spec spec;
+        std::vector<block> blocks;
+    };
+
+    std::vector<pending_column> columns_;
+    std::size_t rows_ = 0;
+
+    [[nodiscard]] static constexpr std::uint64_t
+    aligned(std::uint64_t bytes) noexcept {
+        return (bytes + simd_alignment - 1) / simd_alignment * simd_alignment;
+    }
+
+    void add_column(column_spec spec, std::vector<block> blocks) {
+        if (spec.name.empty() ||
+            spec.name.size() >= sizeof(detail::column_descriptor::name)) {
+            throw io_error("column file: column name '" + spec.name +
+                           "' must be 1 to 39 bytes");
+        }
+        for (const auto &col : columns_) {
+            if (col.spec.name == spec.name) {
+                throw io_error("column file: duplicate column '" + spec.name +
+                               "'");
+            }
+        }
+        const std::size_t rows = blocks.front().rows;
+        if (!columns_.empty() && rows != rows_) {
+            throw io_error("column file: column '" + spec.name + "' has " +
+                           std::to_string(rows) + " rows, expected " +
+                           std::to_string(rows_));
+        }
+        rows_ = rows;
+        columns_.push_back({std::move(spec), std::move(blocks)});
+    }
+};
+
+} // namespace physi
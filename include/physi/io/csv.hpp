@@ -0,0 +1,547 @@
+#pragma once
+
+#include "../array/quantity_array.hpp"
+#include "../core/parallel.hpp"
+#include "../core/unit.hpp"
+#include "error.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// CSV ingest and export of unit-tagged quantity columns.
+//
+// Headers carry the unit of each column in brackets, using the unit names
+// generated by PHYSI_UNIT:
+//
+//   pressure[psi],temperature[F],speed[km_h]
+//   14.7,68,100
+//
+//   quantity_array<pressure_d> p;
+//   quantity_array<temperature_d> t;
+//   auto reader = csv_reader::open("telemetry.csv");
+//   reader.bind("pressure", p).bind("temperature", t);
+//   reader.read(4);                 // 4 threads; values land in base units
+//
+//   csv_writer out;
+//   out.column("pressure", p, "kPa").column("temperature", t, "C");
+//   out.write("out.csv", 4);
+//
+// Fields are parsed with std::from_chars straight into the column storage
+// (through a float buffer for half / bfloat16 columns) and converted to
+// base units in one vectorized pass per column and chunk; there is no
+// per-row allocation. Columns without a unit are in base units.
+// The dialect is plain numeric CSV: ',' separated, no quoting, LF or CRLF.
+// Malformed input and unknown units throw io_error.
+
+namespace physi {
+
+namespace detail {
+
+[[nodiscard]] constexpr std::string_view csv_trim(std::string_view s) noexcept {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() &&
+           (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// "pressure[psi]" -> {"pressure", "psi"}; no brackets -> {name, ""}.
+struct csv_header_field {
+    std::string_view name;
+    std::string_view unit;
+};
+
+[[nodiscard]] constexpr csv_header_field
+parse_csv_header_field(std::string_view field) noexcept {
+    field = csv_trim(field);
+    const auto open = field.find('[');
+    if (open == std::string_view::npos || field.back() != ']') {
+        return {field, {}};
+    }
+    return {csv_trim(field.substr(0, open)),
+            csv_trim(field.substr(open + 1, field.size() - open - 2))};
+}
+
+// Base unit when `unit` is empty, else the unit registered on Q.
+template <typename Q>
+[[nodiscard]] constexpr std::optional<unit_info>
+resolve_unit(std::string_view unit) noexcept {
+    if (unit.empty()) {
+        return unit_info{};
+    }
+    if constexpr (requires { Q::find_unit(unit); }) {
+        return Q::find_unit(unit);
+    } else {
+        return std::nullopt;
+    }
+}
+
+// Next line of `text` starting at `pos` (without its terminator); advances
+// `pos` past the terminator.
+[[nodiscard]] constexpr std::string_view
+csv_next_line(std::string_view text, std::size_t &pos) noexcept {
+    const auto end = std::min(text.find('\n', pos), text.size());
+    const auto line = text.substr(pos, end - pos);
+    pos = end + 1;
+    return line;
+}
+
+// Scalar fields are parsed and formatted in: the 16-bit floats have no
+// from_chars / to_chars of their own and go through float.
+template <typename T>
+using csv_scalar_t = std::conditional_t<is_half_float_v<T>, float, T>;
+
+// Column bound to a csv_reader: parses into and converts its own storage.
+class csv_sink {
+  public:
+    virtual ~csv_sink() = default;
+    [[nodiscard]] virtual std::optional<unit_info>
+    find_unit(std::string_view unit) const = 0;
+    virtual void resize(std::size_t rows) = 0;
+    [[nodiscard]] virtual bool parse(std::size_t row,
+                                     std::string_view field) = 0;
+    virtual void to_base(std::size_t first, std::size_t count,
+                         const unit_info &unit) = 0;
+};
+
+template <typename Quantity> class csv_sink_for final : public csv_sink {
+  public:
+    explicit csv_sink_for(quantity_array<Quantity> &column) noexcept
+        : column_(column) {}
+
+    [[nodiscard]] std::optional<unit_info>
+    find_unit(std::string_view unit) const override {
+        return resolve_unit<Quantity>(unit);
+    }
+
+    void resize(std::size_t rows) override {
+        column_.resize(rows);
+        if constexpr (staged) {
+            staging_.resize(rows);
+        }
+    }
+
+    [[nodiscard]] bool parse(std::size_t row,
+                             std::string_view field) override {
+        const auto *last = field.data() + field.size();
+        const auto [ptr, ec] = std::from_chars(field.data(), last, slot(row));
+        return ec == std::errc{} && ptr == last;
+    }
+
+    void to_base(std::size_t first, std::size_t count,
+                 const unit_info &unit) override {
+        W *p = &slot(first);
+        if (unit.scale != 1.0L || unit.offset != 0.0L) {
+            affine_map(p, p, count, static_cast<W>(unit.scale),
+                       static_cast<W>(unit.offset * unit.scale));
+        }
+        if constexpr (staged) {
+            T *out = column_.base_data() + first;
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = static_cast<T>(p[i]);
+            }
+        }
+    }
+
+  private:
+    using T = scalar_type_t<Quantity>;
+    using W = csv_scalar_t<T>;
+    // 16-bit columns are parsed and converted in a float buffer and
+    // rounded into the column once, in to_base().
+    static constexpr bool staged = !std::is_same_v<T, W>;
+
+    [[nodiscard]] W &slot(std::size_t row) noexcept {
+        if constexpr (staged) {
+            return staging_[row];
+        } else {
+            return column_.base_data()[row];
+        }
+    }
+
+    quantity_array<Quantity> &column_;
+    std::vector<W> staging_;
+};
+
+// Column bound to a csv_writer: formats one row at a time in its unit.
+class csv_source {
+  public:
+    virtual ~csv_source() = default;
+    [[nodiscard]] virtual std::size_t size() const noexcept = 0;
+    // Writes row `row` into [first, last); returns one past the last char.
+    virtual char *format(char *first, char *last,
+                         std::size_t row) const noexcept = 0;
+};
+
+template <typename Quantity> class csv_source_for final : public csv_source {
+  public:
+    csv_source_for(const quantity_array<Quantity> &column,
+                   const unit_info &unit) noexcept
+        : column_(column), mul_(static_cast<W>(1.0L / unit.scale)),
+          add_(static_cast<W>(-unit.offset)) {}
+
+    [[nodiscard]] std::size_t size() const noexcept override {
+        return column_.size();
+    }
+
+    char *format(char *first, char *last,
+                 std::size_t row) const noexcept override {
+        const W value = static_cast<W>(column_.base_data()[row]) * mul_ + add_;
+        return std::to_chars(first, last, value).ptr;
+    }
+
+  private:
+    using T = scalar_type_t<Quantity>;
+    using W = csv_scalar_t<T>;
+    const quantity_array<Quantity> &column_;
+    W mul_;
+    W add_;
+};
+
+} // namespace detail
+
+// ========== Reader ==========
+
+class csv_reader {
+  public:
+    // Reads from `text`, which must outlive the reader.
+    explicit csv_reader(std::string_view text) noexcept : view_(text) {}
+
+    // Loads the whole file into memory owned by the reader.
+    [[nodiscard]] static csv_reader open(const std::string &path) {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            throw io_error("csv: cannot open '" + path + "'");
+        }
+        std::string contents;
+        char chunk[1 << 16];
+        std::size_t got = 0;
+        while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            contents.append(chunk, got);
+        }
+        const bool failed = std::ferror(file) != 0;
+        std::fclose(file);
+        if (failed) {
+            throw io_error("csv: cannot read '" + path + "'");
+        }
+        csv_reader reader{std::string_view{}};
+        reader.owned_ = std::move(contents);
+        reader.owns_ = true;
+        return reader;
+    }
+
+    // Fill `column` from the header column called `name` (unit brackets
+    // excluded). The column is resized to the row count by read().
+    template <typename Quantity>
+    csv_reader &bind(std::string name, quantity_array<Quantity> &column) {
+        columns_.push_back(
+            {std::move(name),
+             std::make_unique<detail::csv_sink_for<Quantity>>(column)});
+        return *this;
+    }
+
+    // Parses every data row into the bound columns, splitting the text into
+    // `threads` chunks (0 = one per hardware thread). Returns the row count.
+    std::size_t read(std::size_t threads = 1) {
+        const std::string_view all = text();
+        std::size_t pos = 0;
+        const auto header = detail::csv_next_line(all, pos);
+        const auto layout = map_header(header);
+        const std::string_view body =
+            pos < all.size() ? all.substr(pos) : std::string_view{};
+
+        // chunk boundaries fall right after a line break
+        if (threads == 0) {
+            threads = default_thread_count();
+        }
+        const std::size_t chunks =
+            std::max<std::size_t>(1, std::min(threads, body.size() / 4096));
+        std::vector<std::size_t> bounds(chunks + 1, body.size());
+        bounds[0] = 0;
+        for (std::size_t c = 1; c < chunks; ++c) {
+            const auto cut = body.find('\n', body.size() * c / chunks);
+            bounds[c] = cut == std::string_view::npos
+                            ? body.size()
+                            : std::max(cut + 1, bounds[c - 1]);
+        }
+
+        // pass 1: rows per chunk -> output offsets
+        std::vector<std::size_t> first_row(chunks + 1, 0);
+        parallel_for(
+            chunks,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t c = begin; c < end; ++c) {
+                    first_row[c + 1] = count_rows(
+                        body.substr(bounds[c], bounds[c + 1] - bounds[c]));
+                }
+            },
+            threads);
+        for (std::size_t c = 0; c < chunks; ++c) {
+            first_row[c + 1] += first_row[c];
+        }
+        const std::size_t rows = first_row[chunks];
+        for (auto &col : columns_) {
+            col.sink->resize(rows);
+        }
+
+        // pass 2: parse in place, then convert each chunk to base units
+        parallel_for(
+            chunks,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t c = begin; c < end; ++c) {
+                    parse_chunk(
+                        body.substr(bounds[c], bounds[c + 1] - bounds[c]),
+                        first_row[c], layout);
+                }
+            },
+            threads);
+        return rows;
+    }
+
+  private:
+    struct bound_column {
+        std::string name;
+        std::unique_ptr<detail::csv_sink> sink;
+    };
+
+    // Per header field: the bound column it feeds (or none) and its unit.
+    struct field_binding {
+        detail::csv_sink *sink = nullptr;
+        const std::string *name = nullptr;
+        unit_info unit;
+    };
+
+    std::string_view view_;
+    std::string owned_;
+    bool owns_ = false;
+    std::vector<bound_column> columns_;
+
+    [[nodiscard]] std::string_view text() const noexcept {
+        return owns_ ? std::string_view(owned_) : view_;
+    }
+
+    [[nodiscard]] std::vector<field_binding>
+    map_header(std::string_view header) const {
+        std::vector<field_binding> layout;
+        std::vector<bool> found(columns_.size(), false);
+        for (std::size_t pos = 0; pos <= header.size();) {
+            const auto end = std::min(header.find(',', pos), header.size());
+            const auto field =
+                detail::parse_csv_header_field(header.substr(pos, end - pos));
+            pos = end + 1;
+
+            field_binding binding;
+            for (std::size_t i = 0; i < columns_.size(); ++i) {
+                if (columns_[i].name != field.name) {
+                    continue;
+                }
+                if (found[i]) {
+                    throw io_error("csv: duplicate column '" +
+                                   columns_[i].name + "' in header");
+                }
+                const auto unit = columns_[i].sink->find_unit(field.unit);
+                if (!unit) {
+                    throw io_error("csv: unknown unit '" +
+                                   std::string(field.unit) + "' for column '" +
+                                   columns_[i].name + "'");
+                }
+                binding = {columns_[i].sink.get(), &columns_[i].name, *unit};
+                found[i] = true;
+                break;
+            }
+            layout.push_back(binding);
+        }
+        for (std::size_t i = 0; i < columns_.size(); ++i) {
+            if (!found[i]) {
+                throw io_error("csv: column '" + columns_[i].name +
+                               "' not found in header");
+            }
+        }
+        return layout;
+    }
+
+    [[nodiscard]] static std::size_t count_rows(std::string_view chunk) {
+        std::size_t rows = 0;
+        for (std::size_t pos = 0; pos < chunk.size();) {
+            rows += detail::csv_trim(detail::csv_next_line(chunk, pos)).empty()
+                        ? 0
+                        : 1;
+        }
+        return rows;
+    }
+
+    static void parse_chunk(std::string_view chunk, std::size_t first_row,
+                            const std::vector<field_binding> &layout) {
+        std::size_t row = first_row;
+        for (std::size_t pos = 0; pos < chunk.size();) {
+            const auto line =
+                detail::csv_trim(detail::csv_next_line(chunk, pos));
+            if (line.empty()) {
+                continue;
+            }
+            const auto field_count =
+                static_cast<std::size_t>(
+                    std::count(line.begin(), line.end(), ',')) +
+                1;
+            if (field_count != layout.size()) {
+                throw io_error("csv: row " + std::to_string(row + 1) + ": " +
+                               std::to_string(field_count) +
+                               " fields, expected " +
+                               std::to_string(layout.size()));
+            }
+            std::size_t field_pos = 0;
+            for (std::size_t f = 0; f < layout.size(); ++f) {
+                const auto end =
+                    std::min(line.find(',', field_pos), line.size());
+                const auto field =
+                    detail::csv_trim(line.substr(field_pos, end - field_pos));
+                field_pos = end + 1;
+                if (layout[f].sink != nullptr &&
+                    !layout[f].sink->parse(row, field)) {
+                    throw io_error("csv: row " + std::to_string(row + 1) +
+                                   ", column '" + *layout[f].name +
+                                   "': cannot parse '" + std::string(field) +
+                                   "'");
+                }
+            }
+            ++row;
+        }
+        for (const auto &binding : layout) {
+            if (binding.sink != nullptr) {
+                binding.sink->to_base(first_row, row - first_row,
+                                      binding.unit);
+            }
+        }
+    }
+};
+
+// ========== Writer ==========
+
+class csv_writer {
+  public:
+    // Adds `values` as column `name`, written in `unit` (a name generated by
+    // PHYSI_UNIT; empty = base unit). The array is referenced, not copied, and
+    // all columns must have the same size when writing.
+    template <typename Quantity>
+    csv_writer &column(std::string name,
+                       const quantity_array<Quantity> &values,
+                       std::string_view unit = {}) {
+        const auto info = detail::resolve_unit<Quantity>(unit);
+        if (!info) {
+            throw io_error("csv: unknown unit '" + std::string(unit) +
+                           "' for column '" + name + "'");
+        }
+        if (!unit.empty()) {
+            name += '[';
+            name += unit;
+            name += ']';
+        }
+        columns_.push_back(
+            {std::move(name),
+             std::make_unique<detail::csv_source_for<Quantity>>(values,
+                                                                *info)});
+        return *this;
+    }
+
+    // Formats header and rows, splitting the rows over `threads` threads
+    // (0 = one per hardware thread).
+    [[nodiscard]] std::string to_string(std::size_t threads = 1) const {
+        std::string out;
+        for (const auto &part : format(threads)) {
+            out += part;
+        }
+        return out;
+    }
+
+    void write(const std::string &path, std::size_t threads = 1) const {
+        const auto parts = format(threads);
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            throw io_error("csv: cannot open '" + path + "' for writing");
+        }
+        bool ok = true;
+        for (const auto &part : parts) {
+            ok = ok &&
+                 std::fwrite(part.data(), 1, part.size(), file) == part.size();
+        }
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok) {
+            throw io_error("csv: cannot write '" + path + "'");
+        }
+    }
+
+  private:
+    struct bound_column {
+        std::string header;
+        std::unique_ptr<detail::csv_source> source;
+    };
+
+    std::vector<bound_column> columns_;
+
+    // Header followed by one formatted block of rows per chunk, in order.
+    [[nodiscard]] std::vector<std::string> format(std::size_t threads) const {
+        const std::size_t rows =
+            columns_.empty() ? 0 : columns_.front().source->size();
+        for (const auto &col : columns_) {
+            if (col.source->size() != rows) {
+                throw io_error("csv: column '" + col.header + "' has " +
+                               std::to_string(col.source->size()) +
+                               " rows, expected " + std::to_string(rows));
+            }
+        }
+
+        if (threads == 0) {
+            threads = default_thread_count();
+        }
+        const std::size_t chunks =
+            std::max<std::size_t>(1, std::min(threads, rows / 1024));
+        std::vector<std::string> parts(chunks + 1);
+        for (std::size_t i = 0; i < columns_.size(); ++i) {
+            parts[0] += (i == 0 ? "" : ",") + columns_[i].header;
+        }
+        parts[0] += '\n';
+
+        parallel_for(
+            chunks,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t c = begin; c < end; ++c) {
+                    format_rows(rows * c / chunks, rows * (c + 1) / chunks,
+                                parts[c + 1]);
+                }
+            },
+            threads);
+        return parts;
+    }
+
+    void format_rows(std::size_t first, std::size_t last,
+                     std::string &out) const {
+        // long double needs the most room: sign, 21 digits, exponent
+        char buffer[64];
+        out.reserve((last - first) * columns_.size() * 16);
+        for (std::size_t row = first; row < last; ++row) {
+            for (std::size_t i = 0; i < columns_.size(); ++i) {
+                if (i != 0) {
+                    out += ',';
+                }
+                char *end = columns_[i].source->format(
+                    buffer, buffer + sizeof(buffer), row);
+                out.append(buffer, end);
+            }
+            out += '\n';
+        }
+    }
+};
+
+} // namespace physi
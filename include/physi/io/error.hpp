@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace physi {
+
+// Thrown by the readers and writers in physi/io on malformed input, unknown
+// units or failing file operations. The message names the file/row/column.
+class io_error : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+} // namespace physi
@@ -1,29 +1,50 @@
 #pragma once
 
-#include "quantities/amount_of_substance.hpp"
-#include "quantities/electric_current.hpp"
-#include "quantities/length.hpp"
-#include "quantities/luminosity.hpp"
-#include "quantities/mass.hpp"
-#include "quantities/temperature.hpp"
-#include "quantities/time.hpp"
-
-// complex quantities
-#include "quantities/complex/accelleration.hpp"
-#include "quantities/complex/area.hpp"
-#include "quantities/complex/capacitance.hpp"
-#include "quantities/complex/density.hpp"
-#include "quantities/complex/electric_charge.hpp"
-#include "quantities/complex/energy.hpp"
-#include "quantities/complex/force.hpp"
-#include "quantities/complex/moment_of_inertia.hpp"
-#include "quantities/complex/momentum.hpp"
-#include "quantities/complex/power.hpp"
-#include "quantities/complex/pressure.hpp"
-#include "quantities/complex/resistance.hpp"
-#include "quantities/complex/speed.hpp"
-#include "quantities/complex/voltage.hpp"
-#include "quantities/complex/volume.hpp"
-
-//
-#include "vec/vec.hpp"
\ No newline at end of file
+// all quantities; include "physi/quantities.hpp" directly when the vector
+// types and containers are not needed
+#include "quantities.hpp"
+
+// half / bfloat16 <-> float span conversion (F16C where available)
+#include "core/half_convert.hpp"
+
+// integer ticks with a compile-time scale
+#include "core/scaled_quantity.hpp"
+
+// values kept in a declared unit
+#include "core/quantity_in.hpp"
+
+// small vectors, matrices and rotation quaternions (glm-backed)
+#include "vec/mat.hpp"
+#include "vec/quat.hpp"
+#include "vec/vec.hpp"
+
+// structure-of-arrays containers
+#include "array/quantity_array.hpp"
+#include "array/vec_array.hpp"
+
+// SIMD batch geometry over vec_array (batch::length, cross, transform, ...)
+#include "array/vec_batch.hpp"
+
+// parallel reductions (sum, mean, minmax, sum_of_products, centroid)
+#include "algorithm/reduce.hpp"
+
+// compensated / pairwise running totals
+#include "algorithm/accumulator.hpp"
+
+// uniform-grid broad phase (radius queries, pair enumeration)
+#include "algorithm/spatial_hash.hpp"
+
+// gravitational N-body engine and Barnes-Hut octree
+#include "sim/nbody.hpp"
+
+// rigid bodies with contact islands and sleeping
+#include "sim/rigid_body.hpp"
+
+// pooled particles with stable handles and parallel compaction
+#include "sim/particle_pool.hpp"
+
+// fixed-timestep clock with sub-steps and interpolated output
+#include "sim/fixed_step.hpp"
+
+// shared thread pool and dependency-scheduled frame stages
+#include "core/task_graph.hpp"
@@ -0,0 +1,32 @@
+#pragma once
+
+// Every scalar quantity and its literals, without glm or the containers.
+
+#include "quantities/amount_of_substance.hpp"
+#include "quantities/electric_current.hpp"
+#include "quantities/length.hpp"
+#include "quantities/luminosity.hpp"
+#include "quantities/mass.hpp"
+#include "quantities/temperature.hpp"
+#include "quantities/time.hpp"
+
+// complex quantities
+#include "quantities/complex/accelleration.hpp"
+#include "quantities/complex/angular_acceleration.hpp"
+#include "quantities/complex/angular_momentum.hpp"
+#include "quantities/complex/angular_velocity.hpp"
+#include "quantities/complex/area.hpp"
+#include "quantities/complex/capacitance.hpp"
+#include "quantities/complex/density.hpp"
+#include "quantities/complex/electric_charge.hpp"
+#include "quantities/complex/energy.hpp"
+#include "quantities/complex/force.hpp"
+#include "quantities/complex/moment_of_inertia.hpp"
+#include "quantities/complex/momentum.hpp"
+#include "quantities/complex/power.hpp"
+#include "quantities/complex/pressure.hpp"
+#include "quantities/complex/resistance.hpp"
+#include "quantities/complex/speed.hpp"
+#include "quantities/complex/torque.hpp"
+#include "quantities/complex/voltage.hpp"
+#include "quantities/complex/volume.hpp"
@@ -12,6 +12,7 @@ PHYSI_UNIT(amount_of_substance, umol, 0.000001)
 PHYSI_UNIT(amount_of_substance, kmol, 1000.0)
 
 PHYSI_QUANTITY_END(amount_of_substance)
+PHYSI_DIMENSION(amount_of_substance, 0, 0, 0, 0, 0, 1, 0)
 
 namespace literals {
 
@@ -14,6 +14,7 @@ PHYSI_UNIT(acceleration, cm_s2, 0.01)
 PHYSI_UNIT(acceleration, ft_s2, 0.3048)
 
 PHYSI_QUANTITY_END(acceleration)
+PHYSI_DIMENSION(acceleration, 1, 0, -2, 0, 0, 0, 0)
 
 namespace literals {
 
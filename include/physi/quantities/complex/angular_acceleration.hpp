@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../../core/quantity.hpp"
+#include "../time.hpp"
+#include "angular_velocity.hpp"
+
+namespace physi {
+
+// T⁻², shared with frequency / time like angular_velocity's T⁻¹
+PHYSI_QUANTITY_BEGIN(angular_acceleration)
+
+PHYSI_UNIT(angular_acceleration, rad_s2, 1.0)
+PHYSI_UNIT(angular_acceleration, deg_s2, 0.017453292519943295)
+
+PHYSI_QUANTITY_END(angular_acceleration)
+PHYSI_DIMENSION_SHARED(angular_acceleration, 0, 0, -2, 0, 0, 0, 0)
+
+namespace literals {
+
+PHYSI_LITERAL(angular_acceleration_ld, rad_s2)
+PHYSI_LITERAL(angular_acceleration_ld, deg_s2)
+
+} // namespace literals
+
+PHYSI_BINARY_OP(angular_acceleration, angular_velocity, DIV, time)
+
+} // namespace physi
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../../core/quantity.hpp"
+#include "../time.hpp"
+#include "angular_velocity.hpp"
+#include "moment_of_inertia.hpp"
+#include "torque.hpp"
+
+namespace physi {
+
+PHYSI_QUANTITY_BEGIN(angular_momentum)
+
+PHYSI_UNIT(angular_momentum, kg_m2_s, 1.0)
+PHYSI_UNIT(angular_momentum, g_cm2_s, 0.0000001)
+
+PHYSI_QUANTITY_END(angular_momentum)
+PHYSI_DIMENSION(angular_momentum, 2, 1, -1, 0, 0, 0, 0)
+
+namespace literals {
+
+PHYSI_LITERAL(angular_momentum_ld, kg_m2_s)
+PHYSI_LITERAL(angular_momentum_ld, g_cm2_s)
+
+} // namespace literals
+
+PHYSI_BINARY_OP(angular_momentum, moment_of_inertia, MUL, angular_velocity)
+PHYSI_BINARY_OP(angular_momentum, torque, MUL, time)
+
+} // namespace physi
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../../core/quantity.hpp"
+#include "../time.hpp"
+
+namespace physi {
+
+// Radians are dimensionless, so angular velocity is T⁻¹. It shares that
+// dimension with plain frequencies rather than owning it: 1 / time is not
+// an angular velocity (1 / 1_min is not 1 rpm), so construct one explicitly,
+// e.g. angular_velocity_d(2 * pi / period).
+PHYSI_QUANTITY_BEGIN(angular_velocity)
+
+PHYSI_UNIT(angular_velocity, rad_s, 1.0)
+PHYSI_UNIT(angular_velocity, deg_s, 0.017453292519943295)
+PHYSI_UNIT(angular_velocity, rpm, 0.10471975511965977)
+
+PHYSI_QUANTITY_END(angular_velocity)
+PHYSI_DIMENSION_SHARED(angular_velocity, 0, 0, -1, 0, 0, 0, 0)
+
+namespace literals {
+
+PHYSI_LITERAL(angular_velocity_ld, rad_s)
+PHYSI_LITERAL(angular_velocity_ld, deg_s)
+PHYSI_LITERAL(angular_velocity_ld, rpm)
+
+} // namespace literals
+
+} // namespace physi
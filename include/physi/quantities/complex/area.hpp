@@ -17,6 +17,7 @@ PHYSI_UNIT(area, acre, 4046.86)
 PHYSI_UNIT(area, hectare, 10000.0)
 
 PHYSI_QUANTITY_END(area)
+PHYSI_DIMENSION(area, 2, 0, 0, 0, 0, 0, 0)
 
 namespace literals {
 
@@ -31,20 +32,4 @@ PHYSI_LITERAL(area_ld, hectare)
 
 } // namespace literals
 
-template <typename U, typename N>
-[[nodiscard]] constexpr area<std::common_type_t<U, N>>
-operator*(const length<U> &lhs, const length<N> &rhs) noexcept {
-    using R = std::common_type_t<U, N>;
-    return area<R>(static_cast<R>(lhs.base_value()) *
-                   static_cast<R>(rhs.base_value()));
-}
-
-template <typename U, typename N>
-[[nodiscard]] constexpr length<std::common_type_t<U, N>>
-operator/(const area<U> &lhs, const length<N> &rhs) noexcept {
-    using R = std::common_type_t<U, N>;
-    return length<R>(static_cast<R>(lhs.base_value()) /
-                     static_cast<R>(rhs.base_value()));
-}
-
 } // namespace physi
\ No newline at end of file
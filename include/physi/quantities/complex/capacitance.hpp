@@ -15,6 +15,7 @@ PHYSI_UNIT(capacitance, nF, 0.000000001)
 PHYSI_UNIT(capacitance, pF, 0.000000000001)
 
 PHYSI_QUANTITY_END(capacitance)
+PHYSI_DIMENSION(capacitance, -2, -1, 4, 2, 0, 0, 0)
 
 namespace literals {
 
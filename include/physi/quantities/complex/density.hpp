@@ -16,6 +16,7 @@ PHYSI_UNIT(density, lb_ft3, 16.0185)
 PHYSI_UNIT(density, lb_gal, 119.826)
 
 PHYSI_QUANTITY_END(density)
+PHYSI_DIMENSION(density, -3, 1, 0, 0, 0, 0, 0)
 
 namespace literals {
 
@@ -16,6 +16,7 @@ PHYSI_UNIT(electric_charge, Ah, 3600.0)
 PHYSI_UNIT(electric_charge, mAh, 3.6)
 
 PHYSI_QUANTITY_END(electric_charge)
+PHYSI_DIMENSION(electric_charge, 0, 0, 1, 1, 0, 0, 0)
 
 namespace literals {
 
@@ -26,6 +26,7 @@ PHYSI_UNIT(energy, eV, 1.602176634e-19)
 PHYSI_UNIT(energy, BTU, 1055.06)
 
 PHYSI_QUANTITY_END(energy)
+PHYSI_DIMENSION(energy, 2, 1, -2, 0, 0, 0, 0)
 
 namespace literals {
 
@@ -17,6 +17,7 @@ PHYSI_UNIT(force, lbf, 4.44822)
 PHYSI_UNIT(force, kgf, 9.80665)
 
 PHYSI_QUANTITY_END(force)
+PHYSI_DIMENSION(force, 1, 1, -2, 0, 0, 0, 0)
 
 namespace literals {
 
@@ -13,6 +13,7 @@ PHYSI_UNIT(moment_of_inertia, g_cm2, 0.0000001)
 PHYSI_UNIT(moment_of_inertia, lb_ft2, 0.0421401)
 
 PHYSI_QUANTITY_END(moment_of_inertia)
+PHYSI_DIMENSION(moment_of_inertia, 2, 1, 0, 0, 0, 0, 0)
 
 namespace literals {
 
@@ -16,6 +16,7 @@ PHYSI_UNIT(momentum, g_cm_per_s, 0.00001)
 PHYSI_UNIT(momentum, lb_ft_per_s, 0.138255)
 
 PHYSI_QUANTITY_END(momentum)
+PHYSI_DIMENSION(momentum, 1, 1, -1, 0, 0, 0, 0)
 
 namespace literals {
 
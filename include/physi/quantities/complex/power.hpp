@@ -15,6 +15,7 @@ PHYSI_UNIT(power, hp, 745.7)
 PHYSI_UNIT(power, BTU_per_h, 0.293071)
 
 PHYSI_QUANTITY_END(power)
+PHYSI_DIMENSION(power, 2, 1, -3, 0, 0, 0, 0)
 
 namespace literals {
 
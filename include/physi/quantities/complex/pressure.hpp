@@ -19,6 +19,7 @@ PHYSI_UNIT(pressure, torr, 133.322)
 PHYSI_UNIT(pressure, mmHg, 133.322)
 
 PHYSI_QUANTITY_END(pressure)
+PHYSI_DIMENSION(pressure, -1, 1, -2, 0, 0, 0, 0)
 
 namespace literals {
 
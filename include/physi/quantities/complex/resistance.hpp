@@ -1,8 +1,6 @@
 #pragma once
 
 #include "../../core/quantity.hpp"
-#include "../electric_current.hpp"
-#include "voltage.hpp"
 
 namespace physi {
 
@@ -14,6 +12,7 @@ PHYSI_UNIT(resistance, Mohm, 1000000.0)
 PHYSI_UNIT(resistance, milliohm, 0.001)
 
 PHYSI_QUANTITY_END(resistance)
+PHYSI_DIMENSION(resistance, 2, 1, -3, -2, 0, 0, 0)
 
 namespace literals {
 
@@ -17,6 +17,7 @@ PHYSI_UNIT(speed, mach, 343.0)
 PHYSI_UNIT(speed, c, 299792458.0)
 
 PHYSI_QUANTITY_END(speed)
+PHYSI_DIMENSION(speed, 1, 0, -1, 0, 0, 0, 0)
 
 namespace literals {
 
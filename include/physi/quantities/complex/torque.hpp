@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../../core/quantity.hpp"
+#include "angular_acceleration.hpp"
+#include "energy.hpp"
+#include "force.hpp"
+#include "moment_of_inertia.hpp"
+#include "power.hpp"
+
+namespace physi {
+
+// Same dimension as energy (ML²T⁻²) but a different quantity: force *
+// length yields energy, and converting between the two is explicit, e.g.
+// torque_d(r.cross(f).z()) or vec3<torque_d>(r.cross(f))
+PHYSI_QUANTITY_BEGIN(torque)
+
+PHYSI_UNIT(torque, N_m, 1.0)
+PHYSI_UNIT(torque, kN_m, 1000.0)
+PHYSI_UNIT(torque, N_cm, 0.01)
+PHYSI_UNIT(torque, lbf_ft, 1.3558179483314004)
+PHYSI_UNIT(torque, lbf_in, 0.1129848290276167)
+
+PHYSI_QUANTITY_END(torque)
+PHYSI_DIMENSION_SHARED(torque, 2, 1, -2, 0, 0, 0, 0)
+
+namespace literals {
+
+PHYSI_LITERAL(torque_ld, N_m)
+PHYSI_LITERAL(torque_ld, kN_m)
+PHYSI_LITERAL(torque_ld, N_cm)
+PHYSI_LITERAL(torque_ld, lbf_ft)
+PHYSI_LITERAL(torque_ld, lbf_in)
+
+} // namespace literals
+
+PHYSI_BINARY_OP(angular_acceleration, torque, DIV, moment_of_inertia)
+PHYSI_BINARY_OP(power, torque, MUL, angular_velocity)
+
+} // namespace physi
@@ -14,6 +14,7 @@ PHYSI_UNIT(voltage, kV, 1000.0)
 PHYSI_UNIT(voltage, MV, 1000000.0)
 
 PHYSI_QUANTITY_END(voltage)
+PHYSI_DIMENSION(voltage, 2, 1, -3, -1, 0, 0, 0)
 
 namespace literals {
 
@@ -19,6 +19,7 @@ PHYSI_UNIT(volume, gal, 0.00378541)
 PHYSI_UNIT(volume, qt, 0.000946353)
 
 PHYSI_QUANTITY_END(volume)
+PHYSI_DIMENSION(volume, 3, 0, 0, 0, 0, 0, 0)
 
 namespace literals {
 
@@ -12,6 +12,7 @@ PHYSI_UNIT(electric_current, uA, 0.000001)
 PHYSI_UNIT(electric_current, kA, 1000.0)
 
 PHYSI_QUANTITY_END(electric_current)
+PHYSI_DIMENSION(electric_current, 0, 0, 0, 1, 0, 0, 0)
 
 namespace literals {
 
@@ -15,6 +15,7 @@ PHYSI_UNIT(length, mi, 1609.34)
 PHYSI_UNIT(length, in, 0.0254)
 
 PHYSI_QUANTITY_END(length)
+PHYSI_DIMENSION(length, 1, 0, 0, 0, 0, 0, 0)
 
 namespace literals {
 
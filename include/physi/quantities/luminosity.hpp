@@ -9,6 +9,7 @@ PHYSI_QUANTITY_BEGIN(luminous_intensity)
 PHYSI_UNIT(luminous_intensity, cd, 1.0)
 
 PHYSI_QUANTITY_END(luminous_intensity)
+PHYSI_DIMENSION(luminous_intensity, 0, 0, 0, 0, 0, 0, 1)
 
 namespace literals {
 
@@ -13,6 +13,7 @@ PHYSI_UNIT(mass, lb, 0.453592)
 PHYSI_UNIT(mass, oz, 0.0283495)
 
 PHYSI_QUANTITY_END(mass)
+PHYSI_DIMENSION(mass, 0, 1, 0, 0, 0, 0, 0)
 
 namespace literals {
 PHYSI_LITERAL(mass_ld, kg)
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "../core/quantity.hpp"
-#include <iostream>
 
 namespace physi {
 
@@ -12,6 +11,7 @@ PHYSI_UNIT_INCREASE(temperature, C, 1.0, 273.15)
 PHYSI_UNIT_INCREASE(temperature, F, 0.555556, 459.67)
 
 PHYSI_QUANTITY_END(temperature)
+PHYSI_DIMENSION(temperature, 0, 0, 0, 0, 1, 0, 0)
 
 namespace literals {
 
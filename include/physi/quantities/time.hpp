@@ -17,6 +17,7 @@ PHYSI_UNIT(time, wk, 604800.0)
 PHYSI_UNIT(time, yr, 31557600.0)
 
 PHYSI_QUANTITY_END(time)
+PHYSI_DIMENSION(time, 0, 0, 1, 0, 0, 0, 0)
 
 namespace literals {
 
@@ -0,0 +1,552 @@
+#pragma once
+
+#include "../array/quantity_array.hpp"
+#include "../array/vec_array.hpp"
+#include "../core/parallel.hpp"
+#include "../core/simd.hpp"
+#include "../quantities.hpp"
+#include "gravity.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Barnes-Hut octree for O(N log N) gravitational accelerations:
+//
+//   barnes_hut<double> tree({.theta = 0.5, .softening = length_d(1e7)});
+//   tree.build(positions, masses);              // Morton-sorted octree
+//   vec3_array<acceleration_d> a = tree.accelerations();
+//   auto [build, traversal] = tree.timings();   // per-phase wall time
+//
+// build() sorts the bodies by Morton code and splits the sorted range into
+// octants three code bits at a time, so every cell covers a contiguous run
+// of bodies. The top two levels are split on the calling thread and the
+// subtrees below them are built in parallel. accelerations() walks the tree
+// once per group of up to group_size neighbouring bodies: a cell of edge s
+// whose box is at distance d from the group's bounding box is used as a
+// point mass when s < theta * d, otherwise it is opened. Measuring to the
+// cell's box rather than its centre of mass keeps every theta safe: a cell
+// that contains or touches the group is always opened. The cells
+// and bodies collected for a group are then summed for all of its bodies
+// with the SIMD kernel of gravity.hpp. theta = 0 opens every cell: exact
+// direct summation through the tree.
+
+namespace physi {
+
+namespace detail {
+
+// Spreads the low 21 bits of v three bits apart.
+[[nodiscard]] constexpr std::uint64_t spread_bits_3(std::uint64_t v) noexcept {
+    v &= 0x1fffffu;
+    v = (v | v << 32) & 0x1f00000000ffffu;
+    v = (v | v << 16) & 0x1f0000ff0000ffu;
+    v = (v | v << 8) & 0x100f00f00f00f00fu;
+    v = (v | v << 4) & 0x10c30c30c30c30c3u;
+    v = (v | v << 2) & 0x1249249249249249u;
+    return v;
+}
+
+// Inverse of spread_bits_3: gathers every third bit into the low 21.
+[[nodiscard]] constexpr std::uint64_t
+compact_bits_3(std::uint64_t v) noexcept {
+    v &= 0x1249249249249249u;
+    v = (v ^ (v >> 2)) & 0x10c30c30c30c30c3u;
+    v = (v ^ (v >> 4)) & 0x100f00f00f00f00fu;
+    v = (v ^ (v >> 8)) & 0x1f0000ff0000ffu;
+    v = (v ^ (v >> 16)) & 0x1f00000000ffffu;
+    v = (v ^ (v >> 32)) & 0x1fffffu;
+    return v;
+}
+
+// 63-bit Morton code of three 21-bit cell coordinates (x in the lowest bit).
+[[nodiscard]] constexpr std::uint64_t
+morton_code(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept {
+    return spread_bits_3(x) | spread_bits_3(y) << 1 | spread_bits_3(z) << 2;
+}
+
+} // namespace detail
+
+template <typename T> struct barnes_hut_config {
+    // Opening angle: cells with edge < theta * distance (between the cell's
+    // box and the group's) are used whole.
+    T theta = T(0.5);
+    // Plummer softening length; must be positive (1 m unless set).
+    length<T> softening{T(1)};
+    gravitational_constant_t<T> G = gravitational_constant<T>;
+    // Bodies per leaf before a cell is split.
+    std::size_t leaf_size = 8;
+    // Bodies sharing one tree walk and interaction list.
+    std::size_t group_size = 64;
+    // Worker threads for build and traversal (0 = hardware threads).
+    std::size_t threads = 0;
+};
+
+// Wall time of the last build() and accelerations() calls.
+struct barnes_hut_timings {
+    std::chrono::nanoseconds build{0};
+    std::chrono::nanoseconds traversal{0};
+};
+
+template <typename T = double> class barnes_hut {
+  public:
+    using value_type = T;
+    using length_type = length<T>;
+    using mass_type = mass<T>;
+    using acceleration_type = acceleration<T>;
+
+    using config = barnes_hut_config<T>;
+
+  private:
+    // Levels below the root; 21 code bits per axis.
+    static constexpr int max_depth = 21;
+    // Levels split on the calling thread before subtrees go parallel.
+    static constexpr int serial_depth = 2;
+
+    struct node {
+        T x, y, z, m; // centre of mass and total mass (base units)
+        T size;       // cell edge
+        std::array<T, 3> corner; // lowest corner of the cell
+        std::uint32_t first_child;
+        std::uint32_t child_count; // 0 for leaves
+        std::uint32_t begin, end;  // bodies, in Morton order
+    };
+
+    // A subtree left for the parallel phase: the node slot it fills and its
+    // bodies.
+    struct pending {
+        std::uint32_t slot, begin, end;
+        int depth;
+    };
+
+    // Per-thread buffers of a group walk: the collected sources and the
+    // group's bodies padded to whole SIMD packs.
+    struct scratch {
+        std::vector<T> x, y, z, m;
+        std::vector<T> tx, ty, tz, ax, ay, az;
+    };
+
+    config config_;
+    T side_ = T(0);
+    std::array<T, 3> origin_{}; // lowest corner of the root cell
+    std::vector<node> nodes_;
+    std::vector<std::uint32_t> order_; // Morton rank -> body index
+    std::vector<std::uint64_t> codes_;
+    std::vector<T> x_, y_, z_, m_; // bodies in Morton order
+    barnes_hut_timings timings_;
+
+  public:
+    explicit barnes_hut(config c = {}) : config_(c) {
+        assert(config_.theta >= T(0) && "opening angle must be non-negative");
+        assert(config_.softening.base_value() > T(0) &&
+               "barnes_hut needs a positive softening length");
+        assert(config_.leaf_size > 0 && config_.group_size > 0 &&
+               "leaf_size and group_size must be positive");
+    }
+
+    [[nodiscard]] const config &settings() const noexcept { return config_; }
+    [[nodiscard]] std::size_t size() const noexcept { return order_.size(); }
+    [[nodiscard]] std::size_t node_count() const noexcept {
+        return nodes_.size();
+    }
+    [[nodiscard]] const barnes_hut_timings &timings() const noexcept {
+        return timings_;
+    }
+
+    // ========== Build ==========
+    void build(const vec3_array<length_type> &positions,
+               const quantity_array<mass_type> &masses) {
+        assert(positions.size() == masses.size() && "build size mismatch");
+        assert(positions.size() <= std::numeric_limits<std::uint32_t>::max());
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t n = positions.size();
+        const std::size_t threads = threads_for(n);
+        nodes_.clear();
+        order_.resize(n);
+        codes_.resize(n);
+        x_.resize(n);
+        y_.resize(n);
+        z_.resize(n);
+        m_.resize(n);
+        if (n > 0) {
+            sort_bodies(positions, masses, threads);
+            build_nodes(threads);
+        }
+        timings_.build = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start);
+    }
+
+    // ========== Traversal ==========
+    // Accelerations of the built bodies, in their original order. Returns
+    // the number of body-source interactions evaluated.
+    std::uint64_t accelerations(vec3_array<acceleration_type> &out) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t n = size();
+        out.resize(n);
+        std::array<T *, 3> a;
+        for (glm::length_t c = 0; c < 3; ++c) {
+            a[c] = out.component(c).base_data();
+        }
+        const std::vector<std::uint32_t> groups = collect_groups();
+        const std::size_t chunks = std::min(threads_for(n), groups.size());
+        std::vector<std::uint64_t> counts(chunks, 0);
+        parallel_for(
+            chunks,
+            [&](std::size_t first, std::size_t last) {
+                scratch buf;
+                for (std::size_t c = first; c < last; ++c) {
+                    const std::size_t g_end = groups.size() * (c + 1) / chunks;
+                    for (std::size_t g = groups.size() * c / chunks; g < g_end;
+                         ++g) {
+                        counts[c] += evaluate(nodes_[groups[g]], buf, a);
+                    }
+                }
+            },
+            chunks);
+
+        std::uint64_t interactions = 0;
+        for (const std::uint64_t k : counts) {
+            interactions += k;
+        }
+        timings_.traversal =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start);
+        return interactions;
+    }
+
+    [[nodiscard]] vec3_array<acceleration_type> accelerations() {
+        vec3_array<acceleration_type> out;
+        accelerations(out);
+        return out;
+    }
+
+  private:
+    [[nodiscard]] std::size_t threads_for(std::size_t n) const noexcept {
+        constexpr std::size_t min_bodies_per_thread = 1024;
+        const std::size_t threads = config_.threads == 0
+                                        ? default_thread_count()
+                                        : config_.threads;
+        return std::max<std::size_t>(
+            1, std::min(threads, n / min_bodies_per_thread));
+    }
+
+    // Bounding cube, Morton keys, sort, and the bodies gathered in order.
+    void sort_bodies(const vec3_array<length_type> &positions,
+                     const quantity_array<mass_type> &masses,
+                     std::size_t threads) {
+        const std::size_t n = positions.size();
+        std::array<const T *, 3> p;
+        for (glm::length_t c = 0; c < 3; ++c) {
+            p[c] = positions.component(c).base_data();
+        }
+        std::array<T, 3> lo, hi;
+        for (glm::length_t c = 0; c < 3; ++c) {
+            const auto [mn, mx] = std::minmax_element(p[c], p[c] + n);
+            lo[c] = *mn;
+            hi[c] = *mx;
+        }
+        origin_ = lo;
+        side_ = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+        // keep the top edge inside the last cell; a point set has side 1
+        side_ = side_ > T(0) ? side_ * (T(1) + T(16) *
+                                        std::numeric_limits<T>::epsilon())
+                             : T(1);
+
+        constexpr std::uint32_t cells = 1u << max_depth;
+        const T scale = T(cells) / side_;
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> keys(n);
+        parallel_for(
+            n,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    std::array<std::uint32_t, 3> q;
+                    for (glm::length_t c = 0; c < 3; ++c) {
+                        const T t = (p[c][i] - lo[c]) * scale;
+                        q[c] = std::min(cells - 1,
+                                        static_cast<std::uint32_t>(
+                                            std::max(t, T(0))));
+                    }
+                    keys[i] = {detail::morton_code(q[0], q[1], q[2]),
+                               static_cast<std::uint32_t>(i)};
+                }
+            },
+            threads);
+        detail::parallel_sort(keys, threads);
+
+        const T *m = masses.base_data();
+        parallel_for(
+            n,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    const std::uint32_t j = keys[i].second;
+                    codes_[i] = keys[i].first;
+                    order_[i] = j;
+                    x_[i] = p[0][j];
+                    y_[i] = p[1][j];
+                    z_[i] = p[2][j];
+                    m_[i] = m[j];
+                }
+            },
+            threads);
+    }
+
+    // Octant of code at depth d (d = 1 splits the root).
+    [[nodiscard]] static std::uint32_t octant(std::uint64_t code,
+                                              int d) noexcept {
+        return static_cast<std::uint32_t>(code >> (3 * (max_depth - d))) & 7u;
+    }
+
+    // Fills out[slot] for bodies [begin, end) at depth d and appends its
+    // children (contiguously) and their subtrees. Below stop_depth the
+    // subtree is left in `deferred` instead.
+    void split(std::vector<node> &out, std::uint32_t slot, std::uint32_t begin,
+               std::uint32_t end, int d, int stop_depth,
+               std::vector<pending> *deferred) const {
+        node &self = out[slot];
+        self.size = side_ / static_cast<T>(std::uint64_t{1} << d);
+        // every body of the cell shares the top d digits of its code
+        for (int c = 0; c < 3; ++c) {
+            const std::uint64_t cell =
+                detail::compact_bits_3(codes_[begin] >> c) >> (max_depth - d);
+            self.corner[c] = origin_[c] + static_cast<T>(cell) * self.size;
+        }
+        self.begin = begin;
+        self.end = end;
+        self.child_count = 0;
+        self.first_child = 0;
+        if (end - begin <= config_.leaf_size || d == max_depth) {
+            return;
+        }
+        // runs of the next octant digit; the range is sorted by code
+        std::array<std::uint32_t, 9> bound;
+        bound[0] = begin;
+        for (std::uint32_t o = 0; o < 8; ++o) {
+            bound[o + 1] = static_cast<std::uint32_t>(
+                std::partition_point(codes_.begin() + bound[o],
+                                     codes_.begin() + end,
+                                     [&](std::uint64_t c) {
+                                         return octant(c, d + 1) <= o;
+                                     }) -
+                codes_.begin());
+        }
+        const auto first = static_cast<std::uint32_t>(out.size());
+        std::uint32_t count = 0;
+        for (std::uint32_t o = 0; o < 8; ++o) {
+            count += bound[o + 1] > bound[o] ? 1u : 0u;
+        }
+        out[slot].first_child = first;
+        out[slot].child_count = count;
+        out.resize(out.size() + count);
+        std::uint32_t child = first;
+        for (std::uint32_t o = 0; o < 8; ++o) {
+            if (bound[o + 1] == bound[o]) {
+                continue;
+            }
+            if (d + 1 == stop_depth) {
+                deferred->push_back({child, bound[o], bound[o + 1], d + 1});
+            } else {
+                split(out, child, bound[o], bound[o + 1], d + 1, stop_depth,
+                      deferred);
+            }
+            ++child;
+        }
+    }
+
+    // Mass moments of out[first, last) from the end backwards; children
+    // always come after their parent.
+    void summarize(std::vector<node> &out, std::size_t first,
+                   std::size_t last) const noexcept {
+        for (std::size_t k = last; k-- > first;) {
+            node &c = out[k];
+            T m = 0, mx = 0, my = 0, mz = 0;
+            if (c.child_count == 0) {
+                for (std::uint32_t i = c.begin; i < c.end; ++i) {
+                    m += m_[i];
+                    mx += m_[i] * x_[i];
+                    my += m_[i] * y_[i];
+                    mz += m_[i] * z_[i];
+                }
+            } else {
+                for (std::uint32_t j = c.first_child;
+                     j < c.first_child + c.child_count; ++j) {
+                    const node &h = out[j];
+                    m += h.m;
+                    mx += h.m * h.x;
+                    my += h.m * h.y;
+                    mz += h.m * h.z;
+                }
+            }
+            c.m = m;
+            if (m != T(0)) {
+                c.x = mx / m;
+                c.y = my / m;
+                c.z = mz / m;
+            } else { // massless cell: any point inside
+                c.x = x_[c.begin];
+                c.y = y_[c.begin];
+                c.z = z_[c.begin];
+            }
+        }
+    }
+
+    void build_nodes(std::size_t threads) {
+        std::vector<pending> deferred;
+        nodes_.resize(1);
+        split(nodes_, 0, 0, static_cast<std::uint32_t>(size()), 0,
+              serial_depth, &deferred);
+
+        // subtrees into their own buffers, root first
+        std::vector<std::vector<node>> parts(deferred.size());
+        parallel_for(
+            deferred.size(),
+            [&](std::size_t first, std::size_t last) {
+                for (std::size_t k = first; k < last; ++k) {
+                    const pending &t = deferred[k];
+                    parts[k].resize(1);
+                    split(parts[k], 0, t.begin, t.end, t.depth, -1, nullptr);
+                    summarize(parts[k], 0, parts[k].size());
+                }
+            },
+            threads);
+
+        // splice: each root into its slot, the rest appended with shifted
+        // child indices
+        const std::size_t top = nodes_.size();
+        for (std::size_t k = 0; k < parts.size(); ++k) {
+            const auto offset = static_cast<std::uint32_t>(nodes_.size() - 1);
+            for (node &c : parts[k]) {
+                if (c.child_count != 0) {
+                    c.first_child += offset;
+                }
+            }
+            nodes_[deferred[k].slot] = parts[k][0];
+            nodes_.insert(nodes_.end(), parts[k].begin() + 1, parts[k].end());
+        }
+        summarize(nodes_, 0, top);
+    }
+
+    // Topmost cells with at most group_size bodies (or leaves), in Morton
+    // order.
+    [[nodiscard]] std::vector<std::uint32_t> collect_groups() const {
+        std::vector<std::uint32_t> groups;
+        if (nodes_.empty()) {
+            return groups;
+        }
+        std::vector<std::uint32_t> stack = {0};
+        while (!stack.empty()) {
+            const std::uint32_t k = stack.back();
+            stack.pop_back();
+            const node &c = nodes_[k];
+            if (c.child_count == 0 || c.end - c.begin <= config_.group_size) {
+                groups.push_back(k);
+                continue;
+            }
+            for (std::uint32_t j = c.child_count; j-- > 0;) {
+                stack.push_back(c.first_child + j);
+            }
+        }
+        return groups;
+    }
+
+    // Walks the tree for the bodies of cell g and writes their
+    // accelerations; returns bodies * sources.
+    std::uint64_t evaluate(const node &g, scratch &buf,
+                           const std::array<T *, 3> &out) const {
+        const std::size_t count = g.end - g.begin;
+        std::array<T, 3> lo = {x_[g.begin], y_[g.begin], z_[g.begin]};
+        std::array<T, 3> hi = lo;
+        for (std::uint32_t i = g.begin + 1; i < g.end; ++i) {
+            const std::array<T, 3> p = {x_[i], y_[i], z_[i]};
+            for (std::size_t c = 0; c < 3; ++c) {
+                lo[c] = std::min(lo[c], p[c]);
+                hi[c] = std::max(hi[c], p[c]);
+            }
+        }
+
+        // interaction list
+        buf.x.clear();
+        buf.y.clear();
+        buf.z.clear();
+        buf.m.clear();
+        const auto push = [&](T x, T y, T z, T m) {
+            buf.x.push_back(x);
+            buf.y.push_back(y);
+            buf.z.push_back(z);
+            buf.m.push_back(m);
+        };
+        const T theta2 = config_.theta * config_.theta;
+        // at most 7 pending siblings per level
+        std::array<std::uint32_t, 8 * (max_depth + 1)> stack;
+        std::size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const node &c = nodes_[stack[--top]];
+            T d2 = 0;
+            for (std::size_t k = 0; k < 3; ++k) {
+                const T d = std::max({lo[k] - (c.corner[k] + c.size),
+                                      c.corner[k] - hi[k], T(0)});
+                d2 += d * d;
+            }
+            if (c.size * c.size < theta2 * d2) {
+                push(c.x, c.y, c.z, c.m);
+            } else if (c.child_count == 0) {
+                for (std::uint32_t j = c.begin; j < c.end; ++j) {
+                    push(x_[j], y_[j], z_[j], m_[j]);
+                }
+            } else {
+                for (std::uint32_t j = 0; j < c.child_count; ++j) {
+                    stack[top++] = c.first_child + j;
+                }
+            }
+        }
+
+        // the group's bodies, padded with copies of the last one
+        constexpr std::size_t lanes = simd_alignment / sizeof(T);
+        const std::size_t padded = (count + lanes - 1) / lanes * lanes;
+        for (std::vector<T> *v : {&buf.tx, &buf.ty, &buf.tz}) {
+            v->resize(padded);
+        }
+        for (std::vector<T> *v : {&buf.ax, &buf.ay, &buf.az}) {
+            v->assign(padded, T(0));
+        }
+        for (std::size_t i = 0; i < padded; ++i) {
+            const std::size_t j = g.begin + std::min(i, count - 1);
+            buf.tx[i] = x_[j];
+            buf.ty[i] = y_[j];
+            buf.tz[i] = z_[j];
+        }
+
+        const T eps = config_.softening.base_value();
+        const std::array<const T *, 3> target = {buf.tx.data(), buf.ty.data(),
+                                                 buf.tz.data()};
+        const std::array<T *, 3> acc = {buf.ax.data(), buf.ay.data(),
+                                        buf.az.data()};
+        const std::size_t sources = buf.m.size();
+        constexpr std::size_t tile = detail::gravity_tile<T>;
+        for (std::size_t j = 0; j < sources; j += tile) {
+            const std::array<const T *, 4> src = {
+                buf.x.data() + j, buf.y.data() + j, buf.z.data() + j,
+                buf.m.data() + j};
+            detail::simd_for<detail::gravity_op, T>(
+                padded, target, acc, src, std::min(tile, sources - j),
+                eps * eps);
+        }
+
+        const T unit = detail::gravity_unit<T>(config_.G);
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::uint32_t body = order_[g.begin + i];
+            out[0][body] = buf.ax[i] * unit;
+            out[1][body] = buf.ay[i] * unit;
+            out[2][body] = buf.az[i] * unit;
+        }
+        return static_cast<std::uint64_t>(count) * sources;
+    }
+};
+
+} // namespace physi
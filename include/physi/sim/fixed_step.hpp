@@ -0,0 +1,196 @@
+#pragma once
+
+#include "../array/vec_array.hpp"
+#include "../quantities.hpp"
+#include "../vec/vec.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Fixed-timestep simulation clock:
+//
+//   fixed_step_driver<double> clock({.dt = time_d(1.0 / 120), .substeps = 2});
+//   clock.track(world.positions());
+//   while (running) {
+//       clock.advance(frame_time, [&](time_d h) { world.step(h); });
+//       clock.interpolate(render_positions);     // between the last 2 steps
+//   }
+//
+// advance() adds real elapsed time to an accumulator and calls the step
+// function for every whole `dt` in it, `substeps` times with dt / substeps
+// each. A step function that also takes the substep index can run stiff
+// subsystems on every substep and the rest once per step. The remainder
+// carries over to the next frame, so the simulation runs at its own rate
+// whatever the frame rate. At most `max_steps` steps run per call; time
+// beyond that is dropped (and counted in dropped_time()) rather than owed,
+// so one slow frame cannot make every later frame slower.
+//
+// Rendering or export in between lands alpha() of the way into the next
+// step. For that, the driver keeps a copy of the tracked positions taken
+// before the last step of each advance(), and interpolate() blends it with
+// the live positions. Rows must keep their meaning across that step: rows
+// added since are taken as they are, and compacting a particle pool
+// invalidates the copy until the next step.
+
+namespace physi {
+
+// step(h), or step(h, substep) for callers that sub-step only part of the
+// frame (substep runs from 0 to substeps - 1).
+template <typename F, typename T>
+concept fixed_step_function =
+    std::invocable<F &, time<T>> || std::invocable<F &, time<T>, std::size_t>;
+
+template <typename T = double> struct fixed_step_config {
+    time<T> dt{T(1) / T(60)};
+    // Steps one advance() may run; later time is dropped.
+    std::size_t max_steps = 8;
+    // Calls of the step function per step, each of dt / substeps.
+    std::size_t substeps = 1;
+};
+
+template <typename T = double> class fixed_step_driver {
+  public:
+    using value_type = T;
+    using time_type = time<T>;
+    using length_type = length<T>;
+    using config = fixed_step_config<T>;
+
+    explicit fixed_step_driver(config cfg = {}) : config_(cfg) {
+        assert(config_.dt.base_value() > T(0) && "step must be positive");
+        assert(config_.substeps > 0 && "at least one substep");
+    }
+
+    // ========== Stepping ==========
+    // Returns the number of fixed steps run.
+    template <fixed_step_function<T> Step>
+    std::size_t advance(time_type elapsed, Step &&step) {
+        assert(elapsed.base_value() >= T(0) && "time runs forward");
+        const T dt = config_.dt.base_value();
+        accumulated_ += elapsed.base_value();
+        // A frame of exactly dt must not leave the step a rounding error
+        // short, or the loop alternates between 0 and 2 steps per frame.
+        const T due = std::floor(accumulated_ / dt + step_tolerance);
+        std::size_t n = config_.max_steps;
+        if (due <= static_cast<T>(n)) {
+            n = static_cast<std::size_t>(due);
+        } else {
+            const T excess = due - static_cast<T>(n);
+            dropped_ += excess * dt;
+            accumulated_ -= excess * dt;
+        }
+
+        const time_type h = config_.dt / static_cast<T>(config_.substeps);
+        for (std::size_t k = 0; k < n; ++k) {
+            if (k + 1 == n && tracked_ != nullptr) {
+                previous_ = *tracked_;
+            }
+            for (std::size_t s = 0; s < config_.substeps; ++s) {
+                if constexpr (std::invocable<Step &, time_type, std::size_t>) {
+                    step(h, s);
+                } else {
+                    step(h);
+                }
+            }
+            accumulated_ = std::max(accumulated_ - dt, T(0));
+            ++steps_;
+        }
+        return n;
+    }
+
+    // Real time from a std::chrono clock
+    template <typename Rep, typename Period, fixed_step_function<T> Step>
+    std::size_t advance(std::chrono::duration<Rep, Period> elapsed,
+                        Step &&step) {
+        return advance(
+            time_type(std::chrono::duration<T>(elapsed).count()), step);
+    }
+
+    // Forgets the accumulated time, the step count and the snapshot.
+    void reset() noexcept {
+        accumulated_ = T(0);
+        dropped_ = T(0);
+        steps_ = 0;
+        previous_.clear();
+    }
+
+    // ========== Interpolated output ==========
+    // Positions to snapshot before each advance()'s last step. They must
+    // outlive the driver or the next track() call.
+    void track(const vec3_array<length_type> &positions) noexcept {
+        tracked_ = &positions;
+        previous_.clear();
+    }
+
+    // The tracked positions alpha() of the way from the state before the
+    // last step to the current one.
+    void interpolate(vec3_array<length_type> &out) const {
+        assert(tracked_ != nullptr && "nothing tracked");
+        const std::size_t n = tracked_->size();
+        const std::size_t blended = std::min(n, previous_.size());
+        const T a = alpha();
+        out.resize(n);
+        for (glm::length_t c = 0; c < 3; ++c) {
+            const T *from = previous_.component(c).base_data();
+            const T *to = tracked_->component(c).base_data();
+            T *dst = out.component(c).base_data();
+            for (std::size_t i = 0; i < blended; ++i) {
+                dst[i] = from[i] + (to[i] - from[i]) * a;
+            }
+            std::copy(to + blended, to + n, dst + blended);
+        }
+    }
+
+    [[nodiscard]] vec3<length_type> interpolated(std::size_t i) const {
+        assert(tracked_ != nullptr && i < tracked_->size());
+        const vec3<length_type> to = (*tracked_)[i];
+        if (i >= previous_.size()) {
+            return to;
+        }
+        const vec3<length_type> from = previous_[i];
+        return from + (to - from) * alpha();
+    }
+
+    // ========== Clock state ==========
+    // Fraction of a step accumulated but not yet run, in [0, 1]
+    [[nodiscard]] T alpha() const noexcept {
+        return std::min(accumulated_ / config_.dt.base_value(), T(1));
+    }
+
+    [[nodiscard]] time_type accumulated() const noexcept {
+        return time_type(accumulated_);
+    }
+
+    // Simulated time: the steps run so far times dt, free of the rounding a
+    // running sum would pick up.
+    [[nodiscard]] time_type simulated_time() const noexcept {
+        return config_.dt * static_cast<T>(steps_);
+    }
+
+    // Elapsed time skipped because of the max_steps cap
+    [[nodiscard]] time_type dropped_time() const noexcept {
+        return time_type(dropped_);
+    }
+
+    [[nodiscard]] std::uint64_t steps() const noexcept { return steps_; }
+    [[nodiscard]] time_type dt() const noexcept { return config_.dt; }
+    [[nodiscard]] const config &settings() const noexcept { return config_; }
+
+  private:
+    static constexpr T step_tolerance =
+        T(64) * std::numeric_limits<T>::epsilon();
+
+    config config_;
+    T accumulated_ = T(0);
+    T dropped_ = T(0);
+    std::uint64_t steps_ = 0;
+    const vec3_array<length_type> *tracked_ = nullptr;
+    vec3_array<length_type> previous_;
+};
+
+} // namespace physi
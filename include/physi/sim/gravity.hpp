@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../core/simd.hpp"
+#include "../quantities.hpp"
+
+#include <array>
+#include <cstddef>
+
+// Newtonian gravity shared by the N-body engines: G as a dimensioned
+// constant and the SIMD pair kernel
+//   a_i += sum_j m_j (x_j - x_i) / (|x_j - x_i|^2 + eps^2)^(3/2)
+// (Plummer softening eps, which also makes the self term vanish).
+
+namespace physi {
+
+// Dimension of G: force * area / mass^2 (m^3 kg^-1 s^-2).
+template <typename T>
+using gravitational_constant_t =
+    quotient_t<product_t<force<T>, area<T>>, product_t<mass<T>, mass<T>>>;
+
+// CODATA 2018 value.
+template <typename T = double>
+inline constexpr gravitational_constant_t<T> gravitational_constant{
+    static_cast<T>(6.67430e-11)};
+
+namespace detail {
+
+// Sources per tile: four columns (x, y, z, m) of 16 KiB in total.
+template <typename T>
+inline constexpr std::size_t gravity_tile = 16384 / (4 * sizeof(T));
+
+// Base-unit factor turning the kernel's mass / length^2 sums into
+// accelerations.
+template <typename T>
+[[nodiscard]] T gravity_unit(const gravitational_constant_t<T> &G) noexcept {
+    // G * mass / length^2 must be an acceleration
+    const length<T> one_m(T(1));
+    const acceleration<T> unit = G * mass<T>(T(1)) / (one_m * one_m);
+    return unit.base_value();
+}
+
+// Accumulates the (G-less) softened acceleration of targets [i, i + width)
+// from `count` point masses (x, y, z, m columns) into acc.
+struct gravity_op {
+    template <typename P, typename T>
+    PHYSI_FORCE_INLINE static void
+    apply(std::size_t i, const std::array<const T *, 3> &target,
+          const std::array<T *, 3> &acc, const std::array<const T *, 4> &src,
+          const std::size_t &count, const T &eps2) noexcept {
+        const P xi = P::load(target[0] + i);
+        const P yi = P::load(target[1] + i);
+        const P zi = P::load(target[2] + i);
+        const P soft = P::broadcast(eps2);
+        P ax = P::load(acc[0] + i);
+        P ay = P::load(acc[1] + i);
+        P az = P::load(acc[2] + i);
+        for (std::size_t j = 0; j < count; ++j) {
+            const P dx = P::broadcast(src[0][j]) - xi;
+            const P dy = P::broadcast(src[1][j]) - yi;
+            const P dz = P::broadcast(src[2][j]) - zi;
+            const P inv = rsqrt(dx * dx + dy * dy + dz * dz + soft);
+            const P s = P::broadcast(src[3][j]) * inv * inv * inv;
+            ax = ax + dx * s;
+            ay = ay + dy * s;
+            az = az + dz * s;
+        }
+        ax.store(acc[0] + i);
+        ay.store(acc[1] + i);
+        az.store(acc[2] + i);
+    }
+};
+
+} // namespace detail
+
+} // namespace physi
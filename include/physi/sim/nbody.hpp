@@ -0,0 +1,320 @@
+#pragma once
+
+#include "../algorithm/reduce.hpp"
+#include "../array/quantity_array.hpp"
+#include "../array/vec_array.hpp"
+#include "../core/parallel.hpp"
+#include "../core/simd.hpp"
+#include "../quantities.hpp"
+#include "barnes_hut.hpp"
+#include "gravity.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Gravitational N-body engine on structure-of-arrays state:
+//
+//   nbody_system<double> sys({.softening = length_d(1e7)});
+//   sys.add(position, velocity, 5.97e24_kg);
+//   ...
+//   for (int i = 0; i < steps; ++i) sys.step(time_d(3600));
+//   energy_d e = sys.kinetic_energy() + sys.potential_energy();
+//
+// Accelerations are the blocked O(N^2) softened sum of gravity.hpp. Targets
+// are split across threads and processed a SIMD pack at a time against tiles
+// of sources small enough to stay in L1. With force_method::barnes_hut the
+// sum is approximated by an octree rebuilt on every evaluation, which pays
+// off from a few tens of thousands of bodies.
+
+namespace physi {
+
+enum class force_method {
+    // Blocked O(N^2) summation over every pair.
+    direct,
+    // O(N log N) octree approximation (see barnes_hut.hpp).
+    barnes_hut,
+};
+
+enum class integrator {
+    // Kick-drift-kick: half-step velocity updates around a full position
+    // update. Positions, velocities and accelerations stay synchronized.
+    velocity_verlet,
+    // Drift-kick-drift (position Verlet): half-step drifts around one kick.
+    leapfrog,
+};
+
+template <typename T> struct nbody_config {
+    // Plummer softening length; must be positive. Set it near the smallest
+    // separation that matters, e.g. 1e7 m for planets; the 1 m default only
+    // keeps a default-configured system finite.
+    length<T> softening{T(1)};
+    gravitational_constant_t<T> G = gravitational_constant<T>;
+    integrator scheme = integrator::velocity_verlet;
+    // Worker threads for the force evaluation (0 = hardware threads).
+    std::size_t threads = 0;
+    // How kinetic_energy(), potential_energy() and total_momentum() combine
+    // partial sums; reduction::reproducible makes them independent of
+    // `threads` bit for bit.
+    reduction totals = reduction::fast;
+    force_method method = force_method::direct;
+    // Barnes-Hut opening angle (method == force_method::barnes_hut).
+    T theta = T(0.5);
+};
+
+template <typename T = double> class nbody_system {
+  public:
+    using value_type = T;
+    using length_type = length<T>;
+    using speed_type = speed<T>;
+    using mass_type = mass<T>;
+    using acceleration_type = acceleration<T>;
+
+    using config = nbody_config<T>;
+
+  private:
+    config config_;
+    vec3_array<length_type> position_;
+    vec3_array<speed_type> velocity_;
+    quantity_array<mass_type> mass_;
+    vec3_array<acceleration_type> acceleration_;
+    bool acceleration_valid_ = false;
+    std::uint64_t interactions_ = 0;
+    barnes_hut<T> tree_;
+
+  public:
+    explicit nbody_system(config c = {})
+        : config_(c), tree_({.theta = c.theta,
+                             .softening = c.softening,
+                             .G = c.G,
+                             .threads = c.threads}) {
+        assert(config_.softening.base_value() > T(0) &&
+               "nbody_system needs a positive softening length");
+    }
+
+    // ========== Bodies ==========
+    // Returns the index of the new body.
+    std::size_t add(const vec3<length_type> &x, const vec3<speed_type> &v,
+                    mass_type m) {
+        position_.push_back(x);
+        velocity_.push_back(v);
+        mass_.push_back(m);
+        acceleration_.push_back({});
+        acceleration_valid_ = false;
+        return mass_.size() - 1;
+    }
+
+    void reserve(std::size_t n) {
+        position_.reserve(n);
+        velocity_.reserve(n);
+        mass_.reserve(n);
+        acceleration_.reserve(n);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return mass_.size(); }
+    [[nodiscard]] const config &settings() const noexcept { return config_; }
+
+    // The octree of the last Barnes-Hut evaluation (build and traversal
+    // timings).
+    [[nodiscard]] const barnes_hut<T> &tree() const noexcept { return tree_; }
+
+    // Moving a body or changing its mass invalidates the cached
+    // accelerations; velocities can be edited in place.
+    void set_position(std::size_t i, const vec3<length_type> &x) {
+        position_.set(i, x);
+        acceleration_valid_ = false;
+    }
+    void set_mass(std::size_t i, mass_type m) {
+        mass_[i] = m;
+        acceleration_valid_ = false;
+    }
+    [[nodiscard]] vec3_array<speed_type> &velocities() noexcept {
+        return velocity_;
+    }
+
+    [[nodiscard]] const vec3_array<length_type> &positions() const noexcept {
+        return position_;
+    }
+    [[nodiscard]] const vec3_array<speed_type> &velocities() const noexcept {
+        return velocity_;
+    }
+    [[nodiscard]] const quantity_array<mass_type> &masses() const noexcept {
+        return mass_;
+    }
+
+    // Accelerations at the current positions.
+    [[nodiscard]] const vec3_array<acceleration_type> &accelerations() {
+        if (!acceleration_valid_) {
+            compute_accelerations();
+        }
+        return acceleration_;
+    }
+
+    // ========== Forces ==========
+    // Recomputes every acceleration (N^2 pair interactions, or one tree
+    // build and walk).
+    void compute_accelerations() {
+        if (config_.method == force_method::barnes_hut) {
+            tree_.build(position_, mass_);
+            interactions_ += tree_.accelerations(acceleration_);
+            acceleration_valid_ = true;
+            return;
+        }
+        const std::size_t n = size();
+        const T eps = config_.softening.base_value();
+        const T eps2 = eps * eps;
+        const T unit = detail::gravity_unit<T>(config_.G);
+
+        std::array<const T *, 3> x;
+        std::array<T *, 3> a;
+        for (glm::length_t c = 0; c < 3; ++c) {
+            x[c] = position_.component(c).base_data();
+            a[c] = acceleration_.component(c).base_data();
+        }
+        const T *m = mass_.base_data();
+
+        parallel_for(
+            n,
+            [&](std::size_t begin, std::size_t end) {
+                const std::array<const T *, 3> target = {
+                    x[0] + begin, x[1] + begin, x[2] + begin};
+                const std::array<T *, 3> acc = {a[0] + begin, a[1] + begin,
+                                                a[2] + begin};
+                for (glm::length_t c = 0; c < 3; ++c) {
+                    std::fill(acc[c], acc[c] + (end - begin), T(0));
+                }
+                constexpr std::size_t tile = detail::gravity_tile<T>;
+                for (std::size_t j = 0; j < n; j += tile) {
+                    const std::array<const T *, 4> src = {x[0] + j, x[1] + j,
+                                                          x[2] + j, m + j};
+                    const std::size_t count = std::min(tile, n - j);
+                    detail::simd_for<detail::gravity_op, T>(
+                        end - begin, target, acc, src, count, eps2);
+                }
+                for (glm::length_t c = 0; c < 3; ++c) {
+                    for (std::size_t i = 0; i < end - begin; ++i) {
+                        acc[c][i] *= unit;
+                    }
+                }
+            },
+            threads_for(n));
+        acceleration_valid_ = true;
+        interactions_ += static_cast<std::uint64_t>(n) * n;
+    }
+
+    // ========== Integration ==========
+    // Advances every body by dt with the configured scheme (one force
+    // evaluation per step).
+    void step(time<T> dt) {
+        const time<T> half = dt * T(0.5);
+        if (config_.scheme == integrator::velocity_verlet) {
+            velocity_ += accelerations() * half;
+            position_ += velocity_ * dt;
+            compute_accelerations();
+            velocity_ += acceleration_ * half;
+        } else {
+            position_ += velocity_ * half;
+            compute_accelerations();
+            velocity_ += acceleration_ * dt;
+            position_ += velocity_ * half;
+            acceleration_valid_ = false;
+        }
+    }
+
+    // Interactions evaluated so far (N^2 per direct force evaluation), for
+    // throughput reporting.
+    [[nodiscard]] std::uint64_t interactions() const noexcept {
+        return interactions_;
+    }
+
+    // ========== Diagnostics ==========
+    [[nodiscard]] energy<T> kinetic_energy() const {
+        quantity_array<product_t<speed_type, speed_type>> v2(size());
+        for (glm::length_t c = 0; c < 3; ++c) {
+            v2 += velocity_.component(c) * velocity_.component(c);
+        }
+        return sum_of_products(mass_, v2, config_.totals, config_.threads) *
+               T(0.5);
+    }
+
+    // Softened pair potential -G m_i m_j / sqrt(r^2 + eps^2) over all pairs.
+    [[nodiscard]] energy<T> potential_energy() const {
+        const std::size_t n = size();
+        const T eps = config_.softening.base_value();
+        const T *x = position_.x().base_data();
+        const T *y = position_.y().base_data();
+        const T *z = position_.z().base_data();
+        const T *m = mass_.base_data();
+        const auto row = [&](std::size_t i) {
+            T si = 0;
+            for (std::size_t j = i + 1; j < n; ++j) {
+                const T dx = x[j] - x[i], dy = y[j] - y[i], dz = z[j] - z[i];
+                si += m[j] / std::sqrt(dx * dx + dy * dy + dz * dz + eps * eps);
+            }
+            return m[i] * si;
+        };
+        // Row i has n - 1 - i pairs, so rows are taken in pairs from both
+        // ends: fold k is rows k and n - 1 - k, n - 1 pairs whatever k is,
+        // and contiguous ranges of folds are equally expensive.
+        const std::size_t folds = (n + 1) / 2;
+        const auto rows = [&](std::size_t begin, std::size_t end) {
+            T s = 0;
+            for (std::size_t k = begin; k < end; ++k) {
+                s += row(k);
+                if (n - 1 - k != k) {
+                    s += row(n - 1 - k);
+                }
+            }
+            return s;
+        };
+        T total = 0;
+        if (config_.totals == reduction::reproducible) {
+            // Folds cost O(n) each, so blocks are a few folds long.
+            constexpr std::size_t folds_per_block = 8;
+            total = detail::tree_reduce<T>(folds, folds_per_block, rows,
+                                           threads_for(n));
+        } else {
+            const std::size_t chunks =
+                std::max<std::size_t>(1, std::min(threads_for(n), folds));
+            std::vector<T> partial(chunks, T(0));
+            parallel_for(
+                chunks,
+                [&](std::size_t first, std::size_t last) {
+                    for (std::size_t c = first; c < last; ++c) {
+                        partial[c] = rows(folds * c / chunks,
+                                          folds * (c + 1) / chunks);
+                    }
+                },
+                chunks);
+            for (const T p : partial) {
+                total += p;
+            }
+        }
+        // G * mass^2 / length is an energy
+        const energy<T> unit =
+            config_.G * mass_type(T(1)) * mass_type(T(1)) / length_type(T(1));
+        return -unit * total;
+    }
+
+    [[nodiscard]] vec3<momentum<T>> total_momentum() const {
+        const vec3_array<momentum<T>> p = velocity_ * mass_;
+        return sum(p, config_.totals, config_.threads);
+    }
+
+  private:
+    // Small systems run on the calling thread.
+    [[nodiscard]] std::size_t threads_for(std::size_t n) const noexcept {
+        constexpr std::size_t min_bodies_per_thread = 256;
+        const std::size_t threads = config_.threads == 0
+                                        ? default_thread_count()
+                                        : config_.threads;
+        return std::max<std::size_t>(
+            1, std::min(threads, n / min_bodies_per_thread));
+    }
+};
+
+} // namespace physi
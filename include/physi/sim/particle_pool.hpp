@@ -0,0 +1,444 @@
+#pragma once
+
+#include "../array/quantity_array.hpp"
+#include "../array/vec_array.hpp"
+#include "../core/parallel.hpp"
+#include "../quantities.hpp"
+#include "../vec/vec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Pooled particles on preallocated structure-of-arrays columns:
+//
+//   particle_pool<float> pool(200'000);
+//   auto h = pool.spawn(x, v, 1_g, 2_s);       // O(1), no allocation
+//   pool.kill(h);                              // O(1); h is stale from now on
+//   pool.advance(time_f(1.0f / 60), gravity);  // whole-column kernels
+//   pool.compact();                            // close holes, in parallel
+//
+// Particles occupy rows [0, rows()) of the columns. kill() only marks its
+// row dead, so the columns keep holes whose stale values are harmless to
+// update; compact() retires particles whose lifetime has run out and fills
+// the holes with live rows from the tail, so it moves one row per hole
+// rather than every row. Between compactions the columns feed the array
+// operators and batch kernels directly.
+//
+// Handles survive compaction: a handle names a slot that tracks the
+// particle's current row, plus the slot's generation. kill() bumps the
+// generation, so a handle to a dead particle, or to a slot a later spawn
+// reused, is detected instead of aliasing another particle.
+//
+// Every buffer is reserved up front. spawn() compacts when it reaches the
+// capacity with holes left and grows the pool only when every row is live.
+// allocations() counts the buffer allocations so far, so a steady-state
+// frame loop can check that the count stays flat.
+
+namespace physi {
+
+struct particle_pool_config {
+    // Worker threads for compact() (0 = hardware threads).
+    std::size_t threads = 0;
+};
+
+template <typename T = float> class particle_pool {
+  public:
+    using value_type = T;
+    using length_type = length<T>;
+    using speed_type = speed<T>;
+    using mass_type = physi::mass<T>;
+    using time_type = time<T>;
+    using acceleration_type = acceleration<T>;
+
+    using config = particle_pool_config;
+
+    struct handle {
+        std::uint32_t slot = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t generation = 0;
+
+        friend bool operator==(const handle &, const handle &) = default;
+    };
+
+  private:
+    static constexpr std::uint32_t none =
+        std::numeric_limits<std::uint32_t>::max();
+
+    struct slot {
+        std::uint32_t row = none;
+        std::uint32_t generation = 0;
+    };
+
+    // x, y, z, vx, vy, vz, mass, lifetime
+    static constexpr std::size_t columns = 8;
+
+    // Per-chunk tallies of compact(), turned into prefix sums.
+    struct chunk_counts {
+        std::size_t kept = 0;    // live rows that stay live
+        std::size_t retired = 0; // lifetime ran out
+        std::size_t holes = 0;   // dead rows below the new end
+        std::size_t movers = 0;  // live rows at or past the new end
+    };
+
+    config config_;
+    vec3_array<length_type> position_;
+    vec3_array<speed_type> velocity_;
+    quantity_array<mass_type> mass_;
+    quantity_array<time_type> lifetime_;
+    // Slot of each row; none for a killed row.
+    std::vector<std::uint32_t> owner_;
+    std::vector<slot> slots_;
+    std::vector<std::uint32_t> free_slots_;
+    std::vector<chunk_counts> counts_;
+    std::vector<std::uint32_t> holes_, movers_;
+    std::size_t capacity_ = 0;
+    std::size_t live_ = 0;
+    std::uint64_t allocations_ = 0;
+
+  public:
+    explicit particle_pool(std::size_t capacity, config c = {})
+        : config_(c) {
+        reserve(capacity);
+        reserve_buffer(counts_, max_threads() + 1);
+    }
+
+    // ========== Particles ==========
+    // O(1). Allocates only when every row up to the capacity is live.
+    handle spawn(const vec3<length_type> &x, const vec3<speed_type> &v,
+                 mass_type m, time_type lifetime) {
+        if (rows() == capacity_) {
+            if (live_ < rows()) {
+                compact();
+            } else {
+                reserve(std::max<std::size_t>(64, 2 * capacity_));
+            }
+        }
+        std::uint32_t s;
+        if (free_slots_.empty()) {
+            s = static_cast<std::uint32_t>(slots_.size());
+            slots_.push_back({});
+        } else {
+            s = free_slots_.back();
+            free_slots_.pop_back();
+        }
+        slots_[s].row = static_cast<std::uint32_t>(rows());
+        position_.push_back(x);
+        velocity_.push_back(v);
+        mass_.push_back(m);
+        lifetime_.push_back(lifetime);
+        owner_.push_back(s);
+        ++live_;
+        return {s, slots_[s].generation};
+    }
+
+    // O(1): marks the row dead and invalidates h. Returns false for a stale
+    // handle.
+    bool kill(handle h) noexcept {
+        if (!alive(h)) {
+            return false;
+        }
+        slot &s = slots_[h.slot];
+        owner_[s.row] = none;
+        release(h.slot);
+        --live_;
+        return true;
+    }
+
+    // Kills every particle; outstanding handles become stale.
+    void clear() noexcept {
+        for (std::size_t i = 0; i < rows(); ++i) {
+            if (owner_[i] != none) {
+                release(owner_[i]);
+            }
+        }
+        resize_columns(0);
+        live_ = 0;
+    }
+
+    // True until the particle is killed or retired by compact().
+    [[nodiscard]] bool alive(handle h) const noexcept {
+        return h.slot < slots_.size() &&
+               slots_[h.slot].generation == h.generation &&
+               slots_[h.slot].row != none;
+    }
+
+    // Current row of a live particle (changes on compaction).
+    [[nodiscard]] std::size_t row(handle h) const noexcept {
+        assert(alive(h) && "stale particle handle");
+        return slots_[h.slot].row;
+    }
+
+    // Handle of the particle in row i, e.g. to kill it from a kernel's
+    // results; a default handle when the row is dead.
+    [[nodiscard]] handle handle_at(std::size_t i) const noexcept {
+        const std::uint32_t s = owner_[i];
+        return s == none ? handle{} : handle{s, slots_[s].generation};
+    }
+
+    [[nodiscard]] bool row_alive(std::size_t i) const noexcept {
+        return owner_[i] != none;
+    }
+
+    [[nodiscard]] vec3<length_type> position(handle h) const noexcept {
+        return position_[row(h)];
+    }
+    [[nodiscard]] vec3<speed_type> velocity(handle h) const noexcept {
+        return velocity_[row(h)];
+    }
+    [[nodiscard]] mass_type mass(handle h) const noexcept {
+        return mass_[row(h)];
+    }
+    [[nodiscard]] time_type lifetime(handle h) const noexcept {
+        return lifetime_[row(h)];
+    }
+
+    // ========== Columns ==========
+    // Rows [0, rows()), dead ones included. Kernels may update values in
+    // place but must not resize the columns.
+    [[nodiscard]] vec3_array<length_type> &positions() noexcept {
+        return position_;
+    }
+    [[nodiscard]] vec3_array<speed_type> &velocities() noexcept {
+        return velocity_;
+    }
+    [[nodiscard]] quantity_array<mass_type> &masses() noexcept {
+        return mass_;
+    }
+    // Remaining lifetimes; rows at or below zero are retired by compact().
+    [[nodiscard]] quantity_array<time_type> &lifetimes() noexcept {
+        return lifetime_;
+    }
+    [[nodiscard]] const vec3_array<length_type> &positions() const noexcept {
+        return position_;
+    }
+    [[nodiscard]] const vec3_array<speed_type> &velocities() const noexcept {
+        return velocity_;
+    }
+    [[nodiscard]] const quantity_array<mass_type> &masses() const noexcept {
+        return mass_;
+    }
+    [[nodiscard]] const quantity_array<time_type> &lifetimes() const noexcept {
+        return lifetime_;
+    }
+
+    // ========== Update ==========
+    // Ballistic step of every row under a uniform acceleration, and the
+    // lifetimes counted down by dt.
+    void advance(time_type dt, const vec3<acceleration_type> &g = {}) {
+        velocity_ += g * dt;
+        position_ += velocity_ * dt;
+        lifetime_ -= dt;
+    }
+
+    // Retires particles whose lifetime has run out and fills every hole
+    // below the new end with a live row from past it. Rows are classified,
+    // counted and gathered in parallel chunks, then the movers are copied
+    // in parallel; nothing is allocated and the result does not depend on
+    // the thread count. Row order is not preserved.
+    void compact() {
+        const std::size_t n = rows();
+        const std::size_t chunks = chunks_for(n);
+        const T *life = lifetime_.base_data();
+        counts_.assign(chunks + 1, {});
+
+        std::uint32_t *owner = owner_.data();
+        for_chunks(n, chunks,
+                   [&](std::size_t ch, std::size_t begin, std::size_t end) {
+                       std::size_t kept = 0, retired = 0;
+                       for (std::size_t i = begin; i < end; ++i) {
+                           const bool used = owner[i] != none;
+                           const bool expired = !(life[i] > T(0));
+                           kept += used & !expired;
+                           retired += used & expired;
+                       }
+                       counts_[ch + 1].kept = kept;
+                       counts_[ch + 1].retired = retired;
+                   });
+        prefix_sums(chunks, &chunk_counts::kept, &chunk_counts::retired);
+
+        // retire, then count holes below the new end and movers past it
+        const std::size_t end_row = counts_[chunks].kept;
+        const std::size_t free_base = free_slots_.size();
+        free_slots_.resize(free_base + counts_[chunks].retired);
+        for_chunks(n, chunks,
+                   [&](std::size_t ch, std::size_t begin, std::size_t end) {
+                       // Branch-free gathers: every row is written to the
+                       // next entry, which only advances on a match. The
+                       // loops stop once the chunk's range is full, so the
+                       // speculative writes stay inside it.
+                       const std::size_t first =
+                           free_base + counts_[ch].retired;
+                       const std::size_t last =
+                           free_base + counts_[ch + 1].retired;
+                       std::size_t r = first;
+                       for (std::size_t i = begin; r < last; ++i) {
+                           const std::uint32_t s = owner[i];
+                           const bool expired =
+                               (s != none) & !(life[i] > T(0));
+                           free_slots_[r] = s;
+                           owner[i] = expired ? none : s;
+                           r += expired;
+                       }
+                       for (r = first; r < last; ++r) {
+                           slot &s = slots_[free_slots_[r]];
+                           s.row = none;
+                           ++s.generation;
+                       }
+                       const std::size_t split =
+                           std::clamp(end_row, begin, end);
+                       std::size_t holes = 0, movers = 0;
+                       for (std::size_t i = begin; i < split; ++i) {
+                           holes += owner[i] == none;
+                       }
+                       for (std::size_t i = split; i < end; ++i) {
+                           movers += owner[i] != none;
+                       }
+                       counts_[ch + 1].holes = holes;
+                       counts_[ch + 1].movers = movers;
+                   });
+        prefix_sums(chunks, &chunk_counts::holes, &chunk_counts::movers);
+
+        const std::size_t moves = counts_[chunks].holes;
+        assert(moves == counts_[chunks].movers);
+        holes_.resize(moves);
+        movers_.resize(moves);
+        for_chunks(n, chunks,
+                   [&](std::size_t ch, std::size_t begin, std::size_t end) {
+                       const std::size_t split =
+                           std::clamp(end_row, begin, end);
+                       std::size_t h = counts_[ch].holes;
+                       std::size_t m = counts_[ch].movers;
+                       const std::size_t h_end = counts_[ch + 1].holes;
+                       const std::size_t m_end = counts_[ch + 1].movers;
+                       for (std::size_t i = begin; h < h_end; ++i) {
+                           holes_[h] = static_cast<std::uint32_t>(i);
+                           h += owner[i] == none;
+                       }
+                       for (std::size_t i = split; m < m_end; ++i) {
+                           movers_[m] = static_cast<std::uint32_t>(i);
+                           m += owner[i] != none;
+                       }
+                   });
+
+        const std::array<T *, columns> col = column_pointers();
+        parallel_for(
+            moves,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t j = begin; j < end; ++j) {
+                    const std::uint32_t from = movers_[j], to = holes_[j];
+                    for (std::size_t c = 0; c < columns; ++c) {
+                        col[c][to] = col[c][from];
+                    }
+                    const std::uint32_t s = owner[from];
+                    owner[to] = s;
+                    slots_[s].row = to;
+                }
+            },
+            chunks_for(moves));
+
+        resize_columns(end_row);
+        live_ = end_row;
+    }
+
+    // ========== Capacity ==========
+    // Grows every buffer to hold n particles without further allocation.
+    void reserve(std::size_t n) {
+        if (n <= capacity_) {
+            return;
+        }
+        for (glm::length_t c = 0; c < 3; ++c) {
+            reserve_buffer(position_.component(c), n);
+            reserve_buffer(velocity_.component(c), n);
+        }
+        reserve_buffer(mass_, n);
+        reserve_buffer(lifetime_, n);
+        reserve_buffer(owner_, n);
+        reserve_buffer(slots_, n);
+        reserve_buffer(free_slots_, n);
+        reserve_buffer(holes_, n);
+        reserve_buffer(movers_, n);
+        capacity_ = n;
+    }
+
+    // Live particles (retirees count until the next compact()).
+    [[nodiscard]] std::size_t size() const noexcept { return live_; }
+    // Occupied rows, holes included.
+    [[nodiscard]] std::size_t rows() const noexcept { return owner_.size(); }
+    [[nodiscard]] std::size_t dead_rows() const noexcept {
+        return rows() - live_;
+    }
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] const config &settings() const noexcept { return config_; }
+
+    // Heap allocations of the pool's buffers so far, construction included.
+    [[nodiscard]] std::uint64_t allocations() const noexcept {
+        return allocations_;
+    }
+
+  private:
+    void release(std::uint32_t s) noexcept {
+        slots_[s].row = none;
+        ++slots_[s].generation;
+        free_slots_.push_back(s);
+    }
+
+    void resize_columns(std::size_t n) {
+        position_.resize(n);
+        velocity_.resize(n);
+        mass_.resize(n);
+        lifetime_.resize(n);
+        owner_.resize(n);
+    }
+
+    template <typename Buffer>
+    void reserve_buffer(Buffer &b, std::size_t n) {
+        const std::size_t before = b.capacity();
+        b.reserve(n);
+        allocations_ += b.capacity() != before;
+    }
+
+    [[nodiscard]] std::array<T *, columns> column_pointers() noexcept {
+        return {position_.x().base_data(), position_.y().base_data(),
+                position_.z().base_data(), velocity_.x().base_data(),
+                velocity_.y().base_data(), velocity_.z().base_data(),
+                mass_.base_data(),         lifetime_.base_data()};
+    }
+
+    // Turns the per-chunk tallies in counts_[1..chunks] into offsets.
+    template <typename... Fields>
+    void prefix_sums(std::size_t chunks, Fields... fields) noexcept {
+        for (std::size_t ch = 0; ch < chunks; ++ch) {
+            ((counts_[ch + 1].*fields += counts_[ch].*fields), ...);
+        }
+    }
+
+    [[nodiscard]] std::size_t max_threads() const noexcept {
+        return config_.threads == 0 ? default_thread_count() : config_.threads;
+    }
+
+    // Small pools compact on the calling thread.
+    [[nodiscard]] std::size_t chunks_for(std::size_t n) const noexcept {
+        constexpr std::size_t min_rows_per_thread = 16384;
+        return std::max<std::size_t>(
+            1, std::min(max_threads(), n / min_rows_per_thread));
+    }
+
+    // Runs f(chunk, begin, end) over [0, n) in `chunks` contiguous chunks.
+    template <typename F>
+    static void for_chunks(std::size_t n, std::size_t chunks, F &&f) {
+        parallel_for(
+            chunks,
+            [&](std::size_t first, std::size_t last) {
+                for (std::size_t ch = first; ch < last; ++ch) {
+                    f(ch, n * ch / chunks, n * (ch + 1) / chunks);
+                }
+            },
+            chunks);
+    }
+};
+
+} // namespace physi
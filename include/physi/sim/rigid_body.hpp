@@ -0,0 +1,829 @@
+#pragma once
+
+#include "../algorithm/spatial_hash.hpp"
+#include "../array/quantity_array.hpp"
+#include "../array/vec_array.hpp"
+#include "../core/parallel.hpp"
+#include "../quantities.hpp"
+#include "../vec/quat.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+// Rigid-body dynamics on structure-of-arrays state:
+//
+//   rigid_body_system<double> world({.floor = length_d(0)});
+//   const mass_d m(2.0);
+//   const length_d r(0.5);
+//   auto id = world.add({0_m, 0_m, 3_m}, m, sphere_inertia(m, r), r);
+//   for (int i = 0; i < 600; ++i) world.step(time_d(1.0 / 60));
+//
+// Bodies collide as spheres of the given radius, with each other and with an
+// optional floor plane z = floor (gravity points down z by default); a zero
+// mass makes a body static. Each step
+//   1. finds the contacts of the awake bodies through a spatial_hash; an
+//      awake body touching a sleeping one wakes that body's whole island,
+//   2. integrates velocities semi-implicitly (gravity, applied forces and
+//      torques, and the gyroscopic term of the world-frame inertia tensor),
+//   3. splits the awake bodies into islands of touching bodies and solves
+//      the contacts of independent islands in parallel with sequential
+//      impulses (restitution, Coulomb friction, Baumgarte correction),
+//   4. integrates positions and orientations, and
+//   5. puts every island that stayed below the sleep thresholds for
+//      sleep_time to sleep.
+// Sleeping and static bodies cost nothing per step, so the work follows the
+// number of awake bodies rather than the size of the scene.
+
+namespace physi {
+
+// Principal moments of a solid sphere and of a solid box (edges along the
+// body axes).
+template <typename T>
+[[nodiscard]] constexpr vec3<moment_of_inertia<T>>
+sphere_inertia(mass<T> m, length<T> radius) noexcept {
+    const moment_of_inertia<T> i = m * radius * radius * T(0.4);
+    return {i, i, i};
+}
+
+template <typename T>
+[[nodiscard]] constexpr vec3<moment_of_inertia<T>>
+box_inertia(mass<T> m, const vec3<length<T>> &size) noexcept {
+    const auto x2 = size.x() * size.x(), y2 = size.y() * size.y(),
+               z2 = size.z() * size.z();
+    const mass<T> k = m / T(12);
+    return {k * (y2 + z2), k * (x2 + z2), k * (x2 + y2)};
+}
+
+enum class body_state : std::uint8_t {
+    awake,
+    sleeping,
+    // zero mass: never moves, never sleeps
+    fixed,
+};
+
+template <typename T> struct rigid_body_config {
+    vec3<acceleration<T>> gravity{acceleration<T>(T(0)),
+                                  acceleration<T>(T(0)),
+                                  acceleration<T>(T(-9.80665))};
+    // Ground plane z = floor, if any.
+    std::optional<length<T>> floor{};
+    // Bounce of impacts faster than bounce_speed; slower ones stick.
+    T restitution = T(0.2);
+    speed<T> bounce_speed{T(1)};
+    T friction = T(0.5);
+    // Sequential-impulse sweeps over each island's contacts per step.
+    int iterations = 10;
+    // Fraction of the penetration beyond `slop` removed per step.
+    T baumgarte = T(0.2);
+    length<T> slop{T(0.005)};
+    bool allow_sleep = true;
+    speed<T> sleep_speed{T(0.05)};
+    angular_velocity<T> sleep_angular_speed{T(0.05)};
+    time<T> sleep_time{T(0.5)};
+    // Worker threads (0 = hardware threads).
+    std::size_t threads = 0;
+};
+
+template <typename T = double> class rigid_body_system {
+  public:
+    using value_type = T;
+    using id_type = std::uint32_t;
+    using length_type = length<T>;
+    using speed_type = speed<T>;
+    using mass_type = mass<T>;
+    using inertia_type = moment_of_inertia<T>;
+    using angular_velocity_type = angular_velocity<T>;
+    using angular_momentum_type = physi::angular_momentum<T>;
+    using force_type = force<T>;
+    using torque_type = torque<T>;
+    // Unit quaternion rotating body axes into world axes.
+    using orientation_type = quat<T>;
+
+    using config = rigid_body_config<T>;
+
+  private:
+    static constexpr id_type none = std::numeric_limits<id_type>::max();
+
+    using v3 = glm::vec<3, T>;
+    using m3 = std::array<T, 9>; // row-major
+
+    struct contact {
+        id_type a, b; // b == none: the floor
+        v3 normal;    // from b towards a
+        v3 ra, rb;    // contact point relative to each centre
+        T depth;
+        // solver state
+        v3 t1, t2;
+        T mass_n, mass_t1, mass_t2, target;
+        T jn, jt1, jt2;
+    };
+
+    struct island {
+        std::uint32_t body_begin, body_end;
+        std::uint32_t contact_begin, contact_end;
+    };
+
+    config config_;
+    vec3_array<length_type> position_;
+    vec3_array<speed_type> velocity_;
+    vec3_array<angular_velocity_type> angular_velocity_;
+    std::array<std::vector<T>, 4> orientation_;
+    quantity_array<mass_type> mass_;
+    vec3_array<inertia_type> inertia_;
+    quantity_array<length_type> radius_;
+    vec3_array<force_type> force_;
+    vec3_array<torque_type> torque_;
+    std::vector<T> inv_mass_;
+    std::vector<v3> inv_inertia_;       // body frame, 0 for static
+    std::vector<m3> inv_inertia_world_; // refreshed for awake bodies
+    T max_radius_ = T(0);
+
+    std::vector<body_state> state_;
+    std::vector<T> rest_time_;
+    std::vector<std::uint32_t> sleep_group_;
+    std::vector<std::vector<id_type>> groups_; // sleeping islands
+    std::vector<std::uint32_t> free_groups_;
+    std::vector<id_type> awake_;
+    std::vector<std::uint32_t> slot_; // index in awake_
+    std::vector<std::uint64_t> stamp_;
+    std::uint64_t round_ = 0;
+
+    std::optional<spatial_hash<T>> grid_;
+    std::vector<contact> contacts_;
+    std::vector<island> islands_;
+    std::vector<id_type> island_bodies_;
+
+  public:
+    explicit rigid_body_system(config c = {}) : config_(c) {
+        assert(config_.iterations > 0);
+    }
+
+    // ========== Bodies ==========
+    // Adds a body at rest with identity orientation; `inertia` holds the
+    // principal moments along the body axes. A zero mass makes it static.
+    id_type add(const vec3<length_type> &x, mass_type m,
+                const vec3<inertia_type> &inertia, length_type radius) {
+        assert(radius.base_value() > T(0) && m.base_value() >= T(0));
+        assert(size() < none);
+        const auto id = static_cast<id_type>(size());
+        const bool dynamic = m.base_value() > T(0);
+        position_.push_back(x);
+        velocity_.push_back({});
+        angular_velocity_.push_back({});
+        orientation_[0].push_back(T(1));
+        for (std::size_t c = 1; c < 4; ++c) {
+            orientation_[c].push_back(T(0));
+        }
+        mass_.push_back(m);
+        inertia_.push_back(inertia);
+        radius_.push_back(radius);
+        force_.push_back({});
+        torque_.push_back({});
+        inv_mass_.push_back(dynamic ? T(1) / m.base_value() : T(0));
+        v3 inv(T(0));
+        for (glm::length_t c = 0; c < 3 && dynamic; ++c) {
+            assert(inertia[c].base_value() > T(0));
+            inv[c] = T(1) / inertia[c].base_value();
+        }
+        inv_inertia_.push_back(inv);
+        inv_inertia_world_.push_back({});
+        state_.push_back(dynamic ? body_state::awake : body_state::fixed);
+        rest_time_.push_back(T(0));
+        sleep_group_.push_back(none);
+        slot_.push_back(0);
+        stamp_.push_back(0);
+        if (dynamic) {
+            awake_.push_back(id);
+        }
+
+        max_radius_ = std::max(max_radius_, radius.base_value());
+        if (grid_ && 2 * max_radius_ <= grid_->cell_size().base_value()) {
+            [[maybe_unused]] const auto cell = grid_->insert(x);
+            assert(cell == id);
+        } else {
+            grid_.reset(); // rebuilt with a larger cell on the next step
+        }
+        return id;
+    }
+
+    id_type add_static(const vec3<length_type> &x, length_type radius) {
+        return add(x, mass_type(T(0)), {}, radius);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return mass_.size(); }
+    [[nodiscard]] const config &settings() const noexcept { return config_; }
+
+    // Editing a dynamic body wakes it (and its island).
+    void set_position(id_type i, const vec3<length_type> &x) {
+        position_.set(i, x);
+        if (grid_) {
+            grid_->update(i, x);
+        }
+        wake(i);
+    }
+    void set_orientation(id_type i, const orientation_type &q) {
+        const orientation_type u = q.normalized();
+        orientation_[0][i] = u.w();
+        orientation_[1][i] = u.x();
+        orientation_[2][i] = u.y();
+        orientation_[3][i] = u.z();
+        wake(i);
+    }
+    void set_velocity(id_type i, const vec3<speed_type> &v) {
+        assert(state_[i] != body_state::fixed);
+        wake(i);
+        velocity_.set(i, v);
+    }
+    void set_angular_velocity(id_type i, const vec3<angular_velocity_type> &w) {
+        assert(state_[i] != body_state::fixed);
+        wake(i);
+        angular_velocity_.set(i, w);
+    }
+
+    // Forces and torques act during the next step only.
+    void apply_force(id_type i, const vec3<force_type> &f) {
+        assert(state_[i] != body_state::fixed);
+        wake(i);
+        force_.set(i, force_[i] + f);
+    }
+    void apply_torque(id_type i, const vec3<torque_type> &t) {
+        assert(state_[i] != body_state::fixed);
+        wake(i);
+        torque_.set(i, torque_[i] + t);
+    }
+    // A force through a world-space point also turns the body.
+    void apply_force_at(id_type i, const vec3<force_type> &f,
+                        const vec3<length_type> &point) {
+        apply_force(i, f);
+        apply_torque(i, vec3<torque_type>((point - position_[i]).cross(f)));
+    }
+
+    // Wakes body i's island if it is asleep.
+    void wake(id_type i) {
+        if (state_[i] == body_state::sleeping) {
+            wake_group(sleep_group_[i], nullptr);
+        }
+    }
+
+    [[nodiscard]] const vec3_array<length_type> &positions() const noexcept {
+        return position_;
+    }
+    [[nodiscard]] const vec3_array<speed_type> &velocities() const noexcept {
+        return velocity_;
+    }
+    [[nodiscard]] const vec3_array<angular_velocity_type> &
+    angular_velocities() const noexcept {
+        return angular_velocity_;
+    }
+    [[nodiscard]] const quantity_array<mass_type> &masses() const noexcept {
+        return mass_;
+    }
+    [[nodiscard]] const quantity_array<length_type> &radii() const noexcept {
+        return radius_;
+    }
+    [[nodiscard]] orientation_type orientation(id_type i) const noexcept {
+        return {orientation_[0][i], orientation_[1][i], orientation_[2][i],
+                orientation_[3][i]};
+    }
+    // World-frame inertia tensor R diag(I) R^T of body i, and the angular
+    // momentum it carries.
+    [[nodiscard]] mat3<inertia_type> inertia_tensor(id_type i) const noexcept {
+        const mat3<T> r = orientation(i).to_matrix();
+        return r * mat3<inertia_type>::diagonal(inertia_[i]) * r.transposed();
+    }
+    [[nodiscard]] vec3<angular_momentum_type>
+    angular_momentum(id_type i) const noexcept {
+        return inertia_tensor(i) * angular_velocity_[i];
+    }
+    [[nodiscard]] body_state state(id_type i) const noexcept {
+        return state_[i];
+    }
+
+    // Bodies integrated by the next step, and the islands and contacts the
+    // last step solved.
+    [[nodiscard]] std::size_t awake_count() const noexcept {
+        return awake_.size();
+    }
+    [[nodiscard]] std::size_t island_count() const noexcept {
+        return islands_.size();
+    }
+    [[nodiscard]] std::size_t contact_count() const noexcept {
+        return contacts_.size();
+    }
+
+    // ========== Stepping ==========
+    void step(time<T> dt) {
+        const T h = dt.base_value();
+        assert(h > T(0));
+        if (!grid_) {
+            grid_.emplace(length_type(max_radius_ > T(0) ? 2 * max_radius_
+                                                         : T(1)));
+            grid_->assign(position_, config_.threads);
+        }
+        find_contacts();
+        integrate_velocities(h);
+        build_islands();
+        solve_islands(h);
+        integrate_positions(h);
+        update_sleep(h);
+    }
+
+    // ========== Diagnostics ==========
+    // Translational plus rotational kinetic energy.
+    [[nodiscard]] energy<T> kinetic_energy() const {
+        T total = 0;
+        for (std::size_t i = 0; i < size(); ++i) {
+            if (state_[i] == body_state::fixed) {
+                continue;
+            }
+            const v3 v = load(velocity_, i);
+            // body-frame angular velocity against the principal moments
+            const v3 w =
+                mul_transposed(rotation(i), load(angular_velocity_, i));
+            const v3 inertia = load(inertia_, i);
+            total += mass_[i].base_value() * glm::dot(v, v) +
+                     glm::dot(w * inertia, w);
+        }
+        return energy<T>(T(0.5) * total);
+    }
+
+  private:
+    // ========== State access ==========
+    template <typename Q>
+    [[nodiscard]] static v3 load(const vec3_array<Q> &a,
+                                 std::size_t i) noexcept {
+        return v3(a.component(0).base_data()[i], a.component(1).base_data()[i],
+                  a.component(2).base_data()[i]);
+    }
+    template <typename Q>
+    static void store(vec3_array<Q> &a, std::size_t i, const v3 &v) noexcept {
+        for (glm::length_t c = 0; c < 3; ++c) {
+            a.component(c).base_data()[i] = v[c];
+        }
+    }
+
+    [[nodiscard]] static v3 mul(const m3 &m, const v3 &v) noexcept {
+        return v3(m[0] * v[0] + m[1] * v[1] + m[2] * v[2],
+                  m[3] * v[0] + m[4] * v[1] + m[5] * v[2],
+                  m[6] * v[0] + m[7] * v[1] + m[8] * v[2]);
+    }
+    [[nodiscard]] static v3 mul_transposed(const m3 &m, const v3 &v) noexcept {
+        return v3(m[0] * v[0] + m[3] * v[1] + m[6] * v[2],
+                  m[1] * v[0] + m[4] * v[1] + m[7] * v[2],
+                  m[2] * v[0] + m[5] * v[1] + m[8] * v[2]);
+    }
+
+    // Body-to-world rotation matrix of body i's orientation.
+    [[nodiscard]] m3 rotation(std::size_t i) const noexcept {
+        const T w = orientation_[0][i], x = orientation_[1][i],
+                y = orientation_[2][i], z = orientation_[3][i];
+        return {T(1) - 2 * (y * y + z * z), 2 * (x * y - w * z),
+                2 * (x * z + w * y),        2 * (x * y + w * z),
+                T(1) - 2 * (x * x + z * z), 2 * (y * z - w * x),
+                2 * (x * z - w * y),        2 * (y * z + w * x),
+                T(1) - 2 * (x * x + y * y)};
+    }
+
+    [[nodiscard]] std::size_t
+    threads_for(std::size_t n, std::size_t min_per_thread) const noexcept {
+        const std::size_t threads = config_.threads == 0
+                                        ? default_thread_count()
+                                        : config_.threads;
+        return std::max<std::size_t>(1,
+                                     std::min(threads, n / min_per_thread));
+    }
+
+    // Runs f(chunk, begin, end) over [0, n) in `chunks` contiguous chunks
+    // whose results the caller merges in chunk order, so the outcome does
+    // not depend on the thread count.
+    template <typename F>
+    static void for_chunks(std::size_t n, std::size_t chunks, F &&f) {
+        parallel_for(
+            chunks,
+            [&](std::size_t first, std::size_t last) {
+                for (std::size_t ch = first; ch < last; ++ch) {
+                    f(ch, n * ch / chunks, n * (ch + 1) / chunks);
+                }
+            },
+            chunks);
+    }
+
+    // ========== Sleeping ==========
+    // Wakes every body of sleeping island g, appending them to `woken`.
+    void wake_group(std::uint32_t g, std::vector<id_type> *woken) {
+        for (const id_type id : groups_[g]) {
+            state_[id] = body_state::awake;
+            rest_time_[id] = T(0);
+            sleep_group_[id] = none;
+            awake_.push_back(id);
+            if (woken) {
+                woken->push_back(id);
+            }
+        }
+        groups_[g].clear();
+        free_groups_.push_back(g);
+    }
+
+    void update_sleep(T h) {
+        if (!config_.allow_sleep) {
+            return;
+        }
+        const T v2 = config_.sleep_speed.base_value() *
+                     config_.sleep_speed.base_value();
+        const T w2 = config_.sleep_angular_speed.base_value() *
+                     config_.sleep_angular_speed.base_value();
+        for (const id_type id : awake_) {
+            const v3 v = load(velocity_, id), w = load(angular_velocity_, id);
+            rest_time_[id] = glm::dot(v, v) <= v2 && glm::dot(w, w) <= w2
+                                 ? rest_time_[id] + h
+                                 : T(0);
+        }
+
+        bool any = false;
+        for (const island &is : islands_) {
+            bool rested = true;
+            for (std::uint32_t k = is.body_begin; k < is.body_end && rested;
+                 ++k) {
+                rested = rest_time_[island_bodies_[k]] >=
+                         config_.sleep_time.base_value();
+            }
+            if (!rested) {
+                continue;
+            }
+            std::uint32_t g;
+            if (!free_groups_.empty()) {
+                g = free_groups_.back();
+                free_groups_.pop_back();
+            } else {
+                g = static_cast<std::uint32_t>(groups_.size());
+                groups_.emplace_back();
+            }
+            for (std::uint32_t k = is.body_begin; k < is.body_end; ++k) {
+                const id_type id = island_bodies_[k];
+                state_[id] = body_state::sleeping;
+                sleep_group_[id] = g;
+                store(velocity_, id, v3(T(0)));
+                store(angular_velocity_, id, v3(T(0)));
+                groups_[g].push_back(id);
+            }
+            any = true;
+        }
+        if (any) {
+            std::erase_if(awake_, [this](id_type id) {
+                return state_[id] != body_state::awake;
+            });
+        }
+    }
+
+    // ========== Contacts ==========
+    // Contacts of every awake body. Bodies querying in the same round
+    // record a pair from the lower id; sleeping bodies they touch wake with
+    // their islands and query in the next round, skipping the bodies that
+    // already did.
+    void find_contacts() {
+        contacts_.clear();
+        const std::uint64_t first_round = round_ + 1;
+        std::vector<id_type> frontier = awake_;
+        while (!frontier.empty()) {
+            const std::uint64_t round = ++round_;
+            for (const id_type id : frontier) {
+                stamp_[id] = round;
+            }
+            const std::size_t n = frontier.size();
+            const std::size_t chunks = threads_for(n, 256);
+            std::vector<std::vector<contact>> found(chunks);
+            std::vector<std::vector<id_type>> touched(chunks);
+            for_chunks(n, chunks, [&](std::size_t ch, std::size_t begin,
+                                      std::size_t end) {
+                for (std::size_t k = begin; k < end; ++k) {
+                    collide(frontier[k], round, first_round, found[ch],
+                            touched[ch]);
+                }
+            });
+
+            frontier.clear();
+            for (std::size_t ch = 0; ch < chunks; ++ch) {
+                contacts_.insert(contacts_.end(), found[ch].begin(),
+                                 found[ch].end());
+                for (const id_type id : touched[ch]) {
+                    if (state_[id] == body_state::sleeping) {
+                        wake_group(sleep_group_[id], &frontier);
+                    }
+                }
+            }
+        }
+    }
+
+    void collide(id_type i, std::uint64_t round, std::uint64_t first_round,
+                 std::vector<contact> &out,
+                 std::vector<id_type> &touched) const {
+        const v3 xi = load(position_, i);
+        const T ri = radius_[i].base_value();
+        grid_->query(position_[i], length_type(ri + max_radius_),
+                     [&](id_type j) {
+                         if (j == i || (stamp_[j] == round && j < i) ||
+                             (stamp_[j] >= first_round && stamp_[j] < round)) {
+                             return;
+                         }
+                         const v3 d = xi - load(position_, j);
+                         const T rj = radius_[j].base_value();
+                         const T reach = ri + rj;
+                         const T dist2 = glm::dot(d, d);
+                         if (dist2 >= reach * reach) {
+                             return;
+                         }
+                         const T dist = std::sqrt(dist2);
+                         const v3 n = dist > T(0) ? d / dist
+                                                  : v3(T(0), T(0), T(1));
+                         // halfway between the two surfaces
+                         const v3 p = (xi - n * ri + load(position_, j) +
+                                       n * rj) *
+                                      T(0.5);
+                         out.push_back(make_contact(i, j, n, p - xi,
+                                                    p - load(position_, j),
+                                                    reach - dist));
+                         if (state_[j] == body_state::sleeping) {
+                             touched.push_back(j);
+                         }
+                     });
+        if (config_.floor) {
+            const T depth = config_.floor->base_value() - (xi.z - ri);
+            if (depth > T(0)) {
+                const v3 n(T(0), T(0), T(1));
+                out.push_back(
+                    make_contact(i, none, n, -n * ri, v3(T(0)), depth));
+            }
+        }
+    }
+
+    [[nodiscard]] static contact make_contact(id_type a, id_type b,
+                                              const v3 &n, const v3 &ra,
+                                              const v3 &rb, T depth) noexcept {
+        contact c{};
+        c.a = a;
+        c.b = b;
+        c.normal = n;
+        c.ra = ra;
+        c.rb = rb;
+        c.depth = depth;
+        return c;
+    }
+
+    // ========== Integration ==========
+    void integrate_velocities(T h) {
+        const v3 g(config_.gravity.x().base_value(),
+                   config_.gravity.y().base_value(),
+                   config_.gravity.z().base_value());
+        parallel_for(
+            awake_.size(),
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = begin; k < end; ++k) {
+                    const id_type id = awake_[k];
+                    const m3 r = rotation(id);
+                    // I_world^-1 = R diag(1 / I) R^T
+                    const v3 inv = inv_inertia_[id];
+                    m3 &iw = inv_inertia_world_[id];
+                    for (int row = 0; row < 3; ++row) {
+                        for (int col = 0; col < 3; ++col) {
+                            T s = 0;
+                            for (int c = 0; c < 3; ++c) {
+                                s += r[3 * row + c] * inv[c] * r[3 * col + c];
+                            }
+                            iw[3 * row + col] = s;
+                        }
+                    }
+
+                    const v3 f = load(force_, id);
+                    store(velocity_, id,
+                          load(velocity_, id) + (g + f * inv_mass_[id]) * h);
+
+                    // dw/dt = I^-1 (tau - w x I w)
+                    const v3 w = load(angular_velocity_, id);
+                    const v3 iw_w =
+                        mul(r, mul_transposed(r, w) * load(inertia_, id));
+                    const v3 tau = load(torque_, id) - glm::cross(w, iw_w);
+                    store(angular_velocity_, id, w + mul(iw, tau) * h);
+
+                    store(force_, id, v3(T(0)));
+                    store(torque_, id, v3(T(0)));
+                }
+            },
+            threads_for(awake_.size(), 256));
+    }
+
+    void integrate_positions(T h) {
+        parallel_for(
+            awake_.size(),
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = begin; k < end; ++k) {
+                    const id_type id = awake_[k];
+                    store(position_, id,
+                          load(position_, id) + load(velocity_, id) * h);
+                    // q += h/2 (0, w) q, renormalized
+                    const v3 w = load(angular_velocity_, id) * (T(0.5) * h);
+                    const T qw = orientation_[0][id], qx = orientation_[1][id],
+                            qy = orientation_[2][id], qz = orientation_[3][id];
+                    const std::array<T, 4> q = {
+                        qw - w.x * qx - w.y * qy - w.z * qz,
+                        qx + w.x * qw + w.y * qz - w.z * qy,
+                        qy + w.y * qw + w.z * qx - w.x * qz,
+                        qz + w.z * qw + w.x * qy - w.y * qx};
+                    const T inv_norm =
+                        T(1) / std::sqrt(q[0] * q[0] + q[1] * q[1] +
+                                         q[2] * q[2] + q[3] * q[3]);
+                    for (std::size_t c = 0; c < 4; ++c) {
+                        orientation_[c][id] = q[c] * inv_norm;
+                    }
+                }
+            },
+            threads_for(awake_.size(), 256));
+        for (const id_type id : awake_) {
+            grid_->update(id, position_[id]);
+        }
+    }
+
+    // ========== Islands ==========
+    // Union-find over the awake bodies joined by body-body contacts; static
+    // bodies and the floor do not link islands. Bodies and contacts are then
+    // grouped per island.
+    void build_islands() {
+        const std::size_t n = awake_.size();
+        for (std::size_t k = 0; k < n; ++k) {
+            slot_[awake_[k]] = static_cast<std::uint32_t>(k);
+        }
+        std::vector<std::uint32_t> parent(n);
+        std::iota(parent.begin(), parent.end(), std::uint32_t{0});
+        const auto find = [&](std::uint32_t s) {
+            while (parent[s] != s) {
+                parent[s] = parent[parent[s]];
+                s = parent[s];
+            }
+            return s;
+        };
+        for (const contact &c : contacts_) {
+            if (c.b != none && state_[c.b] == body_state::awake) {
+                const std::uint32_t x = find(slot_[c.a]), y = find(slot_[c.b]);
+                if (x != y) {
+                    parent[std::max(x, y)] = std::min(x, y);
+                }
+            }
+        }
+
+        // island index per slot, numbered in order of first appearance
+        std::vector<std::uint32_t> island_of(n);
+        std::vector<std::uint32_t> index(n, none);
+        std::uint32_t count = 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::uint32_t root = find(static_cast<std::uint32_t>(k));
+            if (index[root] == none) {
+                index[root] = count++;
+            }
+            island_of[k] = index[root];
+        }
+
+        islands_.assign(count, {});
+        for (std::size_t k = 0; k < n; ++k) {
+            ++islands_[island_of[k]].body_end;
+        }
+        for (const contact &c : contacts_) {
+            ++islands_[island_of[slot_[c.a]]].contact_end;
+        }
+        std::uint32_t bodies = 0, contacts = 0;
+        for (island &is : islands_) {
+            is.body_begin = bodies;
+            bodies += is.body_end;
+            is.body_end = is.body_begin;
+            is.contact_begin = contacts;
+            contacts += is.contact_end;
+            is.contact_end = is.contact_begin;
+        }
+        island_bodies_.resize(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            island_bodies_[islands_[island_of[k]].body_end++] = awake_[k];
+        }
+        std::vector<contact> grouped(contacts_.size());
+        for (const contact &c : contacts_) {
+            grouped[islands_[island_of[slot_[c.a]]].contact_end++] = c;
+        }
+        contacts_ = std::move(grouped);
+    }
+
+    // ========== Contact solver ==========
+    void solve_islands(T h) {
+        parallel_for(
+            islands_.size(),
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = begin; k < end; ++k) {
+                    const island &is = islands_[k];
+                    for (std::uint32_t c = is.contact_begin;
+                         c < is.contact_end; ++c) {
+                        prepare(contacts_[c], h);
+                    }
+                    for (int it = 0; it < config_.iterations; ++it) {
+                        for (std::uint32_t c = is.contact_begin;
+                             c < is.contact_end; ++c) {
+                            relax(contacts_[c]);
+                        }
+                    }
+                }
+            },
+            threads_for(islands_.size(), 16));
+    }
+
+    [[nodiscard]] bool moves(id_type b) const noexcept {
+        return b != none && state_[b] == body_state::awake;
+    }
+
+    // Effective mass along direction d at the contact.
+    [[nodiscard]] T effective_mass(const contact &c, const v3 &d) const {
+        T k = inv_mass_[c.a] +
+              glm::dot(d, glm::cross(mul(inv_inertia_world_[c.a],
+                                         glm::cross(c.ra, d)),
+                                     c.ra));
+        if (moves(c.b)) {
+            k += inv_mass_[c.b] +
+                 glm::dot(d, glm::cross(mul(inv_inertia_world_[c.b],
+                                            glm::cross(c.rb, d)),
+                                        c.rb));
+        }
+        return k > T(0) ? T(1) / k : T(0);
+    }
+
+    [[nodiscard]] v3 relative_velocity(const contact &c) const {
+        v3 v = load(velocity_, c.a) +
+               glm::cross(load(angular_velocity_, c.a), c.ra);
+        if (moves(c.b)) {
+            v -= load(velocity_, c.b) +
+                 glm::cross(load(angular_velocity_, c.b), c.rb);
+        }
+        return v;
+    }
+
+    void apply_impulse(const contact &c, const v3 &p) {
+        store(velocity_, c.a, load(velocity_, c.a) + p * inv_mass_[c.a]);
+        store(angular_velocity_, c.a,
+              load(angular_velocity_, c.a) +
+                  mul(inv_inertia_world_[c.a], glm::cross(c.ra, p)));
+        if (moves(c.b)) {
+            store(velocity_, c.b, load(velocity_, c.b) - p * inv_mass_[c.b]);
+            store(angular_velocity_, c.b,
+                  load(angular_velocity_, c.b) -
+                      mul(inv_inertia_world_[c.b], glm::cross(c.rb, p)));
+        }
+    }
+
+    void prepare(contact &c, T h) const {
+        const v3 &n = c.normal;
+        // any unit vector orthogonal to n, then the third axis
+        const v3 seed = std::abs(n.x) < T(0.57) ? v3(T(1), T(0), T(0))
+                                                : v3(T(0), T(1), T(0));
+        c.t1 = glm::normalize(glm::cross(n, seed));
+        c.t2 = glm::cross(n, c.t1);
+        c.mass_n = effective_mass(c, n);
+        c.mass_t1 = effective_mass(c, c.t1);
+        c.mass_t2 = effective_mass(c, c.t2);
+
+        // bounce back from approaching speeds, push out of deep overlaps
+        const T vn = glm::dot(relative_velocity(c), n);
+        const T bounce = vn < -config_.bounce_speed.base_value()
+                             ? -config_.restitution * vn
+                             : T(0);
+        const T push = config_.baumgarte / h *
+                       std::max(c.depth - config_.slop.base_value(), T(0));
+        c.target = std::max(bounce, push);
+        c.jn = c.jt1 = c.jt2 = T(0);
+    }
+
+    // One sequential-impulse update of contact c: the accumulated normal
+    // impulse stays non-negative and the friction impulses inside the
+    // Coulomb cone.
+    void relax(contact &c) {
+        const T vn = glm::dot(relative_velocity(c), c.normal);
+        const T jn = std::max(c.jn + c.mass_n * (c.target - vn), T(0));
+        apply_impulse(c, c.normal * (jn - c.jn));
+        c.jn = jn;
+
+        const T limit = config_.friction * c.jn;
+        const v3 v = relative_velocity(c);
+        const T jt1 = std::clamp(c.jt1 - c.mass_t1 * glm::dot(v, c.t1),
+                                 -limit, limit);
+        const T jt2 = std::clamp(c.jt2 - c.mass_t2 * glm::dot(v, c.t2),
+                                 -limit, limit);
+        apply_impulse(c, c.t1 * (jt1 - c.jt1) + c.t2 * (jt2 - c.jt2));
+        c.jt1 = jt1;
+        c.jt2 = jt2;
+    }
+};
+
+} // namespace physi
@@ -0,0 +1,311 @@
+#pragma once
+
+#include "vec.hpp"
+
+#include <glm/mat2x2.hpp>
+#include <glm/mat2x3.hpp>
+#include <glm/mat2x4.hpp>
+#include <glm/mat3x2.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat3x4.hpp>
+#include <glm/mat4x2.hpp>
+#include <glm/mat4x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/matrix.hpp>
+#include <initializer_list>
+#include <type_traits>
+
+// R x C matrices of one quantity over glm::mat, the matrix counterpart of
+// vec:
+//
+//   mat3<double> r = quat<double>::angle_axis(0.5, {0, 0, 1}).to_matrix();
+//   vec3<length_d> p = r * offset;                 // rotations keep units
+//   mat3<moment_of_inertia_d> I = mat3<moment_of_inertia_d>::diagonal(d);
+//   vec3<angular_momentum_d> L = I * omega;        // products multiply
+//
+// A plain arithmetic Quantity stands for a dimensionless matrix (rotations,
+// scales) and converts to and from raw glm. Elements are addressed
+// (row, column) and the initializer list is read row by row, as matrices are
+// written on paper; storage stays glm's column-major layout.
+
+namespace physi {
+
+namespace detail {
+
+// Q * Q * ... (N factors), the quantity of an N x N determinant.
+template <typename Q, glm::length_t N> struct power {
+    using type = product_t<typename power<Q, N - 1>::type, Q>;
+};
+
+template <typename Q> struct power<Q, 1> {
+    using type = Q;
+};
+
+template <typename Q>
+[[nodiscard]] constexpr scalar_type_t<Q> raw_value(const Q &q) noexcept {
+    if constexpr (std::is_arithmetic_v<Q>) {
+        return q;
+    } else {
+        return q.base_value();
+    }
+}
+
+} // namespace detail
+
+template <typename Quantity, glm::length_t R, glm::length_t C> struct mat {
+    using value_type = scalar_type_t<Quantity>;
+    using base_type = glm::mat<C, R, value_type>;
+    // A column (R entries) or row (C entries): vec of Quantity, or a raw glm
+    // vector when dimensionless.
+    template <glm::length_t N>
+    using vector_type = std::conditional_t<std::is_arithmetic_v<Quantity>,
+                                           glm::vec<N, value_type>,
+                                           vec<Quantity, N>>;
+
+    base_type data;
+
+    template <typename Q, glm::length_t R2, glm::length_t C2>
+    friend struct mat;
+    template <typename T> friend struct quat;
+
+  private:
+    explicit constexpr mat(const base_type &m) noexcept
+        requires(!std::is_arithmetic_v<Quantity>)
+        : data(m) {}
+
+    template <glm::length_t N>
+    [[nodiscard]] static constexpr glm::vec<N, value_type>
+    raw_vector(const vector_type<N> &v) noexcept {
+        if constexpr (std::is_arithmetic_v<Quantity>) {
+            return v;
+        } else {
+            return v.data;
+        }
+    }
+
+    template <glm::length_t N>
+    [[nodiscard]] static constexpr vector_type<N>
+    wrap_vector(const glm::vec<N, value_type> &v) noexcept {
+        if constexpr (std::is_arithmetic_v<Quantity>) {
+            return v;
+        } else {
+            return vec<Quantity, N>{v};
+        }
+    }
+
+  public:
+    // Default constructor (zero matrix)
+    constexpr mat() noexcept : data(value_type(0)) {}
+
+    // Dimensionless matrices wrap raw glm ones
+    explicit constexpr mat(const base_type &m) noexcept
+        requires std::is_arithmetic_v<Quantity>
+        : data(m) {}
+
+    // Construct from elements in row-major order
+    constexpr mat(std::initializer_list<Quantity> list) noexcept
+        : data(value_type(0)) {
+        auto it = list.begin();
+        for (glm::length_t r = 0; r < R; ++r) {
+            for (glm::length_t c = 0; c < C && it != list.end(); ++c, ++it) {
+                data[c][r] = detail::raw_value(*it);
+            }
+        }
+    }
+
+    constexpr mat(const mat &) noexcept = default;
+    constexpr mat &operator=(const mat &) noexcept = default;
+
+    // ========== Factories (square) ==========
+    [[nodiscard]] static constexpr mat identity() noexcept
+        requires(std::is_arithmetic_v<Quantity> && R == C)
+    {
+        return mat{base_type(value_type(1))};
+    }
+
+    [[nodiscard]] static constexpr mat diagonal(Quantity d) noexcept
+        requires(R == C)
+    {
+        return mat{base_type(detail::raw_value(d))};
+    }
+
+    // e.g. a principal inertia tensor from its three moments
+    [[nodiscard]] static constexpr mat
+    diagonal(const vector_type<R> &d) noexcept
+        requires(R == C)
+    {
+        const glm::vec<R, value_type> raw = raw_vector<R>(d);
+        base_type m(value_type(0));
+        for (glm::length_t i = 0; i < R; ++i) {
+            m[i][i] = raw[i];
+        }
+        return mat{m};
+    }
+
+    // ========== Element access ==========
+    [[nodiscard]] constexpr Quantity
+    operator()(glm::length_t r, glm::length_t c) const noexcept {
+        return Quantity(data[c][r]);
+    }
+
+    constexpr void set(glm::length_t r, glm::length_t c, Quantity q) noexcept {
+        data[c][r] = detail::raw_value(q);
+    }
+
+    [[nodiscard]] constexpr vector_type<R>
+    column(glm::length_t c) const noexcept {
+        return wrap_vector<R>(data[c]);
+    }
+
+    [[nodiscard]] constexpr vector_type<C> row(glm::length_t r) const noexcept {
+        glm::vec<C, value_type> out;
+        for (glm::length_t c = 0; c < C; ++c) {
+            out[c] = data[c][r];
+        }
+        return wrap_vector<C>(out);
+    }
+
+    // ========== Matrix + Matrix (same quantity) ==========
+    [[nodiscard]] constexpr mat operator+(const mat &other) const noexcept {
+        return mat{data + other.data};
+    }
+
+    [[nodiscard]] constexpr mat operator-(const mat &other) const noexcept {
+        return mat{data - other.data};
+    }
+
+    constexpr mat &operator+=(const mat &other) noexcept {
+        data = data + other.data;
+        return *this;
+    }
+
+    constexpr mat &operator-=(const mat &other) noexcept {
+        data = data - other.data;
+        return *this;
+    }
+
+    [[nodiscard]] constexpr mat operator-() const noexcept {
+        return mat{-data};
+    }
+
+    // ========== Matrix * Scalar (dimensionless) ==========
+    [[nodiscard]] constexpr mat operator*(value_type scalar) const noexcept {
+        return mat{data * scalar};
+    }
+
+    [[nodiscard]] constexpr mat operator/(value_type scalar) const noexcept {
+        return mat{data / scalar};
+    }
+
+    [[nodiscard]] friend constexpr mat operator*(value_type scalar,
+                                                 const mat &m) noexcept {
+        return mat{scalar * m.data};
+    }
+
+    // ========== Matrix * Quantity (dimensional) ==========
+    template <typename Q2>
+        requires(is_quantity_v<Q2> &&
+                 std::is_same_v<scalar_type_t<Q2>, value_type>)
+    [[nodiscard]] constexpr auto operator*(Q2 scalar) const noexcept {
+        using Result = product_t<Quantity, Q2>;
+        return mat<Result, R, C>{data * scalar.base_value()};
+    }
+
+    template <typename Q2>
+        requires(is_quantity_v<Q2> &&
+                 std::is_same_v<scalar_type_t<Q2>, value_type>)
+    [[nodiscard]] friend constexpr auto operator*(Q2 scalar,
+                                                  const mat &m) noexcept {
+        return m * scalar;
+    }
+
+    // ========== Matrix * Matrix ==========
+    template <typename Q2, glm::length_t K>
+    [[nodiscard]] constexpr auto
+    operator*(const mat<Q2, C, K> &other) const noexcept {
+        using Result = product_t<Quantity, Q2>;
+        return mat<Result, R, K>{data * other.data};
+    }
+
+    constexpr mat &operator*=(const mat &other) noexcept
+        requires(std::is_arithmetic_v<Quantity> && R == C)
+    {
+        data = data * other.data;
+        return *this;
+    }
+
+    // ========== Matrix * Vector ==========
+    // Dimensionless results come back as raw glm vectors, as vec::operator/
+    // does.
+    template <typename Q2>
+    [[nodiscard]] constexpr auto operator*(const vec<Q2, C> &v) const noexcept {
+        using Result = product_t<Quantity, Q2>;
+        if constexpr (std::is_arithmetic_v<Result>) {
+            return data * v.data;
+        } else {
+            return vec<Result, R>{data * v.data};
+        }
+    }
+
+    // Unitless vectors (directions) take the matrix quantity.
+    [[nodiscard]] constexpr vector_type<R>
+    operator*(const glm::vec<C, value_type> &v) const noexcept {
+        return wrap_vector<R>(data * v);
+    }
+
+    // ========== Transpose, determinant, inverse ==========
+    [[nodiscard]] constexpr mat<Quantity, C, R> transposed() const noexcept {
+        return mat<Quantity, C, R>{glm::transpose(data)};
+    }
+
+    [[nodiscard]] constexpr auto determinant() const noexcept
+        requires(R == C)
+    {
+        using Result = typename detail::power<Quantity, R>::type;
+        return Result(glm::determinant(data));
+    }
+
+    // The inverse carries the reciprocal quantity (an inverse inertia tensor
+    // maps angular momentum back to angular velocity). Singular matrices give
+    // non-finite entries.
+    [[nodiscard]] constexpr auto inverse() const noexcept
+        requires(R == C)
+    {
+        using Result = quotient_t<value_type, Quantity>;
+        return mat<Result, R, C>{glm::inverse(data)};
+    }
+
+    // ========== Comparison operators ==========
+    [[nodiscard]] constexpr bool operator==(const mat &other) const noexcept {
+        return data == other.data;
+    }
+
+    [[nodiscard]] constexpr bool operator!=(const mat &other) const noexcept {
+        return data != other.data;
+    }
+
+    // ========== Raw data access ==========
+    [[nodiscard]] constexpr base_type base_value() const noexcept {
+        return data;
+    }
+    [[nodiscard]] constexpr value_type *data_ptr() noexcept {
+        return &data[0][0];
+    }
+    [[nodiscard]] constexpr const value_type *data_ptr() const noexcept {
+        return &data[0][0];
+    }
+};
+
+template <typename Q, glm::length_t R, glm::length_t C>
+struct is_mat<mat<Q, R, C>> : std::true_type {};
+
+static_assert(sizeof(mat<length_d, 3, 3>) == sizeof(glm::mat<3, 3, double>),
+              "mat must have identical memory layout to glm::mat");
+static_assert(sizeof(mat<float, 4, 4>) == sizeof(glm::mat<4, 4, float>),
+              "mat must have identical memory layout to glm::mat");
+
+template <typename Quantity> using mat2 = mat<Quantity, 2, 2>;
+template <typename Quantity> using mat3 = mat<Quantity, 3, 3>;
+template <typename Quantity> using mat4 = mat<Quantity, 4, 4>;
+
+} // namespace physi
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "mat.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+#include <type_traits>
+
+// Rotation quaternion over glm::qua. Rotations are dimensionless, so a
+// rotated vector keeps its quantity:
+//
+//   quat<double> q = quat<double>::angle_axis(std::numbers::pi / 2, {0, 0, 1});
+//   vec3<length_d> p = q * vec3<length_d>{1_m, 0_m, 0_m};    // (0, 1, 0) m
+//   vec3<angular_velocity_d> w = q.conjugate() * omega_world; // to body frame
+//
+// Components are ordered (w, x, y, z) with w the scalar part. Composition
+// reads right to left: (a * b) * v rotates by b first.
+
+namespace physi {
+
+template <typename T = double> struct quat {
+    static_assert(std::is_floating_point_v<T>,
+                  "quat needs a floating-point scalar");
+
+    using value_type = T;
+    using base_type = glm::qua<T>;
+
+    base_type data;
+
+    // Identity rotation
+    constexpr quat() noexcept : data(T(1), T(0), T(0), T(0)) {}
+
+    // Construct from (w, x, y, z); not normalized
+    constexpr quat(T w, T x, T y, T z) noexcept : data(w, x, y, z) {}
+
+    explicit constexpr quat(const base_type &q) noexcept : data(q) {}
+
+    // ========== Factories ==========
+    // Rotation by `radians` about `axis` (normalized here; must be non-zero)
+    [[nodiscard]] static quat angle_axis(T radians,
+                                         const glm::vec<3, T> &axis) noexcept {
+        return quat{glm::angleAxis(radians, glm::normalize(axis))};
+    }
+
+    // From a rotation matrix (orthonormal, determinant 1)
+    [[nodiscard]] static quat from_matrix(const mat<T, 3, 3> &m) noexcept {
+        return quat{glm::quat_cast(m.data)};
+    }
+
+    // ========== Composition ==========
+    [[nodiscard]] constexpr quat operator*(const quat &other) const noexcept {
+        return quat{data * other.data};
+    }
+
+    constexpr quat &operator*=(const quat &other) noexcept {
+        data = data * other.data;
+        return *this;
+    }
+
+    // ========== Rotation of vectors ==========
+    template <typename Q>
+        requires std::is_same_v<typename Q::value_type, T>
+    [[nodiscard]] constexpr vec<Q, 3>
+    operator*(const vec<Q, 3> &v) const noexcept {
+        return vec<Q, 3>{data * v.data};
+    }
+
+    [[nodiscard]] constexpr glm::vec<3, T>
+    operator*(const glm::vec<3, T> &v) const noexcept {
+        return data * v;
+    }
+
+    // ========== Inverse and normalization ==========
+    // The inverse rotation of a unit quaternion
+    [[nodiscard]] constexpr quat conjugate() const noexcept {
+        return quat{glm::conjugate(data)};
+    }
+
+    [[nodiscard]] constexpr quat inverse() const noexcept {
+        return quat{glm::inverse(data)};
+    }
+
+    [[nodiscard]] constexpr quat normalized() const noexcept {
+        return quat{glm::normalize(data)};
+    }
+
+    [[nodiscard]] constexpr T norm() const noexcept {
+        return glm::length(data);
+    }
+
+    // ========== Angle and axis ==========
+    // Rotation angle in radians, in [0, 2 pi]
+    [[nodiscard]] constexpr T angle() const noexcept {
+        return glm::angle(data);
+    }
+
+    [[nodiscard]] constexpr glm::vec<3, T> axis() const noexcept {
+        return glm::axis(data);
+    }
+
+    // ========== Conversion ==========
+    [[nodiscard]] constexpr mat<T, 3, 3> to_matrix() const noexcept {
+        return mat<T, 3, 3>{glm::mat3_cast(data)};
+    }
+
+    // Spherical interpolation along the shorter arc, t in [0, 1]
+    [[nodiscard]] friend quat slerp(const quat &a, const quat &b,
+                                    T t) noexcept {
+        return quat{glm::slerp(a.data, b.data, t)};
+    }
+
+    // ========== Comparison operators ==========
+    [[nodiscard]] constexpr bool operator==(const quat &other) const noexcept {
+        return data == other.data;
+    }
+
+    [[nodiscard]] constexpr bool operator!=(const quat &other) const noexcept {
+        return data != other.data;
+    }
+
+    // ========== Component access ==========
+    [[nodiscard]] constexpr T w() const noexcept { return data.w; }
+    [[nodiscard]] constexpr T x() const noexcept { return data.x; }
+    [[nodiscard]] constexpr T y() const noexcept { return data.y; }
+    [[nodiscard]] constexpr T z() const noexcept { return data.z; }
+
+    [[nodiscard]] constexpr base_type base_value() const noexcept {
+        return data;
+    }
+};
+
+template <typename T> struct is_quat<quat<T>> : std::true_type {};
+
+} // namespace physi
@@ -1,10 +1,28 @@
 #pragma once
 
-#include <glm/glm.hpp>
+#include "../quantities/length.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <initializer_list>
+#include <type_traits>
 
 namespace physi {
 
 template <typename T> struct is_vec : std::false_type {};
+template <typename T> struct is_mat : std::false_type {};
+template <typename T> struct is_quat : std::false_type {};
+
+template <typename Quantity, glm::length_t R, glm::length_t C> struct mat;
+template <typename T> struct quat;
+
+// Operands of the vec * quantity overloads: anything but the geometric types,
+// which bring their own products.
+template <typename T>
+concept vec_scalar_operand =
+    !is_vec<T>::value && !is_mat<T>::value && !is_quat<T>::value;
 
 template <typename Quantity, glm::length_t N> struct vec {
     glm::vec<N, typename Quantity::value_type> data;
@@ -12,6 +30,8 @@ template <typename Quantity, glm::length_t N> struct vec {
     using value_type = typename Quantity::value_type;
 
     template <typename Q, glm::length_t M> friend struct vec;
+    template <typename Q, glm::length_t R, glm::length_t C> friend struct mat;
+    template <typename T> friend struct quat;
 
     // ---------------------------------------------------------------------------------------------
 
@@ -48,6 +68,16 @@ template <typename Quantity, glm::length_t N> struct vec {
     explicit constexpr vec(Quantity scalar) noexcept
         : data(scalar.base_value()) {}
 
+    // Explicit conversion from a vector of another quantity of the same
+    // dimension and scalar, e.g. vec3<torque_d>(r.cross(f)) from the energy
+    // vector the cross product yields
+    template <typename Q2>
+        requires(!std::is_same_v<Q2, Quantity> &&
+                 std::is_same_v<typename Q2::value_type, value_type> &&
+                 std::is_constructible_v<Quantity, Q2>)
+    explicit constexpr vec(const vec<Q2, N> &other) noexcept
+        : data(other.data) {}
+
     constexpr vec(const vec &) noexcept = default;
     constexpr vec &operator=(const vec &) noexcept = default;
 
@@ -104,14 +134,14 @@ template <typename Quantity, glm::length_t N> struct vec {
 
     // ========== Vector * Quantity (dimensional) ==========
     template <typename Q2>
-        requires(!is_vec<Q2>::value) // Exclude other vec types
+        requires vec_scalar_operand<Q2>
     [[nodiscard]] constexpr auto operator*(Q2 scalar) const noexcept {
         using Result = decltype(Quantity() * Q2());
         return vec<Result, N>{data * scalar.base_value()};
     }
 
     template <typename Q2>
-        requires(!is_vec<Q2>::value) // Exclude other vec types
+        requires vec_scalar_operand<Q2>
     [[nodiscard]] constexpr auto operator/(Q2 scalar) const noexcept {
         using Result = decltype(Quantity() / Q2());
         return vec<Result, N>{data / scalar.base_value()};
@@ -119,7 +149,7 @@ template <typename Quantity, glm::length_t N> struct vec {
 
     // Friend for quantity * vector (commutative)
     template <typename Q2>
-        requires(!is_vec<Q2>::value) // Exclude other vec types
+        requires vec_scalar_operand<Q2>
     [[nodiscard]] friend constexpr auto operator*(Q2 scalar,
                                                   const vec &v) noexcept {
         using Result = decltype(Q2() * Quantity());
@@ -241,4 +271,16 @@ template <typename Quantity> using vec2 = vec<Quantity, 2>;
 template <typename Quantity> using vec3 = vec<Quantity, 3>;
 template <typename Quantity> using vec4 = vec<Quantity, 4>;
 
+// Component-wise precision_cast, e.g. vec3<length_f> from vec3<length_d>
+template <typename To, typename Q, glm::length_t N>
+    requires is_quantity_scalar_v<To>
+[[nodiscard]] constexpr vec<typename Q::template rebind<To>, N>
+precision_cast(const vec<Q, N> &v) noexcept {
+    vec<typename Q::template rebind<To>, N> out;
+    for (glm::length_t i = 0; i < N; ++i) {
+        out.data[i] = static_cast<To>(v.data[i]);
+    }
+    return out;
+}
+
 } // namespace physi
\ No newline at end of file
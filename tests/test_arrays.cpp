@@ -0,0 +1,567 @@
+// File: tests/test_arrays.cpp
+// Catch2 tests for the structure-of-arrays containers and bulk kernels.
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../include/physi/physi.hpp"
+
+using namespace physi;
+using namespace physi::literals;
+using namespace Catch;
+
+template <typename A, typename B>
+concept addable = requires(const A &a, const B &b) { a + b; };
+
+// Counts the over-aligned allocations, which is how quantity_array columns
+// get their storage.
+namespace {
+std::atomic<std::size_t> aligned_allocations{0};
+} // namespace
+
+void *operator new(std::size_t size, std::align_val_t align) {
+    aligned_allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto a = static_cast<std::size_t>(align);
+    if (void *p = std::aligned_alloc(a, (size + a - 1) / a * a)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+
+TEST_CASE("quantity_array storage and element access") {
+    quantity_array<length_f> a(5);
+    REQUIRE(a.size() == 5);
+    REQUIRE(a[3].m() == 0.0f);
+
+    // storage is aligned for the widest vector registers
+    REQUIRE(reinterpret_cast<std::uintptr_t>(a.base_data()) % simd_alignment ==
+            0);
+
+    a[2] = 3.0_m;
+    REQUIRE(a.base_data()[2] == Approx(3.0f));
+
+    a.push_back(1.0_km);
+    REQUIRE(a.size() == 6);
+    REQUIRE(a[5].m() == Approx(1000.0f));
+
+    quantity_array<mass_d> m = {1_kg, 2_kg, 3_kg};
+    std::span<const mass_d> view = m;
+    REQUIRE(view.size() == 3);
+    REQUIRE(view[1].g() == Approx(2000.0));
+}
+
+TEST_CASE("quantity_array element-wise dimensional arithmetic") {
+    quantity_array<length_d> x = {1_m, 2_m, 3_m};
+    quantity_array<time_d> t = {1_s, 2_s, 4_s};
+
+    quantity_array v = x / t;
+    STATIC_REQUIRE(std::is_same_v<decltype(v), quantity_array<speed_d>>);
+    REQUIRE(v[2].m_s() == Approx(0.75));
+
+    quantity_array a = v / t;
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(a), quantity_array<acceleration_d>>);
+
+    // broadcast quantities and scalars
+    quantity_array traveled = v * time_d(2.0);
+    STATIC_REQUIRE(std::is_same_v<decltype(traveled), quantity_array<length_d>>);
+    REQUIRE(traveled[1].m() == Approx(2.0));
+
+    quantity_array doubled = 2.0 * x;
+    REQUIRE(doubled[2].m() == Approx(6.0));
+
+    // same-dimension ratio is dimensionless
+    quantity_array ratio = x / x;
+    STATIC_REQUIRE(std::is_same_v<decltype(ratio), quantity_array<double>>);
+    REQUIRE(ratio[0] == Approx(1.0));
+
+    // mixed precision promotes like quantity does
+    quantity_array<length_f> xf = {1_m, 1_m, 1_m};
+    quantity_array sum = xf + x;
+    STATIC_REQUIRE(std::is_same_v<decltype(sum), quantity_array<length_d>>);
+    REQUIRE(sum[2].m() == Approx(4.0));
+
+    // compound assignment keeps the underlying type
+    xf += x;
+    xf -= 1.0_m;
+    xf *= 2;
+    REQUIRE(xf[1].m() == Approx(4.0f));
+}
+
+TEST_CASE("vec_array structure-of-arrays vectors") {
+    vec3_array<length_f> pos(3);
+    pos.set(1, vec3<length_f>{1_m, 2_m, 3_m});
+    REQUIRE(pos[1] == vec3<length_f>{1_m, 2_m, 3_m});
+    REQUIRE(pos.y()[1].m() == Approx(2.0f));
+
+    vec3_array<speed_f> vel(3, vec3<speed_f>{1_m_s, 0_m_s, -1_m_s});
+
+    pos += vel * time_f(2.0f);
+    REQUIRE(pos[0].x().m() == Approx(2.0f));
+    REQUIRE(pos[1].z().m() == Approx(1.0f));
+
+    // per-row scaling by a column: F / m -> a
+    vec3_array<force_d> f(2, vec3<force_d>{10_N, 0_N, 4_N});
+    quantity_array<mass_d> m = {2_kg, 4_kg};
+    vec_array acc = f / m;
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(acc), vec3_array<acceleration_d>>);
+    REQUIRE(acc[0].x().m_s2() == Approx(5.0));
+    REQUIRE(acc[1].z().m_s2() == Approx(1.0));
+
+    vec_array diff = pos - pos;
+    REQUIRE(diff[1] == vec3<length_f>{});
+}
+
+TEST_CASE("Batch vec geometry matches the per-vec operations") {
+    // 37 rows: full AVX-512 / AVX2 packs plus a scalar tail
+    const std::size_t n = 37;
+    vec3_array<length_f> arm(n), other(n);
+    vec3_array<force_f> f(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto x = static_cast<float>(i);
+        arm.set(i, {length_f(0.5f * x + 1), length_f(2 - x), length_f(0.25f)});
+        other.set(i, {length_f(x), length_f(1), length_f(-x)});
+        f.set(i, {force_f(1), force_f(x), force_f(-3)});
+    }
+
+    const auto r = batch::length(arm);
+    const auto dir = batch::normalized(arm);
+    const auto d = batch::distance(arm, other);
+    const auto work = batch::dot(arm, f);
+    const auto moment = batch::cross(arm, f);
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(r), const quantity_array<length_f>>);
+    STATIC_REQUIRE(std::is_same_v<decltype(dir), const vec3_array<float>>);
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(work), const quantity_array<energy_f>>);
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(moment), const vec3_array<energy_f>>);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto a = arm[i];
+        REQUIRE(r[i].m() == Approx(a.length().m()));
+        REQUIRE(dir.y()[i] == Approx(a.normalized().y));
+        REQUIRE(d[i].m() == Approx(a.distance(other[i]).m()));
+        REQUIRE(work[i].J() == Approx(a.dot(f[i]).J()));
+        REQUIRE(moment[i].z().J() == Approx(a.cross(f[i]).z().J()));
+    }
+
+    // double columns and reuse of an output array
+    vec3_array<length_d> wide = arm;
+    quantity_array<length_d> out(1);
+    batch::length(wide, out);
+    REQUIRE(out.size() == n);
+    REQUIRE(out[3].m() == Approx(std::sqrt(2.5 * 2.5 + 1 + 0.0625)));
+
+    // moments as torques: relabelled explicitly, or written in place
+    STATIC_REQUIRE_FALSE(
+        std::is_convertible_v<vec3_array<energy_f>, vec3_array<torque_f>>);
+    const vec3_array<torque_f> tau(moment);
+    vec3_array<torque_f> tau_out;
+    batch::cross(arm, f, tau_out);
+    quantity_array<energy_f> work_out;
+    batch::dot(arm, f, work_out);
+    REQUIRE(tau_out.size() == n);
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(tau[i].z().N_m() == Approx(moment[i].z().J()));
+        REQUIRE(tau_out[i].x().N_m() == Approx(moment[i].x().J()));
+        REQUIRE(work_out[i].J() == Approx(work[i].J()));
+    }
+}
+
+TEST_CASE("Batch transforms match the per-vec products") {
+    const std::size_t n = 37;
+    vec3_array<length_d> p(n);
+    vec3_array<angular_velocity_d> w(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto x = static_cast<double>(i);
+        p.set(i, {length_d(x), length_d(1 - x), length_d(0.5 * x)});
+        w.set(i, {angular_velocity_d(1), angular_velocity_d(x),
+                  angular_velocity_d(-x)});
+    }
+    const quat<double> q = quat<double>::angle_axis(0.7, {1, 2, 3});
+    const vec3<length_d> t = {1_m, -2_m, 3_m};
+    using inertia = moment_of_inertia_d;
+    const mat3<inertia> I = {inertia(2),   inertia(0.5), inertia(0),
+                             inertia(0.5), inertia(3),   inertia(0),
+                             inertia(0),   inertia(0),   inertia(4)};
+
+    const auto rotated = batch::transform(q, p);
+    const auto moved = batch::transform(q, t, p);
+    const auto L = batch::transform(I, w);
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(rotated), const vec3_array<length_d>>);
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(L), const vec3_array<angular_momentum_d>>);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const vec3<length_d> r = q * p[i];
+        const vec3<angular_momentum_d> l = I * w[i];
+        for (glm::length_t c = 0; c < 3; ++c) {
+            REQUIRE(rotated[i][c].m() == Approx(r[c].m()).margin(1e-12));
+            REQUIRE(moved[i][c].m() ==
+                    Approx((r + t)[c].m()).margin(1e-12));
+            REQUIRE(L[i][c].kg_m2_s() == Approx(l[c].kg_m2_s()));
+        }
+    }
+
+    // in place: there and back again
+    vec3_array<length_d> same = p;
+    batch::transform(q, same, same);
+    batch::transform(q.conjugate(), same, same);
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(same.z()[i].m() == Approx(p.z()[i].m()).margin(1e-12));
+    }
+}
+
+TEST_CASE("Array expressions are lazy and evaluated in one pass") {
+    quantity_array<length_d> pos = {0_m, 1_m, 2_m};
+    quantity_array<speed_d> vel = {1_m_s, 1_m_s, 2_m_s};
+    quantity_array<acceleration_d> acc = {2_m_s2, 0_m_s2, -2_m_s2};
+    const time_d dt = 0.5_s;
+
+    // the expression is a typed tree, not a materialized array
+    auto e = pos + vel * dt + 0.5 * acc * dt * dt;
+    STATIC_REQUIRE(is_array_expression_v<decltype(e)>);
+    STATIC_REQUIRE(!is_quantity_array_v<decltype(e)>);
+    STATIC_REQUIRE(std::is_same_v<decltype(e)::quantity_type, length_d>);
+    REQUIRE(e.size() == 3);
+    REQUIRE(e.base_at(2) == Approx(2.75));
+
+    // assigning evaluates into the existing storage; aliasing pos is safe
+    const auto *storage = pos.base_data();
+    pos = e;
+    REQUIRE(pos.base_data() == storage);
+    REQUIRE(pos[0].m() == Approx(0.75));
+    REQUIRE(pos[1].m() == Approx(1.5));
+
+    // temporaries are owned by the expression
+    quantity_array<length_f> shifted = (pos + pos) - pos;
+    REQUIRE(shifted[1].m() == Approx(1.5f));
+
+    // dimensions are checked on the whole tree
+    STATIC_REQUIRE(!addable<decltype(pos), decltype(vel)>);
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(vel / dt)::quantity_type, acceleration_d>);
+
+    // vec expressions fuse per component
+    vec3_array<length_d> p(2, vec3<length_d>{1_m, 2_m, 3_m});
+    vec3_array<speed_d> v(2, vec3<speed_d>{1_m_s, 0_m_s, -1_m_s});
+    vec3_array<acceleration_d> a(2, vec3<acceleration_d>{0_m_s2, 0_m_s2,
+                                                         -10_m_s2});
+    p = p + v * dt + 0.5 * a * dt * dt;
+    REQUIRE(p[1].x().m() == Approx(1.5));
+    REQUIRE(p[1].z().m() == Approx(3.0 - 0.5 - 1.25));
+
+    p -= vec3<length_d>{1_m, 1_m, 1_m};
+    REQUIRE(p[0].y().m() == Approx(1.0));
+}
+
+TEST_CASE("Assigning an expression does not copy the columns it owns") {
+    const std::size_t n = 64;
+    quantity_array<length_d> x(n, 1_m);
+    const auto doubled = quantity_array<length_d>(n, 2_m) * 2.0;
+    vec3_array<acceleration_d> a(n);
+    const auto pull = vec3_array<force_d>(n, vec3<force_d>{1_N, 2_N, 4_N}) /
+                      quantity_array<mass_d>(n, 2_kg);
+
+    const auto before = aligned_allocations.load();
+    x = doubled;
+    x += doubled;
+    x -= doubled;
+    a = pull;
+    a += pull;
+    a -= pull;
+    REQUIRE(aligned_allocations.load() == before);
+
+    REQUIRE(x[n - 1].m() == Approx(4.0));
+    REQUIRE(a[0].z().m_s2() == Approx(2.0));
+}
+
+TEST_CASE("Bulk unit conversion over spans") {
+    const std::vector<double> feet = {1.0, 10.0, 100.0, 5280.0};
+    std::vector<length_d> lengths(feet.size());
+    length_d::from_ft(feet, lengths);
+    REQUIRE(lengths[2].m() == Approx(30.48));
+    REQUIRE(lengths[3].mi() == Approx(1.0).epsilon(1e-4));
+
+    std::vector<double> km(feet.size());
+    length_d::to_km(lengths, km);
+    REQUIRE(km[1] == Approx(0.003048));
+
+    // unit tags and the generic entry points
+    std::vector<double> back(feet.size());
+    to_unit(std::span<const length_d>(lengths), length_d::ft_unit{}, back);
+    REQUIRE(back[3] == Approx(5280.0));
+
+    // affine units (temperature) apply their offset
+    quantity_array<temperature_f> t(3);
+    const std::vector<float> fahrenheit = {32.0f, 212.0f, -459.67f};
+    from_unit(std::span<const float>(fahrenheit), temperature_f::F_unit{},
+              std::span<temperature_f>(t));
+    REQUIRE(t[0].K() == Approx(273.15f));
+    REQUIRE(t[1].C() == Approx(100.0f).margin(1e-3f));
+    REQUIRE(t[2].K() == Approx(0.0f).margin(1e-3f));
+
+    std::vector<float> celsius(3);
+    temperature_f::to_C(t, celsius);
+    REQUIRE(celsius[1] == Approx(100.0f).margin(1e-3f));
+}
+
+TEST_CASE("Units are enumerable and found by name at runtime") {
+    STATIC_REQUIRE(length_d::units().size() == 7);
+    STATIC_REQUIRE(length_d::units()[4].name == "ft");
+
+    const auto psi = pressure_d::find_unit("psi");
+    REQUIRE(psi.has_value());
+    REQUIRE(psi->scale == Approx(6894.76).epsilon(1e-4));
+    REQUIRE_FALSE(pressure_d::find_unit("furlong").has_value());
+
+    const auto f = temperature_d::find_unit("F");
+    REQUIRE(f->offset == Approx(459.67));
+
+    const std::vector<double> readings = {14.7, 29.4};
+    std::vector<pressure_d> p(2);
+    from_unit<pressure_d>(readings, *psi, p);
+    REQUIRE(p[1].kPa() == Approx(202.7).epsilon(1e-3));
+}
+
+TEST_CASE("Parallel reductions keep their dimensions") {
+    const std::size_t n = 100000; // several chunks of reduce_grain
+    quantity_array<force_d> f(n);
+    quantity_array<length_d> dx(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        f[i] = force_d(static_cast<double>(i % 7));
+        dx[i] = length_d(0.5);
+    }
+
+    for (std::size_t threads : {1u, 4u}) {
+        const energy_d work = sum_of_products(f, dx, threads);
+        REQUIRE(work.J() == Approx(0.5 * sum(f, threads).base_value()));
+        REQUIRE(mean(dx, threads).m() == Approx(0.5));
+
+        const auto [lo, hi] = minmax(f, threads);
+        STATIC_REQUIRE(std::is_same_v<std::remove_cvref_t<decltype(lo)>,
+                                      force_d>);
+        REQUIRE(lo.N() == 0.0);
+        REQUIRE(hi.N() == 6.0);
+    }
+
+    const std::vector<speed_f> v = {speed_f(1.0f), speed_f(-3.0f),
+                                    speed_f(2.0f)};
+    REQUIRE(sum(v).m_s() == Approx(0.0f));
+    REQUIRE(minmax(std::span<const speed_f>(v)).min.m_s() == -3.0f);
+    REQUIRE(sum(std::vector<double>{}) == 0.0);
+}
+
+TEST_CASE("vec_array reductions: net sums, power and centroids") {
+    vec3_array<length_d> pos(4);
+    pos.set(0, {0.0_m, 0.0_m, 0.0_m});
+    pos.set(1, {2.0_m, 0.0_m, 0.0_m});
+    pos.set(2, {0.0_m, 4.0_m, 0.0_m});
+    pos.set(3, {2.0_m, 4.0_m, 8.0_m});
+
+    const vec3<length_d> c = centroid(pos);
+    REQUIRE(c.x().m() == Approx(1.0));
+    REQUIRE(c.z().m() == Approx(2.0));
+
+    const quantity_array<mass_d> m = {1_kg, 1_kg, 1_kg, 5_kg};
+    const vec3<length_d> com = centroid(pos, m);
+    REQUIRE(com.x().m() == Approx(12.0 / 8.0));
+    REQUIRE(com.z().m() == Approx(40.0 / 8.0));
+
+    vec3_array<force_d> f(4, vec3<force_d>{1.0_N, 2.0_N, 0.0_N});
+    vec3_array<speed_d> v(
+        4, vec3<speed_d>{speed_d(3.0), speed_d(1.0), speed_d(9.0)});
+    const power_d p = sum_of_products(f, v);
+    REQUIRE(p.W() == Approx(4 * 5.0));
+
+    const vec3<force_d> net = sum(f);
+    REQUIRE(net.y().N() == Approx(8.0));
+}
+
+TEST_CASE("Reproducible reductions do not depend on the thread count") {
+    // Values spanning many magnitudes, so any change in the order of
+    // additions shows up in the last bits.
+    const std::size_t n = 300007;
+    quantity_array<energy_f> e(n);
+    quantity_array<mass_f> m(n);
+    vec3_array<speed_f> v(n);
+    std::uint32_t state = 12345;
+    const auto next = [&state] {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+    };
+    for (std::size_t i = 0; i < n; ++i) {
+        const float x = (next() - 0.5f) * std::exp2(next() * 40.0f - 20.0f);
+        e[i] = energy_f(x);
+        m[i] = mass_f(next());
+        v.set(i, {speed_f(next() - 0.5f), speed_f(x), speed_f(next())});
+    }
+
+    const energy_f total = sum(e, reduction::reproducible, 1);
+    const auto moment = sum_of_products(m, e, reduction::reproducible, 1);
+    const vec3<speed_f> net = sum(v, reduction::reproducible, 1);
+    const auto power = sum_of_products(v, v, reduction::reproducible, 1);
+    const vec3<speed_f> weighted = centroid(v, m, reduction::reproducible, 1);
+    for (std::size_t threads : {2u, 3u, 4u, 7u, 16u, 0u}) {
+        REQUIRE(sum(e, reduction::reproducible, threads).base_value() ==
+                total.base_value());
+        REQUIRE(sum_of_products(m, e, reduction::reproducible, threads)
+                    .base_value() == moment.base_value());
+        REQUIRE(sum(v, reduction::reproducible, threads).base_value() ==
+                net.base_value());
+        REQUIRE(sum_of_products(v, v, reduction::reproducible, threads)
+                    .base_value() == power.base_value());
+        REQUIRE(centroid(v, m, reduction::reproducible, threads)
+                    .base_value() == weighted.base_value());
+    }
+    CHECK(mean(e, reduction::reproducible, 5).base_value() ==
+          total.base_value() / static_cast<float>(n));
+    CHECK(sum(std::vector<energy_d>{}, reduction::reproducible).J() == 0.0);
+}
+
+TEST_CASE("quantity_accumulator keeps float totals accurate") {
+    const std::size_t n = 1000000;
+    quantity_array<energy_f> e(n, energy_f(0.1f));
+
+    float naive = 0.0f;
+    for (const auto &x : e) {
+        naive += x.base_value();
+    }
+    const double exact = n * static_cast<double>(0.1f);
+    REQUIRE(std::abs(naive - exact) / exact > 1e-3); // plain float drifts
+
+    quantity_accumulator<energy_f> neumaier;
+    neumaier.add(e);
+    quantity_accumulator<energy_f, summation::kahan> kahan;
+    quantity_accumulator<energy_f, summation::pairwise> pairwise;
+    for (std::size_t i = 0; i < n; ++i) {
+        kahan += e[i];
+        pairwise += e[i];
+    }
+    REQUIRE(neumaier.count() == n);
+    REQUIRE(neumaier.total().J() == Approx(exact).epsilon(1e-6));
+    REQUIRE(kahan.total().J() == Approx(exact).epsilon(1e-6));
+    REQUIRE(pairwise.total().J() == Approx(exact).epsilon(1e-6));
+    REQUIRE(pairwise.mean().J() == Approx(0.1f));
+
+    // Neumaier survives terms larger than the running sum
+    quantity_accumulator<length_d> big;
+    for (double x : {1.0, 1e100, 1.0, -1e100}) {
+        big += length_d(x);
+    }
+    REQUIRE(big.total().m() == 2.0);
+
+    // per-thread accumulators merge into one total
+    quantity_accumulator<energy_f, summation::pairwise> a, b;
+    a.add(std::span<const energy_f>(e.data(), 1000));
+    b.add(std::span<const energy_f>(e.data() + 1000, 999));
+    a.merge(b);
+    REQUIRE(a.count() == 1999);
+    REQUIRE(a.total().J() == Approx(199.9).epsilon(1e-6));
+}
+
+TEST_CASE("spatial_hash finds the same pairs as brute force") {
+    // a deterministic cloud straddling the origin, with negative cells
+    constexpr std::size_t n = 2000;
+    vec3_array<length_d> p(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        p.set(i, {length_d(double((i * 7919) % 401) * 0.05 - 10.0),
+                  length_d(double((i * 104729) % 397) * 0.05 - 10.0),
+                  length_d(double((i * 31) % 389) * 0.05 - 10.0)});
+    }
+    const auto brute = [&](double r) {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> out;
+        for (std::uint32_t i = 0; i < n; ++i) {
+            for (std::uint32_t j = i + 1; j < n; ++j) {
+                const auto d = p[i] - p[j];
+                if (d.dot(d).base_value() <= r * r) {
+                    out.emplace_back(i, j);
+                }
+            }
+        }
+        return out;
+    };
+
+    spatial_hash<double> grid(1_m);
+    grid.assign(p);
+    REQUIRE(grid.size() == n);
+    REQUIRE(grid.cell_count() > 1);
+    for (const double r : {0.5, 1.0, 2.5}) {
+        auto pairs = grid.pairs_within(length_d(r), 3);
+        std::sort(pairs.begin(), pairs.end());
+        REQUIRE(pairs == brute(r));
+    }
+
+    // the broad phase is a superset of the pairs within one cell edge
+    auto candidates = grid.candidate_pairs();
+    std::sort(candidates.begin(), candidates.end());
+    for (const auto &pair : brute(1.0)) {
+        REQUIRE(std::binary_search(candidates.begin(), candidates.end(),
+                                   pair));
+    }
+
+    // radius query around an object
+    auto near = grid.query(p[5], 1.5_m);
+    std::sort(near.begin(), near.end());
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t j = 0; j < n; ++j) {
+        const auto d = p[j] - p[5];
+        if (d.dot(d).base_value() <= 1.5 * 1.5) {
+            expected.push_back(j);
+        }
+    }
+    REQUIRE(near == expected);
+
+    // bulk update after every object moved
+    for (std::size_t i = 0; i < n; ++i) {
+        p.set(i, p[i] + vec3<length_d>{0.7_m, -0.3_m, 0_m});
+    }
+    grid.update(p);
+    auto moved = grid.pairs_within(1_m);
+    std::sort(moved.begin(), moved.end());
+    REQUIRE(moved == brute(1.0));
+}
+
+TEST_CASE("spatial_hash incremental insert, update and erase") {
+    spatial_hash<float> grid(length_f(2.0f));
+    const auto a = grid.insert({length_f(0.5f), length_f(0.5f), length_f(0)});
+    const auto b = grid.insert({length_f(1.0f), length_f(0.5f), length_f(0)});
+    const auto c = grid.insert({length_f(9.0f), length_f(9.0f), length_f(0)});
+    REQUIRE(grid.size() == 3);
+    REQUIRE(grid.pairs_within(length_f(1.0f)).size() == 1);
+
+    // moving c next to a crosses several cells
+    grid.update(c, {length_f(-0.2f), length_f(0.5f), length_f(0)});
+    REQUIRE(grid.position(c).x().base_value() == -0.2f);
+    REQUIRE(grid.pairs_within(length_f(1.0f)).size() == 2);
+    REQUIRE(grid.query({length_f(0), length_f(0.5f), length_f(0)},
+                       length_f(0.6f))
+                .size() == 2);
+
+    grid.erase(a);
+    REQUIRE_FALSE(grid.contains(a));
+    REQUIRE(grid.size() == 2);
+    const auto pairs = grid.pairs_within(length_f(2.0f));
+    REQUIRE(pairs.size() == 1);
+    REQUIRE(pairs[0] == std::pair{std::min(b, c), std::max(b, c)});
+
+    // erased ids are reused
+    REQUIRE(grid.insert({length_f(50), length_f(0), length_f(0)}) == a);
+    grid.clear();
+    REQUIRE(grid.empty());
+    REQUIRE(grid.cell_count() == 0);
+}
@@ -0,0 +1,215 @@
+// File: tests/test_io.cpp
+// Catch2 tests for reading and writing quantity columns.
+
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+
+#include "../include/physi/io/column_file.hpp"
+#include "../include/physi/io/csv.hpp"
+#include "../include/physi/physi.hpp"
+
+using namespace physi;
+using namespace physi::literals;
+using namespace Catch;
+
+TEST_CASE("CSV columns are parsed into base units") {
+    const std::string text = "time,pressure[psi], temperature[F] ,note\r\n"
+                             "0,14.7,32,1\r\n"
+                             "\r\n"
+                             "0.5,29.4,212,2\r\n"
+                             "1,0,-459.67,3";
+    quantity_array<pressure_d> p;
+    quantity_array<temperature_f> t;
+    quantity_array<time_d> s;
+
+    csv_reader reader(text);
+    reader.bind("temperature", t).bind("pressure", p).bind("time", s);
+    REQUIRE(reader.read() == 3);
+
+    REQUIRE(p.size() == 3);
+    REQUIRE(p[1].kPa() == Approx(202.7).epsilon(1e-3));
+    REQUIRE(t[0].K() == Approx(273.15f));
+    REQUIRE(t[1].C() == Approx(100.0f).margin(1e-3f));
+    REQUIRE(s[2].s() == Approx(1.0));
+
+    SECTION("Errors name the offending column") {
+        quantity_array<length_d> l;
+        csv_reader missing(text);
+        missing.bind("distance", l);
+        REQUIRE_THROWS_AS(missing.read(), io_error);
+
+        csv_reader bad_unit("d[parsec]\n1\n");
+        bad_unit.bind("d", l);
+        REQUIRE_THROWS_WITH(bad_unit.read(), Contains("parsec"));
+
+        csv_reader bad_value("d[ft]\n1\n2x\n");
+        bad_value.bind("d", l);
+        REQUIRE_THROWS_WITH(bad_value.read(), Contains("row 2"));
+
+        csv_reader duplicate("x[km],x[km]\n1,1\n");
+        duplicate.bind("x", l);
+        REQUIRE_THROWS_WITH(duplicate.read(), Contains("duplicate"));
+    }
+}
+
+TEST_CASE("CSV round trip across threads") {
+    const std::size_t n = 20000;
+    quantity_array<speed_d> v(n);
+    quantity_array<temperature_d> t(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v[i] = speed_d(0.25 * static_cast<double>(i));
+        t[i] = temperature_d(200.0 + static_cast<double>(i % 100));
+    }
+
+    csv_writer writer;
+    writer.column("speed", v, "km_h").column("temperature", t, "C");
+    const std::string text = writer.to_string(4);
+    REQUIRE(text.substr(0, text.find('\n')) == "speed[km_h],temperature[C]");
+    REQUIRE(writer.to_string(1) == text);
+
+    quantity_array<speed_d> v2;
+    quantity_array<temperature_d> t2;
+    csv_reader reader(text);
+    reader.bind("speed", v2).bind("temperature", t2);
+    REQUIRE(reader.read(4) == n);
+    REQUIRE(v2[n - 1].m_s() == Approx(v[n - 1].m_s()));
+    REQUIRE(t2[1234].K() == Approx(t[1234].K()));
+
+    // files go through the same code path
+    const std::string path = "physi_test_io.csv";
+    writer.write(path, 2);
+    quantity_array<speed_d> v3;
+    auto from_file = csv_reader::open(path);
+    from_file.bind("speed", v3);
+    REQUIRE(from_file.read(3) == n);
+    REQUIRE(v3[777].m_s() == Approx(v[777].m_s()));
+    std::remove(path.c_str());
+
+    quantity_array<speed_d> shorter(3);
+    writer.column("short", shorter);
+    REQUIRE_THROWS_AS(writer.to_string(), io_error);
+}
+
+TEST_CASE("CSV reads and writes 16-bit columns through float") {
+    const std::string text = "pressure[kPa],density\n"
+                             "1.5,1.225\n"
+                             "0.1234,1000\n";
+    quantity_array<pressure_h> p;
+    quantity_array<density_bf16> rho;
+    csv_reader reader(text);
+    reader.bind("pressure", p).bind("density", rho);
+    REQUIRE(reader.read() == 2);
+    REQUIRE(float(p[0].base_value()) == 1500.0f);
+    REQUIRE(p[1].base_value() == half(123.4f));
+    REQUIRE(rho[0].base_value() == bfloat16(1.225f));
+    REQUIRE(float(rho[1].base_value()) == 1000.0f);
+
+    csv_writer writer;
+    writer.column("pressure", p, "Pa").column("density", rho);
+    REQUIRE(writer.to_string() == "pressure[Pa],density\n"
+                                  "1500,1.2265625\n"
+                                  "123.375,1000\n");
+}
+
+TEST_CASE("Column files map quantity columns back zero-copy") {
+    const std::size_t n = 1000;
+    quantity_array<time_d> t(n);
+    vec3_array<length_f> pos(n);
+    quantity_array<double> weight(n, 0.5);
+    for (std::size_t i = 0; i < n; ++i) {
+        t[i] = time_d(0.01 * static_cast<double>(i));
+        pos.set(i, vec3<length_f>{length_f(float(i)), 2_m, -3_m});
+    }
+
+    const std::string path = "physi_test_columns.phc";
+    column_file_writer writer;
+    writer.add("time", t).add("position", pos).add("weight", weight);
+    writer.write(path);
+
+    {
+        const auto file = column_file::open(
+            path, {column_spec::of<time_d>("time"),
+                   column_spec::of<length_f, 3>("position")});
+        REQUIRE(file.rows() == n);
+        REQUIRE(file.columns().size() == 3);
+        REQUIRE(file.columns()[1].components == 3);
+
+        const std::span<const time_d> times = file.column<time_d>("time");
+        REQUIRE(times[500].s() == Approx(5.0));
+        REQUIRE(reinterpret_cast<std::uintptr_t>(times.data()) %
+                    simd_alignment ==
+                0);
+
+        const auto [x, y, z] = file.vec_column<length_f, 3>("position");
+        REQUIRE(x[999].m() == Approx(999.0f));
+        REQUIRE(z[0].m() == Approx(-3.0f));
+        REQUIRE(file.column<double>("weight")[7] == Approx(0.5));
+
+        // dimension, precision and width are checked
+        REQUIRE_THROWS_WITH(file.column<mass_d>("time"),
+                            Contains("requested M1"));
+        REQUIRE_THROWS_AS(file.column<time_f>("time"), io_error);
+        REQUIRE_THROWS_AS(file.column<length_f>("position"), io_error);
+        REQUIRE_THROWS_AS(file.column<time_d>("missing"), io_error);
+    }
+
+    REQUIRE_THROWS_AS(
+        column_file::open(path, {column_spec::of<speed_d>("time")}),
+        io_error);
+    std::remove(path.c_str());
+
+    quantity_array<time_d> shorter(3);
+    REQUIRE_THROWS_AS(writer.add("short", shorter), io_error);
+}
+
+TEST_CASE("Column files reject corrupt headers") {
+    const std::string path = "physi_test_corrupt.phc";
+    quantity_array<time_d> t(16, time_d(1.0));
+    column_file_writer writer;
+    writer.add("time", t);
+    writer.write(path);
+
+    std::string bytes;
+    {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        REQUIRE(file != nullptr);
+        char chunk[4096];
+        for (std::size_t got; (got = std::fread(chunk, 1, sizeof(chunk),
+                                                file)) > 0;) {
+            bytes.append(chunk, got);
+        }
+        std::fclose(file);
+    }
+    REQUIRE_NOTHROW(column_file::open(path));
+
+    // Patches the 64-byte header or the first 64-byte column descriptor.
+    const auto reopen_with = [&](std::size_t at, const void *value,
+                                 std::size_t size) {
+        std::string patched = bytes;
+        std::memcpy(patched.data() + at, value, size);
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        std::fwrite(patched.data(), 1, patched.size(), file);
+        std::fclose(file);
+        return column_file::open(path);
+    };
+    const std::size_t rows_at = 16, scalar_at = 64 + 47,
+                      scalar_size_at = 64 + 48, offset_at = 64 + 56;
+
+    // 2^61 rows of 8 bytes wrap a 64-bit byte count around to 0.
+    const std::uint64_t huge_rows = std::uint64_t{1} << 61;
+    REQUIRE_THROWS_WITH(reopen_with(rows_at, &huge_rows, 8),
+                        Contains("out of bounds"));
+    const std::uint64_t far_offset = ~std::uint64_t{63};
+    REQUIRE_THROWS_WITH(reopen_with(offset_at, &far_offset, 8),
+                        Contains("out of bounds"));
+    const std::uint8_t wrong_size = 4, unknown_scalar = 9;
+    REQUIRE_THROWS_WITH(reopen_with(scalar_size_at, &wrong_size, 1),
+                        Contains("scalar type"));
+    REQUIRE_THROWS_WITH(reopen_with(scalar_at, &unknown_scalar, 1),
+                        Contains("scalar type"));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,63 @@
+// File: tests/test_promotion_counts.cpp
+// Catch2 tests for PHYSI_COUNT_PROMOTIONS, which this executable is built
+// with: every mixed-precision operation is recorded against its source line.
+
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <string_view>
+
+#include "../include/physi/physi.hpp"
+
+using namespace physi;
+using namespace Catch;
+
+TEST_CASE("Promotions are counted per call site") {
+    reset_promotion_counts();
+    const length_f a(1.0f);
+    const length_d b(2.0);
+    const force_f f(3.0f);
+
+    double total = 0.0;
+    const std::uint_least32_t sum_line = __LINE__ + 2;
+    for (int i = 0; i < 3; ++i) {
+        total += (a + b).m();
+        total += (a + a).m(); // same precision: not counted
+    }
+    const std::uint_least32_t product_line = __LINE__ + 1;
+    const energy_d e = f * b;
+    const std::uint_least32_t scalar_line = __LINE__ + 1;
+    const length_d half = a * 0.5;
+    REQUIRE(total == Approx(15.0));
+    REQUIRE(e.base_value() == Approx(6.0));
+    REQUIRE(half.m() == Approx(0.5));
+
+    // Constant evaluation leaves no trace.
+    constexpr length_d folded = length_f(1.0f) + length_d(1.0);
+    static_assert(folded.base_value() == 2.0);
+
+    const auto sites = promotion_counts();
+    REQUIRE(sites.size() == 3);
+    const promotion_site &sum = sites.front();
+    CHECK(sum.count == 3);
+    CHECK(sum.where.line() == sum_line);
+    CHECK(std::string_view(sum.where.file_name())
+              .ends_with("test_promotion_counts.cpp"));
+    CHECK(sum.operation == "+");
+    CHECK(sum.from == "float");
+    CHECK(sum.to == "double");
+
+    for (const promotion_site &site : sites) {
+        if (site.where.line() == product_line) {
+            CHECK(site.operation == "*");
+            CHECK(site.count == 1);
+        } else if (site.where.line() == scalar_line) {
+            CHECK(site.from == "float");
+            CHECK(site.to == "double");
+        } else {
+            CHECK(site.where.line() == sum_line);
+        }
+    }
+
+    reset_promotion_counts();
+    REQUIRE(promotion_counts().empty());
+}
@@ -0,0 +1,780 @@
+// File: tests/test_sim.cpp
+// Catch2 tests for the simulation engines.
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../include/physi/physi.hpp"
+
+using namespace physi;
+using namespace physi::literals;
+using namespace Catch;
+
+namespace {
+
+// Deterministic cloud of n bodies in a 1000 m cube.
+template <typename T> void fill_cloud(nbody_system<T> &sys, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const vec3<length<T>> x{length<T>(T((i * 7919) % 1000)),
+                                length<T>(T((i * 104729) % 1000)),
+                                length<T>(T((i * 31) % 997))};
+        sys.add(x, {}, mass<T>(T(1e6 + 1e4 * double(i % 17))));
+    }
+}
+
+// Equal masses on a circular orbit about their common centre.
+nbody_system<double> binary(integrator scheme, double r, double m) {
+    nbody_system<double> sys({.softening = 1_m, .scheme = scheme});
+    const double g = gravitational_constant<double>.base_value();
+    const double v = std::sqrt(g * m / (2 * r));
+    sys.add({length_d(r / 2), 0_m, 0_m}, {0_m_s, speed_d(v), 0_m_s},
+            mass_d(m));
+    sys.add({length_d(-r / 2), 0_m, 0_m}, {0_m_s, speed_d(-v), 0_m_s},
+            mass_d(m));
+    return sys;
+}
+
+} // namespace
+
+TEST_CASE("N-body accelerations match direct summation") {
+    constexpr std::size_t n = 37; // not a multiple of any pack width
+    nbody_system<double> sys({.softening = 2_m});
+    fill_cloud(sys, n);
+
+    const auto &a = sys.accelerations();
+    REQUIRE(a.size() == n);
+    const double g = gravitational_constant<double>.base_value();
+    const auto &x = sys.positions();
+    const auto &m = sys.masses();
+    for (std::size_t i = 0; i < n; ++i) {
+        double ref[3] = {0, 0, 0};
+        for (std::size_t j = 0; j < n; ++j) {
+            double d[3];
+            double r2 = 4.0; // softening^2
+            for (glm::length_t c = 0; c < 3; ++c) {
+                d[c] = x.component(c)[j].base_value() -
+                       x.component(c)[i].base_value();
+                r2 += d[c] * d[c];
+            }
+            const double s = g * m[j].base_value() / (r2 * std::sqrt(r2));
+            for (glm::length_t c = 0; c < 3; ++c) {
+                ref[c] += d[c] * s;
+            }
+        }
+        for (glm::length_t c = 0; c < 3; ++c) {
+            REQUIRE(a.component(c)[i].base_value() ==
+                    Approx(ref[c]).epsilon(1e-12).margin(1e-20));
+        }
+    }
+    REQUIRE(sys.interactions() == n * n);
+
+    // the cache is reused until positions change
+    (void)sys.accelerations();
+    REQUIRE(sys.interactions() == n * n);
+    sys.set_position(0, {1_m, 0_m, 0_m});
+    (void)sys.accelerations();
+    REQUIRE(sys.interactions() == 2 * n * n);
+}
+
+TEST_CASE("N-body results do not depend on the thread count") {
+    constexpr std::size_t n = 1500;
+    nbody_system<float> one({.softening = length_f(2.0f), .threads = 1});
+    nbody_system<float> four({.softening = length_f(2.0f), .threads = 4});
+    fill_cloud(one, n);
+    fill_cloud(four, n);
+
+    const auto &a = one.accelerations();
+    const auto &b = four.accelerations();
+    for (std::size_t i = 0; i < n; ++i) {
+        for (glm::length_t c = 0; c < 3; ++c) {
+            REQUIRE(b.component(c)[i].base_value() ==
+                    Approx(a.component(c)[i].base_value())
+                        .epsilon(1e-5)
+                        .margin(1e-12));
+        }
+    }
+}
+
+TEST_CASE("N-body potential energy sums every pair once") {
+    // odd n: the middle row is folded with itself
+    constexpr std::size_t n = 1001;
+    nbody_system<double> one({.softening = 2_m, .threads = 1});
+    nbody_system<double> three({.softening = 2_m, .threads = 3});
+    fill_cloud(one, n);
+    fill_cloud(three, n);
+
+    const auto &x = one.positions();
+    const auto &m = one.masses();
+    double pairs = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            const double r = (x[j] - x[i]).length().base_value();
+            pairs += m[i].base_value() * m[j].base_value() /
+                     std::sqrt(r * r + 4.0);
+        }
+    }
+    const double expected =
+        -gravitational_constant<double>.base_value() * pairs;
+    REQUIRE(one.potential_energy().J() == Approx(expected).epsilon(1e-12));
+    REQUIRE(three.potential_energy().J() == Approx(expected).epsilon(1e-12));
+
+    // the default softening keeps coincident bodies finite
+    nbody_system<double> packed;
+    packed.add({1_m, 2_m, 3_m}, {}, mass_d(1.0));
+    packed.add({1_m, 2_m, 3_m}, {}, mass_d(1.0));
+    REQUIRE(std::isfinite(packed.potential_energy().J()));
+    REQUIRE(packed.potential_energy().J() < 0.0);
+}
+
+TEST_CASE("N-body integrators conserve energy on a circular binary") {
+    const double r = 1e8, m = 1e24;
+    const double g = gravitational_constant<double>.base_value();
+    const double period =
+        2 * std::numbers::pi * std::sqrt(r * r * r / (2 * g * m));
+    constexpr int steps = 2000;
+
+    for (integrator scheme :
+         {integrator::velocity_verlet, integrator::leapfrog}) {
+        nbody_system<double> sys = binary(scheme, r, m);
+        const energy_d e0 = sys.kinetic_energy() + sys.potential_energy();
+        REQUIRE(e0.base_value() < 0.0); // bound orbit
+
+        const time_d dt(period / steps);
+        for (int k = 0; k < steps; ++k) {
+            sys.step(dt);
+        }
+
+        const energy_d e1 = sys.kinetic_energy() + sys.potential_energy();
+        REQUIRE(e1.base_value() == Approx(e0.base_value()).epsilon(1e-6));
+
+        // one period later the bodies are back where they started
+        const auto &x = sys.positions();
+        REQUIRE(x.x()[0].base_value() == Approx(r / 2).epsilon(1e-3));
+        REQUIRE(std::abs(x.y()[0].base_value()) < 1e-3 * r);
+
+        const vec3<momentum_d> p = sys.total_momentum();
+        REQUIRE(std::abs(p.x().base_value()) < 1e-6 * m);
+        REQUIRE(std::abs(p.y().base_value()) < 1e-6 * m);
+    }
+}
+
+TEST_CASE("Morton codes interleave x, y and z bits") {
+    REQUIRE(physi::detail::morton_code(1, 0, 0) == 1);
+    REQUIRE(physi::detail::morton_code(0, 1, 0) == 2);
+    REQUIRE(physi::detail::morton_code(0, 0, 1) == 4);
+    REQUIRE(physi::detail::morton_code(2, 0, 0) == 8);
+    constexpr std::uint32_t max = (1u << 21) - 1;
+    REQUIRE(physi::detail::morton_code(max, max, max) ==
+            (std::uint64_t{1} << 63) - 1);
+    const std::uint64_t code = physi::detail::morton_code(5, 1234, max);
+    REQUIRE(physi::detail::compact_bits_3(code) == 5);
+    REQUIRE(physi::detail::compact_bits_3(code >> 1) == 1234);
+    REQUIRE(physi::detail::compact_bits_3(code >> 2) == max);
+}
+
+TEST_CASE("Barnes-Hut matches direct summation") {
+    constexpr std::size_t n = 3000;
+    nbody_system<double> direct({.softening = 2_m});
+    fill_cloud(direct, n);
+    const auto &ref = direct.accelerations();
+
+    // theta = 0 opens every cell: the exact sum through the tree
+    barnes_hut<double> exact({.theta = 0.0, .softening = 2_m});
+    exact.build(direct.positions(), direct.masses());
+    REQUIRE(exact.size() == n);
+    REQUIRE(exact.node_count() > 1);
+    vec3_array<acceleration_d> a;
+    REQUIRE(exact.accelerations(a) == n * n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (glm::length_t c = 0; c < 3; ++c) {
+            REQUIRE(a.component(c)[i].base_value() ==
+                    Approx(ref.component(c)[i].base_value())
+                        .epsilon(1e-10)
+                        .margin(1e-20));
+        }
+    }
+
+    // relative RMS error against the direct sum
+    const auto rms_error = [&](const vec3_array<acceleration_d> &approx) {
+        double err = 0, norm = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (glm::length_t c = 0; c < 3; ++c) {
+                const double r = ref.component(c)[i].base_value();
+                const double d = approx.component(c)[i].base_value() - r;
+                err += d * d;
+                norm += r * r;
+            }
+        }
+        return std::sqrt(err / norm);
+    };
+
+    // the default opening angle approximates with far fewer interactions
+    barnes_hut<double> tree({.softening = 2_m});
+    tree.build(direct.positions(), direct.masses());
+    const std::uint64_t interactions = tree.accelerations(a);
+    REQUIRE(interactions < n * n / 2);
+    REQUIRE(rms_error(a) < 1e-2);
+
+    // theta = 1 is past the 1/sqrt(3) at which a centre of mass can sit far
+    // enough from a group to accept a cell next to (or around) it; no body
+    // may be off by more than a fraction of its acceleration
+    barnes_hut<double> coarse({.theta = 1.0, .softening = 2_m});
+    coarse.build(direct.positions(), direct.masses());
+    REQUIRE(coarse.accelerations(a) < interactions);
+    REQUIRE(rms_error(a) < 1e-2);
+    double worst = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double r = ref[i].length().base_value();
+        worst = std::max(worst, (a[i] - ref[i]).length().base_value() / r);
+    }
+    REQUIRE(worst < 0.5);
+}
+
+TEST_CASE("N-body totals can be made bitwise reproducible") {
+    const std::size_t n = 3000;
+    nbody_system<double> one({.softening = length_d(1.0),
+                              .threads = 1,
+                              .totals = reduction::reproducible});
+    nbody_system<double> four({.softening = length_d(1.0),
+                               .threads = 4,
+                               .totals = reduction::reproducible});
+    // Same state in both; the force evaluation itself only matches to
+    // rounding across thread counts.
+    for (std::size_t i = 0; i < n; ++i) {
+        const double s = static_cast<double>(i);
+        const vec3<length_d> x{length_d(std::fmod(s * 7.919, 1000.0)),
+                               length_d(std::fmod(s * 104.729, 1000.0)),
+                               length_d(std::fmod(s * 0.31, 997.0))};
+        const vec3<speed_d> v{speed_d(std::sin(s)), speed_d(std::cos(s)),
+                              speed_d(1e-3 * s)};
+        one.add(x, v, mass_d(1e6 + s));
+        four.add(x, v, mass_d(1e6 + s));
+    }
+    REQUIRE(one.kinetic_energy().J() == four.kinetic_energy().J());
+    REQUIRE(one.potential_energy().J() == four.potential_energy().J());
+    REQUIRE(one.total_momentum().base_value() ==
+            four.total_momentum().base_value());
+}
+
+TEST_CASE("Barnes-Hut builds the same tree on any thread count") {
+    constexpr std::size_t n = 5000;
+    nbody_system<float> bodies({.softening = length_f(2.0f)});
+    fill_cloud(bodies, n);
+
+    barnes_hut<float> one({.softening = length_f(2.0f), .threads = 1});
+    barnes_hut<float> four({.softening = length_f(2.0f), .threads = 4});
+    one.build(bodies.positions(), bodies.masses());
+    four.build(bodies.positions(), bodies.masses());
+    REQUIRE(one.node_count() == four.node_count());
+
+    vec3_array<acceleration_f> a, b;
+    REQUIRE(one.accelerations(a) == four.accelerations(b));
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(a[i] == b[i]);
+    }
+    REQUIRE(four.timings().build.count() > 0);
+    REQUIRE(four.timings().traversal.count() > 0);
+}
+
+TEST_CASE("nbody_system can evaluate forces with Barnes-Hut") {
+    constexpr std::size_t n = 500;
+    nbody_system<double> direct({.softening = 2_m});
+    nbody_system<double> tree({.softening = 2_m,
+                               .method = force_method::barnes_hut,
+                               .theta = 0.0});
+    fill_cloud(direct, n);
+    fill_cloud(tree, n);
+    direct.step(1_s);
+    tree.step(1_s);
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(tree.positions().x()[i].base_value() ==
+                Approx(direct.positions().x()[i].base_value()));
+        REQUIRE(tree.velocities().y()[i].base_value() ==
+                Approx(direct.velocities().y()[i].base_value())
+                    .margin(1e-15));
+    }
+    REQUIRE(tree.tree().size() == n);
+}
+
+namespace {
+
+// Columns of `per_stack` unit spheres resting on the floor, `gap` apart.
+rigid_body_system<double> stacks(std::size_t count, std::size_t per_stack,
+                                 double gap, std::size_t threads = 0) {
+    rigid_body_system<double> world(
+        {.floor = length_d(0), .threads = threads});
+    const mass_d m(1.0);
+    const length_d r(0.5);
+    for (std::size_t s = 0; s < count; ++s) {
+        for (std::size_t k = 0; k < per_stack; ++k) {
+            world.add({length_d(gap * double(s)), length_d(0),
+                       length_d(0.5 + 1.02 * double(k))},
+                      m, sphere_inertia(m, r), r);
+        }
+    }
+    return world;
+}
+
+} // namespace
+
+TEST_CASE("Rigid bodies integrate free motion") {
+    rigid_body_system<double> world;
+    const mass_d m(2.0);
+    const length_d r(0.5);
+    const auto ball = world.add({0_m, 0_m, 100_m}, m, sphere_inertia(m, r), r);
+    // a symmetric top spins freely without torques
+    const auto top = world.add({50_m, 0_m, 0_m}, m,
+                               box_inertia(m, vec3<length_d>{1_m, 1_m, 2_m}),
+                               r);
+    world.set_angular_velocity(
+        top, {angular_velocity_d(0), angular_velocity_d(0),
+              angular_velocity_d(std::numbers::pi)});
+
+    const int steps = 100;
+    for (int k = 0; k < steps; ++k) {
+        world.step(10_ms);
+    }
+    // semi-implicit Euler: z = z0 - g t^2 / 2 - g t dt / 2
+    const double t = 1.0, g = 9.80665;
+    REQUIRE(world.positions().z()[ball].base_value() ==
+            Approx(100.0 - 0.5 * g * t * (t + 0.01)).epsilon(1e-9));
+    REQUIRE(world.velocities().z()[ball].base_value() == Approx(-g * t));
+
+    // half a turn about z after one second
+    const auto q = world.orientation(top);
+    REQUIRE(q.w() == Approx(0.0).margin(1e-3));
+    REQUIRE(std::abs(q.z()) == Approx(1.0));
+    REQUIRE(world.angular_velocities().z()[top].base_value() ==
+            Approx(std::numbers::pi));
+
+    // a torque spins a body up: dw = tau / I * dt
+    const auto spinner = world.add({-50_m, 0_m, 0_m}, m,
+                                   sphere_inertia(m, r), r);
+    world.apply_torque(spinner, {0_N_m, 0_N_m, 0.2_N_m});
+    world.step(1_s);
+    REQUIRE(world.angular_velocities().z()[spinner].rad_s() ==
+            Approx(0.2 / (0.4 * 2.0 * 0.25)));
+    // the world-frame tensor of a sphere is isotropic: L = I w
+    REQUIRE(world.angular_momentum(spinner).z().kg_m2_s() ==
+            Approx(0.2).epsilon(1e-12));
+}
+
+TEST_CASE("Rigid body collisions conserve momentum") {
+    rigid_body_system<double> world(
+        {.gravity = {}, .restitution = 1.0, .friction = 0.0});
+    const length_d r(0.5);
+    const auto a = world.add({0_m, 0_m, 0_m}, mass_d(1.0),
+                             sphere_inertia(mass_d(1.0), r), r);
+    const auto b = world.add({3_m, 0.2_m, 0_m}, mass_d(3.0),
+                             sphere_inertia(mass_d(3.0), r), r);
+    world.set_velocity(a, {4_m_s, 0_m_s, 0_m_s});
+    for (int k = 0; k < 200; ++k) {
+        world.step(5_ms);
+    }
+    const auto &v = world.velocities();
+    REQUIRE(v.x()[b].base_value() > 0.0); // they did collide
+    REQUIRE(1.0 * v.x()[a].base_value() + 3.0 * v.x()[b].base_value() ==
+            Approx(4.0));
+    REQUIRE(1.0 * v.y()[a].base_value() + 3.0 * v.y()[b].base_value() ==
+            Approx(0.0).margin(1e-9));
+    REQUIRE(world.kinetic_energy().J() == Approx(8.0).epsilon(0.02));
+}
+
+TEST_CASE("Resting islands sleep and wake independently") {
+    auto world = stacks(4, 3, 5.0);
+    REQUIRE(world.awake_count() == 12);
+    for (int k = 0; k < 240; ++k) {
+        world.step(time_d(1.0 / 60));
+    }
+    REQUIRE(world.awake_count() == 0);
+    REQUIRE(world.kinetic_energy().J() == 0.0);
+    for (std::uint32_t i = 0; i < world.size(); ++i) {
+        REQUIRE(world.state(i) == body_state::sleeping);
+    }
+    // stacked, not sunk
+    REQUIRE(world.positions().z()[2].base_value() == Approx(2.5).margin(0.03));
+
+    // pushing the top of one stack wakes that stack only
+    world.apply_force(5, {200_N, 0_N, 0_N});
+    REQUIRE(world.awake_count() == 3);
+    world.step(time_d(1.0 / 60));
+    REQUIRE(world.awake_count() == 3);
+    REQUIRE(world.island_count() == 1);
+    REQUIRE(world.state(0) == body_state::sleeping);
+    REQUIRE(world.state(4) == body_state::awake);
+
+    // a falling body wakes the stack it lands on
+    const length_d r(0.5);
+    const auto ball = world.add({15_m, 0_m, 6_m}, mass_d(1.0),
+                                sphere_inertia(mass_d(1.0), r), r);
+    for (int k = 0; k < 60; ++k) {
+        world.step(time_d(1.0 / 60));
+    }
+    REQUIRE(world.state(ball) != body_state::fixed);
+    REQUIRE(world.state(0) == body_state::sleeping);
+    REQUIRE(world.positions().z()[ball].base_value() < 6.0);
+}
+
+TEST_CASE("Rigid body results do not depend on the thread count") {
+    auto one = stacks(64, 4, 1.1, 1);
+    auto four = stacks(64, 4, 1.1, 4);
+    for (auto *world : {&one, &four}) {
+        world->apply_force(3, {500_N, 0_N, 0_N});
+    }
+    for (int k = 0; k < 60; ++k) {
+        one.step(time_d(1.0 / 60));
+        four.step(time_d(1.0 / 60));
+    }
+    REQUIRE(one.awake_count() == four.awake_count());
+    for (std::uint32_t i = 0; i < one.size(); ++i) {
+        REQUIRE(one.positions()[i] == four.positions()[i]);
+        REQUIRE(one.orientation(i) == four.orientation(i));
+    }
+}
+
+TEST_CASE("Particle handles detect dead and reused slots") {
+    particle_pool<float> pool(8);
+    const auto a = pool.spawn({1_m, 0_m, 0_m}, {}, mass_f(1.0f), time_f(1));
+    const auto b = pool.spawn({2_m, 0_m, 0_m}, {}, mass_f(2.0f), time_f(1));
+    REQUIRE(pool.size() == 2);
+    REQUIRE(pool.alive(a));
+    REQUIRE(pool.mass(b).kg() == Approx(2.0f));
+
+    REQUIRE(pool.kill(a));
+    REQUIRE_FALSE(pool.alive(a));
+    REQUIRE_FALSE(pool.kill(a));
+    REQUIRE(pool.size() == 1);
+    REQUIRE(pool.dead_rows() == 1);
+    REQUIRE_FALSE(pool.row_alive(0));
+
+    // the next spawn reuses a's slot under a new generation
+    const auto c = pool.spawn({3_m, 0_m, 0_m}, {}, mass_f(3.0f), time_f(1));
+    REQUIRE(c.slot == a.slot);
+    REQUIRE_FALSE(pool.alive(a));
+    REQUIRE(pool.alive(c));
+    REQUIRE(pool.handle_at(pool.row(c)) == c);
+    REQUIRE_FALSE(pool.alive(decltype(pool)::handle{}));
+
+    pool.clear();
+    REQUIRE(pool.size() == 0);
+    REQUIRE_FALSE(pool.alive(b));
+    REQUIRE_FALSE(pool.alive(c));
+}
+
+TEST_CASE("Particle compaction keeps handles valid and rows dense") {
+    particle_pool<double> pool(256);
+    std::vector<particle_pool<double>::handle> handles;
+    for (int i = 0; i < 100; ++i) {
+        // every fifth particle lives for 0.05 s only
+        const time_d life(i % 5 == 0 ? 0.05 : 10.0);
+        handles.push_back(pool.spawn({length_d(i), 0_m, 0_m},
+                                     {0_m_s, 0_m_s, 1_m_s}, 1_kg, life));
+    }
+    for (int i = 1; i < 100; i += 3) {
+        pool.kill(handles[i]);
+    }
+    pool.advance(time_d(0.1), {0_m_s2, 0_m_s2, -10_m_s2});
+    pool.compact();
+
+    REQUIRE(pool.rows() == pool.size());
+    REQUIRE(pool.dead_rows() == 0);
+    std::size_t live = 0;
+    for (int i = 0; i < 100; ++i) {
+        const bool expect = i % 3 != 1 && i % 5 != 0;
+        REQUIRE(pool.alive(handles[i]) == expect);
+        if (!expect) {
+            continue;
+        }
+        const auto h = handles[i];
+        REQUIRE(pool.position(h).x().m() == Approx(i));
+        REQUIRE(pool.position(h).z().m() == Approx(0.0).margin(1e-12));
+        REQUIRE(pool.velocity(h).z().m_s() == Approx(0.0).margin(1e-12));
+        REQUIRE(pool.lifetime(h).s() == Approx(9.9));
+        REQUIRE(pool.handle_at(pool.row(h)) == h);
+        ++live;
+    }
+    REQUIRE(pool.size() == live);
+    for (std::size_t i = 0; i < pool.rows(); ++i) {
+        REQUIRE(pool.row_alive(i));
+    }
+}
+
+TEST_CASE("Particle churn does not allocate in steady state") {
+    particle_pool<float> pool(4096);
+    const auto initial = pool.allocations();
+    std::uint32_t seed = 1;
+    for (int frame = 0; frame < 200; ++frame) {
+        for (int k = 0; k < 200; ++k) {
+            seed = seed * 1664525u + 1013904223u;
+            // lifetimes of 0.1 s to 0.35 s: about 3000 live particles
+            const time_f life(0.1f + float(seed >> 8) * 0x1p-24f * 0.25f);
+            pool.spawn({}, {1_m_s, 0_m_s, 0_m_s}, mass_f(1.0f), life);
+        }
+        pool.advance(time_f(1.0f / 60));
+        if (frame % 4 == 3) {
+            pool.compact();
+        }
+    }
+    REQUIRE(pool.size() > 1000);
+    REQUIRE(pool.allocations() == initial);
+
+    // growing past the capacity allocates
+    particle_pool<float> small(4);
+    const auto before = small.allocations();
+    for (int k = 0; k < 5; ++k) {
+        small.spawn({}, {}, mass_f(1.0f), time_f(1));
+    }
+    REQUIRE(small.allocations() > before);
+    REQUIRE(small.capacity() >= 5);
+}
+
+TEST_CASE("Particle compaction does not depend on the thread count") {
+    const std::size_t n = 100000;
+    particle_pool<float> one(n, {.threads = 1});
+    particle_pool<float> four(n, {.threads = 4});
+    std::vector<particle_pool<float>::handle> h1, h4;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto x = length_f(static_cast<float>(i));
+        const time_f life(i % 7 == 0 ? -1.0f : 1.0f);
+        h1.push_back(one.spawn({x, 0_m, 0_m}, {}, mass_f(1.0f), life));
+        h4.push_back(four.spawn({x, 0_m, 0_m}, {}, mass_f(1.0f), life));
+    }
+    for (std::size_t i = 0; i < n; i += 3) {
+        one.kill(h1[i]);
+        four.kill(h4[i]);
+    }
+    one.compact();
+    four.compact();
+    REQUIRE(one.size() == four.size());
+    REQUIRE(one.size() == n - n / 3 - n / 7 + n / 21 - 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(one.alive(h1[i]) == four.alive(h4[i]));
+        if (one.alive(h1[i])) {
+            REQUIRE(one.row(h1[i]) == four.row(h4[i]));
+            REQUIRE(four.position(h4[i]).x().m() == static_cast<float>(i));
+        }
+    }
+}
+
+TEST_CASE("Task graph derives dependencies from stage data") {
+    quantity_array<length_d> x(100, length_d(1.0));
+    quantity_array<speed_d> v(100, speed_d(2.0));
+    quantity_array<mass_d> m(100, mass_d(3.0));
+    quantity_array<energy_d> e(100);
+    const time_d dt(0.5);
+
+    task_graph frame({.threads = 3});
+    const auto drift = frame.stage("drift").reads(v).writes(x).run([&] {
+        x += v * dt;
+    });
+    const auto kinetic =
+        frame.stage("kinetic").reads(m, v).writes(e).parallel(
+            [&] { return v.size(); },
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    e[i] = 0.5 * m[i] * v[i] * v[i];
+                }
+            });
+    const auto damp = frame.stage("damp").reads(x).writes(v).run([&] {
+        v *= 0.5;
+    });
+    const auto shift = frame.stage("shift").writes(x).run([&] {
+        x += length_d(10.0);
+    });
+    const auto report = frame.stage("report").after(kinetic).run([] {});
+
+    REQUIRE(frame.size() == 5);
+    CHECK(frame.name(kinetic) == "kinetic");
+    CHECK(frame.dependencies(drift).empty());
+    CHECK(frame.dependencies(kinetic).empty());
+    // damp reads x after drift writes it, and overwrites v that drift and
+    // kinetic read; shift rewrites x after drift and damp use it.
+    CHECK(frame.dependencies(damp) ==
+          std::vector<std::size_t>{drift, kinetic});
+    CHECK(frame.dependencies(shift) == std::vector<std::size_t>{drift, damp});
+    CHECK(frame.dependencies(report) == std::vector<std::size_t>{kinetic});
+
+    for (int run = 0; run < 3; ++run) {
+        frame.run();
+    }
+    // Same as three serial frames.
+    CHECK(x[7].m() == Approx(1.0 + 0.5 * (2.0 + 1.0 + 0.5) + 30.0));
+    CHECK(v[7].m_s() == Approx(0.25));
+    CHECK(e[7].J() == Approx(0.5 * 3.0 * 0.5 * 0.5));
+
+    const task_graph_path path = frame.critical_path();
+    REQUIRE(!path.stages.empty());
+    CHECK(path.stages.back() != report);
+    std::chrono::nanoseconds summed{0};
+    for (std::size_t i = 0; i + 1 < path.stages.size(); ++i) {
+        const auto &deps = frame.dependencies(path.stages[i + 1]);
+        CHECK(std::ranges::find(deps, path.stages[i]) != deps.end());
+    }
+    for (const std::size_t s : path.stages) {
+        summed += frame.timing(s).duration;
+        CHECK(frame.timing(s).start >= std::chrono::nanoseconds{0});
+    }
+    CHECK(path.length == summed);
+    CHECK(path.length <= frame.wall_time());
+}
+
+TEST_CASE("Task graph runs independent stages side by side") {
+    thread_pool pool(2);
+    quantity_array<length_d> a(1), b(1);
+    std::atomic<int> arrived{0};
+    // Each stage waits for the other to start, which only finishes if both
+    // run at once.
+    const auto meet = [&arrived] {
+        arrived.fetch_add(1);
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (arrived.load() < 2 &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    };
+    task_graph frame({}, pool);
+    (void)frame.stage("a").writes(a).run(meet);
+    (void)frame.stage("b").writes(b).run(meet);
+    frame.run();
+    CHECK(arrived.load() == 2);
+    CHECK(frame.wall_time() < std::chrono::seconds(10));
+
+    // Chunks of a parallel stage cover the rows exactly once, including
+    // chunks that wait on nested pool work.
+    std::vector<int> hits(1000);
+    std::size_t rows = 1000;
+    task_graph chunks({.threads = 7}, pool);
+    (void)chunks.stage("cover").parallel(
+        [&rows] { return rows; },
+        [&](std::size_t begin, std::size_t end) {
+            pool.run(end - begin,
+                     [&, begin](std::size_t i) { ++hits[begin + i]; });
+        });
+    chunks.run();
+    rows = 10;
+    chunks.run();
+    for (std::size_t i = 0; i < hits.size(); ++i) {
+        REQUIRE(hits[i] == (i < 10 ? 2 : 1));
+    }
+}
+
+TEST_CASE("Task graph rethrows stage errors") {
+    quantity_array<length_d> x(4);
+    bool fail = true;
+    int downstream = 0;
+    task_graph frame;
+    (void)frame.stage("solve").writes(x).run([&] {
+        if (fail) {
+            throw std::runtime_error("diverged");
+        }
+    });
+    (void)frame.stage("output").reads(x).run([&] { ++downstream; });
+    CHECK_THROWS_AS(frame.run(), std::runtime_error);
+    CHECK(downstream == 0);
+    fail = false;
+    frame.run();
+    CHECK(downstream == 1);
+
+    int chunks = 0;
+    parallel_for(
+        100, [&chunks](std::size_t, std::size_t) { ++chunks; }, 1);
+    CHECK(chunks == 1);
+    CHECK_THROWS_AS(parallel_for(
+                        100,
+                        [](std::size_t begin, std::size_t) {
+                            if (begin > 0) {
+                                throw std::out_of_range("chunk");
+                            }
+                        },
+                        4),
+                    std::out_of_range);
+}
+
+TEST_CASE("Fixed-step driver carries the remainder between frames") {
+    fixed_step_driver<double> clock({.dt = time_d(0.01), .substeps = 4});
+    std::vector<double> calls;
+    const auto step = [&calls](time_d h) { calls.push_back(h.s()); };
+
+    CHECK(clock.advance(time_d(0.025), step) == 2);
+    CHECK(calls.size() == 8);
+    CHECK(calls.front() == Approx(0.0025));
+    CHECK(clock.alpha() == Approx(0.5));
+    CHECK(clock.advance(time_d(0.003), step) == 0);
+    CHECK(clock.advance(std::chrono::milliseconds(7), step) == 1);
+    CHECK(clock.steps() == 3);
+    CHECK(clock.simulated_time().s() == Approx(0.03));
+    CHECK(clock.accumulated().s() == Approx(0.005));
+
+    // Stiff parts every substep, the rest once per step.
+    int stiff = 0;
+    int once = 0;
+    CHECK(clock.advance(time_d(0.016),
+                        [&](time_d, std::size_t substep) {
+                            ++stiff;
+                            once += substep == 0;
+                        }) == 2);
+    CHECK(stiff == 8);
+    CHECK(once == 2);
+
+    // Frames of exactly dt run one step each, despite rounding.
+    fixed_step_driver<float> vsync({.dt = time_f(1.0f / 60)});
+    for (int frame = 0; frame < 600; ++frame) {
+        REQUIRE(vsync.advance(time_f(1.0f / 60), [](time_f) {}) == 1);
+    }
+}
+
+TEST_CASE("Fixed-step driver caps catch-up steps") {
+    fixed_step_driver<float> clock({.dt = time_f(0.01f), .max_steps = 3});
+    int steps = 0;
+    CHECK(clock.advance(time_f(1.0f), [&steps](time_f) { ++steps; }) == 3);
+    CHECK(steps == 3);
+    CHECK(clock.dropped_time().s() == Approx(0.97).epsilon(1e-4));
+    CHECK(clock.alpha() < 1.0f);
+    CHECK(clock.advance(time_f(0.0f), [&steps](time_f) { ++steps; }) <= 1);
+}
+
+TEST_CASE("Fixed-step driver interpolates tracked positions") {
+    // Bodies moving at constant speed: the interpolated position is the
+    // exact position at the rendered time.
+    const speed_d v(2.0);
+    vec3_array<length_d> x(100);
+    fixed_step_driver<double> clock({.dt = time_d(0.02)});
+    clock.track(x);
+    const auto move = [&](time_d h) {
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            const length_d dx = v * h * static_cast<double>(i);
+            x.set(i, x[i] + vec3<length_d>{dx, length_d(0), length_d(0)});
+        }
+    };
+
+    vec3_array<length_d> out;
+    double now = 0.0;
+    for (const double frame : {0.016, 0.031, 0.005, 0.0166, 0.07}) {
+        clock.advance(time_d(frame), move);
+        now += frame;
+        clock.interpolate(out);
+        REQUIRE(out.size() == x.size());
+        // Rendering trails real time by one step.
+        const double shown = now - clock.dt().s();
+        for (std::size_t i : {std::size_t{1}, std::size_t{57}}) {
+            CHECK(out[i].x().m() ==
+                  Approx(std::max(shown, 0.0) * 2.0 * double(i)));
+            CHECK(clock.interpolated(i).x().m() == Approx(out[i].x().m()));
+        }
+    }
+
+    // Rows added since the snapshot are shown as they are.
+    x.push_back({1_m, 2_m, 3_m});
+    clock.interpolate(out);
+    CHECK(out[100].z().m() == Approx(3.0));
+}
@@ -0,0 +1,130 @@
+// File: tests/test_strict_precision.cpp
+// Catch2 tests for PHYSI_STRICT_PRECISION, which this executable is built
+// with: mixed-precision arithmetic and narrowing conversions must not
+// compile, and the engines must still run in float.
+
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <type_traits>
+
+#include "../include/physi/physi.hpp"
+
+using namespace physi;
+using namespace physi::literals::f32;
+using namespace Catch;
+
+namespace {
+
+template <typename A, typename B>
+concept addable = requires(A a, B b) { a + b; };
+template <typename A, typename B>
+concept subtractable = requires(A a, B b) { a - b; };
+template <typename A, typename B>
+concept multipliable = requires(A a, B b) { a * b; };
+template <typename A, typename B>
+concept divisible = requires(A a, B b) { a / b; };
+template <typename A, typename B>
+concept ordered = requires(A a, B b) { a < b; };
+template <typename A, typename B>
+concept add_assignable = requires(A a, B b) { a += b; };
+template <typename A, typename B>
+concept scalable = requires(A a, B b) { a *= b; };
+
+} // namespace
+
+static_assert(strict_precision);
+
+// Cross-precision arithmetic
+static_assert(!addable<length_f, length_d>);
+static_assert(!subtractable<length_d, length_f>);
+static_assert(!ordered<length_f, length_d>);
+static_assert(!std::equality_comparable_with<length_f, length_d>);
+static_assert(!multipliable<force_f, length_d>);
+static_assert(!divisible<length_f, length_ld>);
+static_assert(addable<length_f, length_f>);
+static_assert(std::is_same_v<product_t<force_f, length_f>, energy_f>);
+
+// Scalars may not widen a float quantity; integers and floats may
+static_assert(!multipliable<length_f, double>);
+static_assert(!multipliable<double, length_f>);
+static_assert(!divisible<length_f, long double>);
+static_assert(!divisible<double, time_f>);
+static_assert(multipliable<length_f, float> && multipliable<int, length_f>);
+static_assert(divisible<length_f, int> && divisible<float, time_f>);
+static_assert(std::is_same_v<decltype(length_d() * 0.5f), length_d>);
+
+// Conversions: widening stays implicit, narrowing needs precision_cast
+static_assert(std::is_convertible_v<length_f, length_d>);
+static_assert(std::is_convertible_v<length_h, length_f>);
+static_assert(!std::is_convertible_v<length_d, length_f>);
+static_assert(!std::is_constructible_v<length_f, length_d>);
+static_assert(!std::is_constructible_v<length_h, length_bf16>);
+static_assert(!std::is_constructible_v<energy_f, torque_d>);
+static_assert(add_assignable<length_d, length_f>);
+static_assert(!add_assignable<length_f, length_d>);
+static_assert(!scalable<length_f, double> && scalable<length_f, int>);
+static_assert(!scalable<quantity_array<length_f>, double>);
+static_assert(!scalable<vec3_array<length_f>, double>);
+static_assert(scalable<quantity_array<length_f>, float> &&
+              scalable<vec3_array<length_f>, int>);
+static_assert(scalable<vec3_array<length_d>, float>);
+
+// The default literals are long double; the f32 family is what float code
+// uses.
+static_assert(!std::is_convertible_v<
+              decltype(physi::literals::operator""_m(1.0L)), length_f>);
+static_assert(std::is_same_v<decltype(1.5_m), length_f>);
+
+TEST_CASE("precision_cast converts between scalars explicitly") {
+    const length_ld x(0.1L);
+    const length_f f = precision_cast<float>(x);
+    REQUIRE(f.base_value() == 0.1f);
+    const length_d d = precision_cast<double>(f);
+    REQUIRE(d.base_value() == double(0.1f));
+    REQUIRE(precision_cast<half>(length_f(2.5f)).base_value() == 2.5f);
+
+    const vec3<length_d> v{1_m, 2_m, 3_m};
+    const vec3<length_f> w = precision_cast<float>(v);
+    REQUIRE(w.z().m() == 3.0f);
+    REQUIRE(w.length().m() == Approx(v.length().m()));
+
+    constexpr time_f t = precision_cast<float>(time_ld(2.0L));
+    static_assert(t.base_value() == 2.0f);
+}
+
+TEST_CASE("Float engines compile and run under strict precision") {
+    nbody_system<float> sys({.softening = 1_m});
+    sys.add({0_m, 0_m, 0_m}, {}, mass_f(1e6f));
+    sys.add({10_m, 0_m, 0_m}, {0_m_s, 1_m_s, 0_m_s}, mass_f(1e6f));
+    sys.step(10_ms);
+    REQUIRE(sys.kinetic_energy().base_value() > 0.0f);
+    REQUIRE(std::is_same_v<decltype(sys.total_momentum()),
+                           vec3<momentum_f>>);
+
+    barnes_hut<float> tree({.theta = 0.5f, .softening = 1_m});
+    tree.build(sys.positions(), sys.masses());
+    vec3_array<acceleration_f> a;
+    REQUIRE(tree.accelerations(a) > 0);
+
+    particle_pool<float> pool(16);
+    const auto p = pool.spawn({1_m, 0_m, 0_m}, {1_m_s, 0_m_s, 0_m_s},
+                              mass_f(1.0f), time_f(1.0f));
+    pool.advance(100_ms, {0_m_s2, 0_m_s2, acceleration_f(-9.8f)});
+    REQUIRE(pool.alive(p));
+
+    rigid_body_system<float> world;
+    const mass_f m(2.0f);
+    const length_f r(0.5f);
+    world.add({0_m, 0_m, 10_m}, m, sphere_inertia(m, r), r);
+    world.step(10_ms);
+    REQUIRE(world.positions().z()[0].m() < 10.0f);
+
+    fixed_step_driver<float> clock({.dt = time_f(0.01f)});
+    std::size_t calls = 0;
+    clock.advance(25_ms, [&](time_f) { ++calls; });
+    REQUIRE(calls == 2);
+
+    const quantity_array<length_f> xs{1_m, 2_m, 3_m};
+    REQUIRE(sum(xs).m() == 6.0f);
+    REQUIRE(mean(xs, reduction::reproducible).m() == 2.0f);
+}
@@ -3,7 +3,13 @@
 // This file is additive — it does not modify any existing files.
 
 #include <catch2/catch_all.hpp>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <ratio>
+#include <span>
 #include <type_traits>
+#include <vector>
 
 #include "../include/physi/physi.hpp"
 
@@ -11,6 +17,9 @@ using namespace physi;
 using namespace physi::literals;
 using namespace Catch;
 
+template <typename A, typename B>
+concept addable = requires(const A &a, const B &b) { a + b; };
+
 TEST_CASE("API: literals, conversions, mixed-precision arithmetic and "
           "mass/volume examples") {
     // create quantities using literals
@@ -211,6 +220,330 @@ TEST_CASE("Speed and acceleration combined") {
     }
 }
 
+TEST_CASE("Dimension algebra deduces product and quotient types") {
+
+    SECTION("Chained products map back to named quantities") {
+        auto work = 2_kg * 3_m_s2 * 4_m;
+        STATIC_REQUIRE(std::is_same_v<decltype(work), energy_ld>);
+        REQUIRE(work.J() == Approx(24.0));
+
+        // both operand orders are available
+        energy_d e1 = length_d(2.0) * force_d(5.0);
+        energy_d e2 = force_d(5.0) * length_d(2.0);
+        REQUIRE(e1 == e2);
+
+        STATIC_REQUIRE(std::is_same_v<product_t<length_f, length_d>, area_d>);
+        STATIC_REQUIRE(
+            std::is_same_v<quotient_t<energy_f, time_f>, power_f>);
+        STATIC_REQUIRE(std::is_same_v<quotient_t<voltage_d, electric_current_d>,
+                                      resistance_d>);
+        STATIC_REQUIRE(std::is_same_v<dimension_of_t<pressure_f>,
+                                      dimension<-1, 1, -2, 0, 0, 0, 0>>);
+    }
+
+    SECTION("Dimensionless results decay to the scalar") {
+        auto ratio = (10_m_s * 2_s) / 4_m;
+        STATIC_REQUIRE(std::is_same_v<decltype(ratio), long double>);
+        REQUIRE(ratio == Approx(5.0));
+    }
+
+    SECTION("Unnamed intermediate dimensions") {
+        const volume_d v = 6_m3;
+        const auto flow = v / time_d(2.0);
+        STATIC_REQUIRE(is_quantity_v<decltype(flow)>);
+        STATIC_REQUIRE(std::is_same_v<dimension_of_t<decltype(flow)>,
+                                      dimension<3, 0, -1, 0, 0, 0, 0>>);
+        REQUIRE(flow.base_value() == Approx(3.0));
+
+        // ... and convert implicitly once the dimension has a name again
+        volume_d moved = flow * time_d(4.0);
+        REQUIRE(moved.m3() == Approx(12.0));
+
+        const auto frequency = 1.0 / 0.5_s;
+        speed_d s = 3_m * frequency;
+        REQUIRE(s.m_s() == Approx(6.0));
+    }
+
+    SECTION("Rotational quantities; torque is not energy") {
+        const moment_of_inertia_d inertia(2.0);
+        const angular_momentum_d l = inertia * 30_rpm;
+        REQUIRE(l.kg_m2_s() == Approx(2.0 * std::numbers::pi));
+        const torque_d t = 4_N_m;
+        const angular_acceleration_d alpha(t / inertia);
+        REQUIRE(alpha.rad_s2() == Approx(2.0));
+        STATIC_REQUIRE(std::is_same_v<decltype(t * 3_s), angular_momentum_ld>);
+        STATIC_REQUIRE(std::is_same_v<decltype(t * 1_rad_s), power_ld>);
+
+        // a frequency is not an angular velocity: 1 / min is not 1 rpm
+        STATIC_REQUIRE(!std::is_same_v<decltype(1.0 / 1_min),
+                                       angular_velocity_ld>);
+        STATIC_REQUIRE(!std::is_same_v<decltype(t / inertia),
+                                       angular_acceleration_d>);
+        STATIC_REQUIRE(
+            !std::is_convertible_v<angular_velocity_d, angular_acceleration_d>);
+        REQUIRE(angular_velocity_d(1_rpm).rad_s() ==
+                Approx(2.0 * std::numbers::pi / 60.0));
+        // ... nor does an unnamed 1 / time or torque / inertia become one
+        STATIC_REQUIRE(!std::is_convertible_v<decltype(1.0 / 1_s),
+                                              angular_velocity_ld>);
+        STATIC_REQUIRE(!std::is_convertible_v<decltype(t / inertia),
+                                              angular_acceleration_d>);
+        STATIC_REQUIRE(std::is_constructible_v<angular_velocity_ld,
+                                               decltype(1.0 / 1_s)>);
+
+        // same dimension, different quantity: only explicit conversions
+        STATIC_REQUIRE(std::is_same_v<decltype(2_N * 3_m), energy_ld>);
+        STATIC_REQUIRE(!std::is_convertible_v<energy_d, torque_d>);
+        STATIC_REQUIRE(!std::is_convertible_v<torque_d, energy_d>);
+        STATIC_REQUIRE(!addable<torque_d, energy_d>);
+        const vec3<length_d> r{1_m, 0_m, 0_m};
+        const vec3<force_d> f{0_N, 5_N, 0_N};
+        STATIC_REQUIRE(
+            !std::is_convertible_v<decltype(r.cross(f)), vec3<torque_d>>);
+        const vec3<torque_d> moment(r.cross(f));
+        REQUIRE(moment.z().N_m() == Approx(5.0));
+        REQUIRE(torque_d(energy_d(1.5)).N_m() == 1.5);
+    }
+}
+
+TEST_CASE("Precision-typed literal families") {
+    // This file uses the default family throughout, so each section pulls
+    // individual f32 / f64 suffixes in with block-scope using-declarations,
+    // which hide the long double ones.
+    SECTION("f32 literals keep float expressions in float") {
+        using physi::literals::f32::operator""_ft;
+        using physi::literals::f32::operator""_km;
+        using physi::literals::f32::operator""_m;
+        using physi::literals::f32::operator""_s;
+        STATIC_REQUIRE(std::is_same_v<decltype(1.5_m), length_f>);
+        STATIC_REQUIRE(std::is_same_v<decltype(3_km), length_f>);
+
+        const speed_f v(10.0f);
+        const auto x = v * 0.016_s;
+        STATIC_REQUIRE(std::is_same_v<decltype(x), const length_f>);
+        REQUIRE(x.m() == Approx(0.16f));
+        REQUIRE((2_ft).m() == Approx(0.6096f));
+    }
+
+    SECTION("f64 literals") {
+        using physi::literals::f64::operator""_kg;
+        using physi::literals::f64::operator""_m_s2;
+        STATIC_REQUIRE(std::is_same_v<decltype(2.0_kg * 3_m_s2), force_d>);
+        REQUIRE((2.0_kg * 3_m_s2).N() == Approx(6.0));
+    }
+
+    SECTION("The default family stays long double") {
+        STATIC_REQUIRE(std::is_same_v<decltype(1.5_m), length_ld>);
+        STATIC_REQUIRE(std::is_same_v<length_ld::rebind<float>, length_f>);
+    }
+}
+
+TEST_CASE("Scaled integer quantities") {
+    using length_mm = scaled_quantity<length, std::milli, std::int32_t>;
+    using length_um = scaled_quantity<length, std::micro, std::int64_t>;
+    STATIC_REQUIRE(sizeof(length_mm) == sizeof(std::int32_t));
+
+    SECTION("Round trips through the floating types") {
+        const length_mm p(1.2345_m);
+        REQUIRE(p.ticks() == 1235);
+        const length_d d = p;
+        REQUIRE(d.mm() == Approx(1235.0));
+        REQUIRE(length_mm(d) == p);
+        REQUIRE(length_mm(-0.0026_m).ticks() == -3);
+
+        const length_um fine = p; // exact: 1 mm is 1000 um
+        REQUIRE(fine.ticks() == 1235000);
+        REQUIRE(length_mm(length_um::from_ticks(1499)).ticks() == 1);
+    }
+
+    SECTION("Floating conversion is implicit only when it is exact") {
+        // float's 24-bit significand cannot hold every int32 tick count.
+        STATIC_REQUIRE(std::is_convertible_v<length_mm, length_d>);
+        STATIC_REQUIRE_FALSE(std::is_convertible_v<length_mm, length_f>);
+        STATIC_REQUIRE_FALSE(std::is_convertible_v<length_um, length_d>);
+        const auto big = length_mm::from_ticks(16'777'217);
+        REQUIRE(length_mm(length_d(big)) == big);
+        REQUIRE(big.as<float>().mm() == 16'777'216.0f);
+    }
+
+    SECTION("Rounds to the nearest tick without a half-up bias") {
+        // 0.49999997f + 0.5f rounds to 1.0f, so truncating it misrounds.
+        REQUIRE(length_mm(length_f(0.49999997e-3f)).ticks() == 0);
+        REQUIRE(length_mm(length_f(-0.49999997e-3f)).ticks() == 0);
+        REQUIRE(length_mm(length_d(2.5e-3)).ticks() == 3);
+        REQUIRE(length_mm(length_d(-2.5e-3)).ticks() == -3);
+        REQUIRE(length_mm(length_d(2'147'483.647)).ticks() ==
+                2'147'483'647);
+    }
+
+    SECTION("Rescaling that can overflow is explicit") {
+        // 3 km in mm fits an int32, but 3e9 um does not: the implicit
+        // conversion would wrap around.
+        using length_um32 = scaled_quantity<length, std::micro, std::int32_t>;
+        STATIC_REQUIRE_FALSE(std::is_convertible_v<length_mm, length_um32>);
+        STATIC_REQUIRE(std::is_convertible_v<length_mm, length_um>);
+        STATIC_REQUIRE_FALSE(std::is_convertible_v<length_um, length_mm>);
+
+        const auto far = length_mm::from_ticks(3'000'000);
+        const length_um fine = far;
+        REQUIRE(fine.ticks() == 3'000'000'000);
+        REQUIRE(fine.as().m() == Approx(3000.0));
+        REQUIRE(length_um32(length_mm::from_ticks(2'000)).ticks() ==
+                2'000'000);
+    }
+
+    SECTION("Integer arithmetic and ordering") {
+        auto a = length_mm::from_ticks(40);
+        const auto b = length_mm::from_ticks(2);
+        a += b * 3;
+        REQUIRE(a.ticks() == 46);
+        REQUIRE((a - b).ticks() == 44);
+        REQUIRE(b < a);
+        REQUIRE(a / b == Approx(23.0));
+    }
+
+    SECTION("Interoperates with the dimensional operators") {
+        const length_mm p(2_m);
+        const auto v = p / time_d(4.0);
+        STATIC_REQUIRE(std::is_same_v<decltype(v), const speed_d>);
+        REQUIRE(v.m_s() == Approx(0.5));
+
+        const energy_d w = force_d(3.0) * p;
+        REQUIRE(w.J() == Approx(6.0));
+
+        const auto total = p + length_f(0.5f);
+        STATIC_REQUIRE(std::is_same_v<decltype(total), const length_f>);
+        REQUIRE(total.m() == Approx(2.5f));
+    }
+}
+
+TEST_CASE("Quantities stored in a declared unit") {
+    using kmh = quantity_in<speed_d, speed_d::km_h_unit>;
+    using mph = quantity_in<speed_d, speed_d::mph_unit>;
+    STATIC_REQUIRE(sizeof(kmh) == sizeof(double));
+
+    SECTION("Same-unit arithmetic keeps the unit") {
+        const kmh v(100.0);
+        const kmh w = v + v * 0.5;
+        REQUIRE(w.value() == 150.0);
+        REQUIRE(w / v == Approx(1.5));
+        REQUIRE(v < w);
+    }
+
+    SECTION("Conversions happen only at unit boundaries") {
+        const kmh v(100.0);
+        const speed_d base = v;
+        REQUIRE(base.km_h() == Approx(100.0));
+        REQUIRE(kmh(base).value() == Approx(100.0));
+
+        const mph m = v.in<speed_d::mph_unit>();
+        REQUIRE(m.value() == Approx(62.137).epsilon(1e-4));
+        REQUIRE((v + m).value() == Approx(200.0)); // into the left unit
+
+        const length_d d = v * time_d(1800.0);
+        REQUIRE(d.km() == Approx(50.0).epsilon(1e-5));
+    }
+
+    SECTION("Base conversions fold into one multiply in the value type") {
+        using kmh_f = quantity_in<speed_f, speed_f::km_h_unit>;
+        constexpr long double scale = speed_f::km_h_unit::info.scale;
+        constexpr kmh_f v(speed_f(10.0f));
+        STATIC_REQUIRE(v.value() == 10.0f * float(1.0L / scale));
+        STATIC_REQUIRE(v.base().base_value() == v.value() * float(scale));
+        const temperature_f t =
+            quantity_in<temperature_f, temperature_f::C_unit>(25.0f);
+        REQUIRE(t.K() == Approx(298.15f));
+    }
+
+    SECTION("Affine units and bulk re-expression") {
+        using celsius = quantity_in<temperature_d, temperature_d::C_unit>;
+        using fahrenheit = quantity_in<temperature_d, temperature_d::F_unit>;
+        const celsius boiling(100.0);
+        REQUIRE(boiling.in<temperature_d::F_unit>().value() ==
+                Approx(212.0).epsilon(1e-5));
+        REQUIRE(temperature_d(boiling).K() == Approx(373.15));
+
+        const std::vector<celsius> c = {celsius(0.0), celsius(37.0)};
+        std::vector<fahrenheit> f(2);
+        convert<temperature_d>(std::span<const celsius>(c),
+                               std::span<fahrenheit>(f));
+        // the F unit is registered with a 6-digit scale (0.555556)
+        REQUIRE(f[0].value() == Approx(32.0).margin(1e-3));
+        REQUIRE(f[1].value() == Approx(98.6).margin(1e-3));
+    }
+}
+
+TEST_CASE("16-bit storage scalars") {
+    STATIC_REQUIRE(sizeof(pressure_h) == 2);
+    STATIC_REQUIRE(sizeof(density_bf16) == 2);
+
+    SECTION("Values round to the nearest representable") {
+        REQUIRE(float(half(1.0f)) == 1.0f);
+        REQUIRE(float(half(65504.0f)) == 65504.0f);
+        REQUIRE(std::isinf(float(half(70000.0f))));
+        REQUIRE(float(half(0.1f)) == Approx(0.1f).epsilon(1e-3));
+        REQUIRE(float(half(6e-8f)) > 0.0f); // subnormal
+        REQUIRE(float(bfloat16(3.0e38f)) == Approx(3.0e38f).epsilon(1e-2));
+    }
+
+    SECTION("numeric_limits describe both formats") {
+        using hl = std::numeric_limits<half>;
+        using bl = std::numeric_limits<bfloat16>;
+        STATIC_REQUIRE(hl::has_infinity && hl::has_quiet_NaN);
+        STATIC_REQUIRE(bl::has_denorm == std::denorm_present);
+        STATIC_REQUIRE(hl::max_exponent == 16 && bl::max_exponent == 128);
+        REQUIRE(std::isinf(float(hl::infinity())));
+        REQUIRE(std::isnan(float(hl::quiet_NaN())));
+        REQUIRE(std::isnan(float(bl::signaling_NaN())));
+        REQUIRE(float(hl::max()) == 65504.0f);
+        REQUIRE(float(hl::epsilon()) == 1.0f / 1024.0f);
+        REQUIRE(float(bl::epsilon()) == 1.0f / 128.0f);
+        REQUIRE(float(hl::round_error()) == 0.5f);
+        REQUIRE(float(hl::denorm_min()) == std::ldexp(1.0f, -24));
+        REQUIRE(float(bl::denorm_min()) == std::ldexp(1.0f, -133));
+        REQUIRE(float(bl::infinity()) ==
+                std::numeric_limits<float>::infinity());
+        REQUIRE(float(bl::min()) == std::numeric_limits<float>::min());
+    }
+
+    SECTION("Arithmetic promotes to float") {
+        const temperature_h t(293.15f);
+        const auto dt = t - temperature_h(273.15f);
+        STATIC_REQUIRE(std::is_same_v<decltype(dt), const temperature_f>);
+        REQUIRE(dt.K() == Approx(20.0f).margin(0.1f));
+
+        const auto v = length_h(3.0f) / time_h(2.0f);
+        STATIC_REQUIRE(std::is_same_v<decltype(v), const speed_f>);
+        REQUIRE(v.m_s() == 1.5f);
+
+        pressure_h p(1000.0f);
+        p += pressure_f(24.0f);
+        REQUIRE(p.base_value() == half(1024.0f));
+    }
+
+    SECTION("Arrays and bulk conversion") {
+        quantity_array<pressure_h> p(100);
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            p[i] = pressure_h(static_cast<float>(i));
+        }
+        // summed in float, stored back as half
+        REQUIRE(float(sum(p).base_value()) == 4952.0f);
+
+        std::vector<float> in(37), back(37);
+        std::vector<half> h(37);
+        std::vector<bfloat16> b(37);
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            in[i] = 0.25f * static_cast<float>(i) - 3.0f;
+        }
+        from_float(in, h);
+        to_float(h, back);
+        REQUIRE(back == in); // quarter steps are exact in half
+        from_float(in, b);
+        to_float(b, back);
+        REQUIRE(back == in);
+    }
+}
+
 using namespace physi;
 using namespace physi::literals;
 
@@ -795,4 +1128,126 @@ TEST_CASE("Vector mathematical properties") {
 
         REQUIRE(left.base_value() == Approx(right.base_value()));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Matrix construction and element access") {
+    // row-major initializer, (row, column) access
+    mat<length_d, 2, 3> a = {1_m, 2_m, 3_m, 4_m, 5_m, 6_m};
+    REQUIRE(a(0, 2).base_value() == Approx(3.0));
+    REQUIRE(a(1, 0).base_value() == Approx(4.0));
+    REQUIRE(a.row(1).z().base_value() == Approx(6.0));
+    REQUIRE(a.column(1).y().base_value() == Approx(5.0));
+
+    a.set(1, 1, 7_m);
+    REQUIRE(a(1, 1).base_value() == Approx(7.0));
+    REQUIRE(a.transposed()(1, 1).base_value() == Approx(7.0));
+    REQUIRE(a.transposed()(2, 0).base_value() == Approx(3.0));
+
+    REQUIRE(mat3<double>::identity() == mat3<double>(glm::dmat3(1.0)));
+    REQUIRE(mat3<length_d>() == mat3<length_d>::diagonal(length_d(0)));
+
+    // addition, negation and scalar factors keep the matrix quantity
+    mat2<length_d> b = {1_m, 2_m, 3_m, 4_m};
+    mat2<length_d> c = (b + b - b) * 2.0;
+    REQUIRE(c(1, 0).base_value() == Approx(6.0));
+    REQUIRE((-c)(0, 1).base_value() == Approx(-4.0));
+    STATIC_REQUIRE(!addable<mat2<length_d>, mat2<time_d>>);
+}
+
+TEST_CASE("Matrix dimensional products") {
+    SECTION("Inertia tensor times angular velocity is angular momentum") {
+        const mat3<moment_of_inertia_d> I =
+            mat3<moment_of_inertia_d>::diagonal(vec3<moment_of_inertia_d>{
+                moment_of_inertia_d(1), moment_of_inertia_d(2),
+                moment_of_inertia_d(4)});
+        const vec3<angular_velocity_d> w = {angular_velocity_d(3),
+                                            angular_velocity_d(2),
+                                            angular_velocity_d(1)};
+        const vec3<angular_momentum_d> L = I * w;
+        REQUIRE(L.x().kg_m2_s() == Approx(3.0));
+        REQUIRE(L.y().kg_m2_s() == Approx(4.0));
+        REQUIRE(L.z().kg_m2_s() == Approx(4.0));
+
+        // the inverse tensor maps angular momentum back
+        const vec3<angular_velocity_d> back(I.inverse() * L);
+        REQUIRE(back.x().rad_s() == Approx(3.0));
+        REQUIRE(back.z().rad_s() == Approx(1.0));
+    }
+
+    SECTION("Products and determinants multiply quantities") {
+        const mat2<length_d> a = {1_m, 2_m, 3_m, 4_m};
+        const mat2<force_d> f = mat2<force_d>::diagonal(force_d(2));
+        const mat2<energy_d> e = a * f;
+        REQUIRE(e(1, 1).base_value() == Approx(8.0));
+        const area_d det = a.determinant();
+        REQUIRE(det.base_value() == Approx(-2.0));
+
+        const mat2<area_d> scaled = a * length_d(2);
+        REQUIRE(scaled(0, 1).base_value() == Approx(4.0));
+        const mat2<area_d> scaled2 = length_d(2) * a;
+        REQUIRE(scaled == scaled2);
+    }
+
+    SECTION("A dimensionless matrix keeps the vector quantity") {
+        const mat3<double> s = mat3<double>::diagonal(2.0);
+        const vec3<length_d> p = {1_m, 2_m, 3_m};
+        const vec3<length_d> q = s * p;
+        REQUIRE(q.z().base_value() == Approx(6.0));
+        // unitless directions take the matrix quantity
+        const glm::dvec3 d = s * glm::dvec3(1.0, 0.0, 0.0);
+        REQUIRE(d.x == Approx(2.0));
+    }
+}
+
+TEST_CASE("Rotation quaternion") {
+    const double half_pi = std::numbers::pi / 2;
+    const quat<double> q = quat<double>::angle_axis(half_pi, {0, 0, 2});
+
+    SECTION("Rotating keeps the quantity") {
+        const vec3<length_d> p = {1_m, 0_m, 0_m};
+        const vec3<length_d> r = q * p;
+        REQUIRE(r.x().base_value() == Approx(0.0).margin(1e-12));
+        REQUIRE(r.y().base_value() == Approx(1.0));
+        REQUIRE(r.length().base_value() == Approx(1.0));
+
+        const vec3<speed_d> v = q.conjugate() * vec3<speed_d>{0_m_s, 3_m_s,
+                                                               0_m_s};
+        REQUIRE(v.x().base_value() == Approx(3.0));
+    }
+
+    SECTION("Matrix form and composition agree") {
+        const quat<double> q2 = q * q; // half turn
+        REQUIRE(q2.angle() == Approx(std::numbers::pi));
+        REQUIRE(q2.axis().z == Approx(1.0));
+
+        const vec3<length_d> p = {1_m, 2_m, 3_m};
+        const vec3<length_d> a = q2 * p;
+        const vec3<length_d> b = q.to_matrix() * (q.to_matrix() * p);
+        REQUIRE(a.x().base_value() == Approx(b.x().base_value()));
+        REQUIRE(a.y().base_value() == Approx(b.y().base_value()));
+        REQUIRE(a.z().base_value() == Approx(3.0));
+
+        const quat<double> back = quat<double>::from_matrix(q.to_matrix());
+        REQUIRE(back.w() == Approx(q.w()));
+        REQUIRE(back.z() == Approx(q.z()));
+
+        // rotating an inertia tensor into the world frame: R I R^T
+        const mat3<double> r = q.to_matrix();
+        const mat3<moment_of_inertia_d> I =
+            r * mat3<moment_of_inertia_d>::diagonal(vec3<moment_of_inertia_d>{
+                    moment_of_inertia_d(1), moment_of_inertia_d(2),
+                    moment_of_inertia_d(3)}) *
+            r.transposed();
+        REQUIRE(I(0, 0).base_value() == Approx(2.0));
+        REQUIRE(I(1, 1).base_value() == Approx(1.0));
+        REQUIRE(I(0, 1).base_value() == Approx(0.0).margin(1e-12));
+    }
+
+    SECTION("Inverse, normalization and interpolation") {
+        REQUIRE((q * q.inverse()).w() == Approx(1.0));
+        REQUIRE(quat<double>(2, 0, 0, 0).normalized() == quat<double>());
+        REQUIRE(quat<double>(0, 3, 4, 0).norm() == Approx(5.0));
+        const quat<double> mid = slerp(quat<double>(), q, 0.5);
+        REQUIRE(mid.angle() == Approx(half_pi / 2));
+    }
+}